@@ -51,12 +51,21 @@
 /* Define to 1 if you have the 'memalign' function. */
 #cmakedefine HAVE_MEMALIGN 1
 
+/* Define to 1 if you have the 'mmap' function. */
+#cmakedefine HAVE_MMAP 1
+
+/* Define to 1 if you have the 'madvise' function. */
+#cmakedefine HAVE_MADVISE 1
+
 /* Define to 1 if you have the 'gettimeofday' function. */
 #cmakedefine HAVE_GETTIMEOFDAY 1
 
 /* Define to 1 if you have the 'nanosleep' function. */
 #cmakedefine HAVE_NANOSLEEP 1
 
+/* Define to 1 if you have the 'clock_nanosleep' function. */
+#cmakedefine HAVE_CLOCK_NANOSLEEP 1
+
 /* Define to 1 if you have the 'alphasort' function. */
 #cmakedefine HAVE_ALPHASORT 1
 
@@ -75,3 +84,6 @@
 
 /* Define to 1 to enable trace logs - undefine to slightly increase speed */
 #cmakedefine ENABLE_TRACING 1
+
+/* Define to 1 to compile in debug level log messages */
+#cmakedefine ENABLE_DEBUG_LOG 1
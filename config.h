@@ -57,6 +57,9 @@
 /* Define to 1 if you have the 'nanosleep' function. */
 #define HAVE_NANOSLEEP 1
 
+/* Define to 1 if you have the 'clock_nanosleep' function. */
+#define HAVE_CLOCK_NANOSLEEP 1
+
 /* Define to 1 if you have the 'alphasort' function. */
 #define HAVE_ALPHASORT 1
 
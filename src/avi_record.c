@@ -24,6 +24,12 @@
   PNG compression will often give a x20 ratio when compared to BMP and should
   be used if you have a powerful enough cpu.
 
+  The emulation thread only converts each frame to 24 bits and copies it and
+  the audio samples into a queue. A writer thread compresses the frames and
+  writes the chunks to the file, remembering their offsets to build the index
+  when recording stops. The emulation only waits for the writer when the queue
+  is full.
+
   Sound is saved as 16 bits pcm stereo, using the current Hatari sound output
   frequency. For best accuracy, sound frequency should be a multiple of the
   video frequency ; this means 44.1 kHz is the best choice for 50/60 Hz video.
@@ -63,7 +69,6 @@ const char AVIRecord_fileid[] = "Hatari avi_record.c : " __DATE__ " " __TIME__;
 #include "configuration.h"
 #include "log.h"
 #include "screen.h"
-#include "screenSnapShot.h"
 #include "sound.h"
 #include "statusbar.h"
 #include "avi_record.h"
@@ -287,32 +292,68 @@ typedef struct {
   int		TotalVideoFrames;			/* number of recorded video frames */
   int		TotalAudioSamples;			/* number of recorded audio samples */
   long		MoviChunkPosStart;			/* as returned by ftell() */
-  long		MoviChunkPosEnd;			/* as returned by ftell() */
+  long		MoviChunkPosEnd;			/* end of the last written chunk */
+
+  SDL_Thread	*Writer;				/* thread writing the queued chunks */
+  AVI_CHUNK_INDEX	*Index;					/* index entries of the written chunks */
+  int		IndexCount;
+  int		IndexAlloc;
 } RECORD_AVI_PARAMS;
 
 
+/* Chunk waiting to be written by the writer thread */
+#define	AVI_QUEUE_LEN				16
+
+#define	AVI_QUEUE_VIDEO				0
+#define	AVI_QUEUE_AUDIO				1
+
+typedef struct {
+  int		Type;					/* AVI_QUEUE_VIDEO or AVI_QUEUE_AUDIO */
+  Uint8		*Data;					/* 24 bit frame or 16 bit pcm samples */
+  int		Size;
+} AVI_QUEUE_ITEM;
+
+/* Growing memory buffer for png frames */
+typedef struct {
+  Uint8		*Data;
+  int		Size;
+  int		Alloc;
+} AVI_BUFFER;
+
+
 
 bool		bRecordingAvi = false;
 
 static RECORD_AVI_PARAMS	AviParams;
 static AVI_FILE_HEADER		AviFileHeader;
 
+static AVI_QUEUE_ITEM		AviQueue[ AVI_QUEUE_LEN ];
+static int			AviQueueHead;
+static int			AviQueueCount;
+static bool			AviQueueQuit;
+static SDL_mutex		*AviQueueMutex = NULL;
+static SDL_cond			*AviQueueCond = NULL;
+static SDL_atomic_t		AviWriteError;			/* 1 = write failed, 2 = failure reported */
+
 
 static void	Avi_StoreU16 ( Uint8 *p , Uint16 val );
 static void	Avi_StoreU32 ( Uint8 *p , Uint32 val );
 static void	Avi_Store4cc ( Uint8 *p , const char *text );
-static Uint32	Avi_ReadU32 ( Uint8 *p );
 
 static int	Avi_GetBmpSize ( int Width , int Height , int BitCount );
 
-static bool	Avi_RecordVideoStream_BMP ( RECORD_AVI_PARAMS *pAviParams );
+static Uint8	*Avi_GrabFrame ( RECORD_AVI_PARAMS *pAviParams );
+static bool	Avi_QueueChunk ( int Type , Uint8 *pData , int Size );
+static bool	Avi_WriteChunk ( RECORD_AVI_PARAMS *pAviParams , const char *ChunkName , Uint8 *pData , int Size );
 #if HAVE_LIBPNG
-static bool	Avi_RecordVideoStream_PNG ( RECORD_AVI_PARAMS *pAviParams );
+static int	Avi_EncodeFrame_PNG ( RECORD_AVI_PARAMS *pAviParams , Uint8 *pFrame , AVI_BUFFER *pBuf );
 #endif
+static int	Avi_WriterThread ( void *pData );
 static bool	Avi_RecordAudioStream_PCM ( RECORD_AVI_PARAMS *pAviParams , Sint16 pSamples[][2], int SampleIndex, int SampleLength );
 
 static void	Avi_BuildFileHeader ( RECORD_AVI_PARAMS *pAviParams , AVI_FILE_HEADER *pAviFileHeader );
 static bool	Avi_BuildIndex ( RECORD_AVI_PARAMS *pAviParams );
+static void	Avi_FreeIndex ( RECORD_AVI_PARAMS *pAviParams );
 
 static bool	Avi_StartRecording_WithParams ( RECORD_AVI_PARAMS *pAviParams , char *AviFileName );
 static bool	Avi_StopRecording_WithParams ( RECORD_AVI_PARAMS *pAviParams );
@@ -346,12 +387,6 @@ static void	Avi_Store4cc ( Uint8 *p , const char *text )
 }
 
 
-static Uint32	Avi_ReadU32 ( Uint8 *p )
-{
-	return (p[3]<<24) + (p[2]<<16) + (p[1]<<8) +p[0];
-}
-
-
 static int	Avi_GetBmpSize ( int Width , int Height , int BitCount )
 {
 	return ( Width * Height * BitCount / 8 );						/* bytes in one video frame */
@@ -359,141 +394,305 @@ static int	Avi_GetBmpSize ( int Width , int Height , int BitCount )
 
 
 
-static bool	Avi_RecordVideoStream_BMP ( RECORD_AVI_PARAMS *pAviParams )
+/*-----------------------------------------------------------------------*/
+/**
+ * Convert the cropped surface to a 24 bit frame. For BMP the lines are
+ * stored from bottom to top (origin is in bottom left corner) and bytes are
+ * in BGR order, for PNG the lines are stored from top to bottom in RGB order.
+ */
+static Uint8	*Avi_GrabFrame ( RECORD_AVI_PARAMS *pAviParams )
 {
-	AVI_CHUNK	Chunk;
-	int		SizeImage;
-	Uint8		LineBuf[ 3 * pAviParams->Width ];			/* temp buffer to convert to 24-bit BGR format */
+	SDL_Surface	*Surface = pAviParams->Surface;
+	int		LineSize = pAviParams->Width * 3;
+	Uint8		*pFrame;
 	Uint8		*pBitmapIn , *pBitmapOut;
+	int		OutStep;
 	int		y;
 	int		NeedLock;
-	
-	SizeImage = Avi_GetBmpSize ( pAviParams->Width , pAviParams->Height , pAviParams->BitCount );
 
-	/* Write the video frame header */
-	Avi_Store4cc ( Chunk.ChunkName , "00db" );				/* stream 0, uncompressed DIB bytes */
-	Avi_StoreU32 ( Chunk.ChunkSize , SizeImage );					/* max size of RGB image */
-	if ( fwrite ( &Chunk , sizeof ( Chunk ) , 1 , pAviParams->FileOut ) != 1 )
+	pFrame = malloc ( LineSize * pAviParams->Height );
+	if ( !pFrame )
+		return NULL;
+
+	/* Points to the top left pixel after cropping borders */
+	pBitmapIn = (Uint8 *)Surface->pixels + Surface->pitch * pAviParams->CropTop
+			+ pAviParams->CropLeft * Surface->format->BytesPerPixel;
+	if ( pAviParams->VideoCodec == AVI_RECORD_VIDEO_CODEC_BMP )
 	{
-		perror ( "Avi_RecordVideoStream_BMP" );
-		Log_AlertDlg ( LOG_ERROR, "AVI recording : failed to write bmp frame header" );
-		return false;
+		pBitmapOut = pFrame + LineSize * ( pAviParams->Height - 1 );
+		OutStep = -LineSize;
+	}
+	else
+	{
+		pBitmapOut = pFrame;
+		OutStep = LineSize;
 	}
 
-
-	/* Write the video frame data */
-	NeedLock = SDL_MUSTLOCK( pAviParams->Surface );
-
-	/* Points to the top left pixel after cropping borders */
-	/* For BMP format, frame is stored from bottom to top (origin is in bottom left corner) */
-	/* and bytes are in BGR order (not RGB) */
-	pBitmapIn = (Uint8 *)pAviParams->Surface->pixels
-			+ pAviParams->Surface->pitch * ( pAviParams->CropTop + pAviParams->Height )
-			+ pAviParams->CropLeft * pAviParams->Surface->format->BytesPerPixel;
+	NeedLock = SDL_MUSTLOCK( Surface );
+	if ( NeedLock )
+		SDL_LockSurface ( Surface );
 
 	for ( y=0 ; y<pAviParams->Height ; y++ )
 	{
-		if ( NeedLock )
-			SDL_LockSurface ( pAviParams->Surface );
-
-		pBitmapOut = LineBuf;
-		switch ( pAviParams->Surface->format->BytesPerPixel ) {
-			case 1 :	PixelConvert_8to24Bits_BGR(LineBuf, pBitmapIn, pAviParams->Width, pAviParams->Surface->format->palette->colors);
-					break;
-			case 2 :	PixelConvert_16to24Bits_BGR(LineBuf, (Uint16 *)pBitmapIn, pAviParams->Width, pAviParams->Surface->format);
-					break;
-			case 3 :	PixelConvert_24to24Bits_BGR(LineBuf, pBitmapIn, pAviParams->Width);
-					break;
-			case 4 :	PixelConvert_32to24Bits_BGR(LineBuf, (Uint32 *)pBitmapIn, pAviParams->Width, pAviParams->Surface->format);
-					break;
+		if ( pAviParams->VideoCodec == AVI_RECORD_VIDEO_CODEC_BMP )
+		{
+			switch ( Surface->format->BytesPerPixel ) {
+				case 1 :	PixelConvert_8to24Bits_BGR(pBitmapOut, pBitmapIn, pAviParams->Width, Surface->format->palette->colors);
+						break;
+				case 2 :	PixelConvert_16to24Bits_BGR(pBitmapOut, (Uint16 *)pBitmapIn, pAviParams->Width, Surface->format);
+						break;
+				case 3 :	PixelConvert_24to24Bits_BGR(pBitmapOut, pBitmapIn, pAviParams->Width);
+						break;
+				case 4 :	PixelConvert_32to24Bits_BGR(pBitmapOut, (Uint32 *)pBitmapIn, pAviParams->Width, Surface->format);
+						break;
+			}
 		}
+		else
+		{
+			switch ( Surface->format->BytesPerPixel ) {
+				case 1 :	PixelConvert_8to24Bits(pBitmapOut, pBitmapIn, pAviParams->Width, Surface->format->palette->colors);
+						break;
+				case 2 :	PixelConvert_16to24Bits(pBitmapOut, (Uint16 *)pBitmapIn, pAviParams->Width, Surface->format);
+						break;
+				case 3 :	memcpy(pBitmapOut, pBitmapIn, LineSize);
+						break;
+				case 4 :	PixelConvert_32to24Bits(pBitmapOut, (Uint32 *)pBitmapIn, pAviParams->Width, Surface->format);
+						break;
+			}
+		}
+
+		pBitmapIn += Surface->pitch;
+		pBitmapOut += OutStep;
+	}
 
-		if ( NeedLock )
-			SDL_UnlockSurface ( pAviParams->Surface );
+	if ( NeedLock )
+		SDL_UnlockSurface ( Surface );
 
-		if ( (int)fwrite ( pBitmapOut , 1 , pAviParams->Width*3 , pAviParams->FileOut ) != pAviParams->Width*3 )
+	return pFrame;
+}
+
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Add a chunk to the writer thread's queue. Waits if the queue is full.
+ * The queue takes ownership of pData.
+ */
+static bool	Avi_QueueChunk ( int Type , Uint8 *pData , int Size )
+{
+	/* Report a failure of the writer thread only once */
+	if ( SDL_AtomicGet ( &AviWriteError ) )
+	{
+		free ( pData );
+		if ( SDL_AtomicGet ( &AviWriteError ) == 1 )
 		{
-			perror ( "Avi_RecordVideoStream_BMP" );
-			Log_AlertDlg ( LOG_ERROR, "AVI recording : failed to write bmp video frame" );
-			return false;
+			SDL_AtomicSet ( &AviWriteError , 2 );
+			Log_AlertDlg ( LOG_ERROR, "AVI recording : failed to write video and audio data" );
 		}
-
-		pBitmapIn -= pAviParams->Surface->pitch;			/* go from bottom to top */
+		return false;
 	}
 
+	SDL_LockMutex ( AviQueueMutex );
+	while ( AviQueueCount == AVI_QUEUE_LEN )
+		SDL_CondWait ( AviQueueCond , AviQueueMutex );
+
+	AviQueue[ ( AviQueueHead + AviQueueCount ) % AVI_QUEUE_LEN ].Type = Type;
+	AviQueue[ ( AviQueueHead + AviQueueCount ) % AVI_QUEUE_LEN ].Data = pData;
+	AviQueue[ ( AviQueueHead + AviQueueCount ) % AVI_QUEUE_LEN ].Size = Size;
+	AviQueueCount++;
+
+	SDL_CondBroadcast ( AviQueueCond );
+	SDL_UnlockMutex ( AviQueueMutex );
 	return true;
 }
 
 
 
-#if HAVE_LIBPNG
-static bool	Avi_RecordVideoStream_PNG ( RECORD_AVI_PARAMS *pAviParams )
+/*-----------------------------------------------------------------------*/
+/**
+ * Write a data chunk at the end of the 'movi' chunk and add it to the index
+ * (called from the writer thread).
+ */
+static bool	Avi_WriteChunk ( RECORD_AVI_PARAMS *pAviParams , const char *ChunkName , Uint8 *pData , int Size )
 {
 	AVI_CHUNK	Chunk;
-	int		SizeImage;
-	long		ChunkPos;
-	Uint8	TempSize[4];
-	
+	AVI_CHUNK_INDEX	*pIndex;
 
-	/* Write the video frame header */
-	ChunkPos = ftell ( pAviParams->FileOut );
-	Avi_Store4cc ( Chunk.ChunkName , "00dc" );				/* stream 0, compressed DIB bytes */
-	Avi_StoreU32 ( Chunk.ChunkSize , 0 );					/* size of PNG image (-> completed later) */
+	if ( pAviParams->IndexCount == pAviParams->IndexAlloc )
+	{
+		pIndex = realloc ( pAviParams->Index , ( pAviParams->IndexAlloc + 4096 ) * sizeof ( AVI_CHUNK_INDEX ) );
+		if ( !pIndex )
+			return false;
+		pAviParams->Index = pIndex;
+		pAviParams->IndexAlloc += 4096;
+	}
+
+	Avi_Store4cc ( Chunk.ChunkName , ChunkName );
+	Avi_StoreU32 ( Chunk.ChunkSize , Size );
 	if ( fwrite ( &Chunk , sizeof ( Chunk ) , 1 , pAviParams->FileOut ) != 1 )
-        goto png_error;
-    
-  	/* Write the video frame data */
-  	SizeImage = ScreenSnapShot_SavePNG_ToFile ( pAviParams->Surface , pAviParams->FileOut ,
-                                               pAviParams->VideoCodecCompressionLevel , PNG_FILTER_NONE ,
-                                               pAviParams->CropLeft , pAviParams->CropRight , pAviParams->CropTop , pAviParams->CropBottom );
-  	if ( SizeImage <= 0 )
-        goto png_error;
-	if ( SizeImage & 1 )
-	{
-		SizeImage++;							/* add an extra '\0' byte to get an even size */
-		fputc ( '\0' , pAviParams->FileOut );				/* next chunk must be aligned on 16 bits boundary */
-	}
-
-	/* Update the size of the video chunk */
-	Avi_StoreU32 ( TempSize , SizeImage );
-	if ( fseek ( pAviParams->FileOut , ChunkPos+4 , SEEK_SET ) != 0 )
-        goto png_error;
-  	if ( fwrite ( TempSize , sizeof ( TempSize ) , 1 , pAviParams->FileOut ) != 1 )
-        goto png_error;
-    
-  	/* Go to the end of the video frame data */
-  	if ( fseek ( pAviParams->FileOut , 0 , SEEK_END ) != 0 )
-        goto png_error;
+		return false;
+	if ( fwrite ( pData , Size , 1 , pAviParams->FileOut ) != 1 )
+		return false;
+	if ( Size & 1 )								/* next chunk must be aligned on 16 bits boundary */
+	{
+		if ( fputc ( '\0' , pAviParams->FileOut ) == EOF )
+			return false;
+	}
+
+	pIndex = &pAviParams->Index[ pAviParams->IndexCount++ ];
+	Avi_Store4cc ( pIndex->identifier , ChunkName );			/* 00dc, 00db, 01wb, ... */
+	Avi_StoreU32 ( pIndex->flags , AVIIF_KEYFRAME );
+	Avi_StoreU32 ( pIndex->offset , pAviParams->MoviChunkPosEnd - pAviParams->MoviChunkPosStart - 8 );	/* pos relative to 'movi' */
+	Avi_StoreU32 ( pIndex->length , Size );
+
+	pAviParams->MoviChunkPosEnd += sizeof ( Chunk ) + Size + ( Size & 1 );
 	return true;
+}
 
-png_error:
-    perror ( "Avi_RecordVideoStream_PNG" );
-    Log_AlertDlg ( LOG_ERROR, "AVI recording : failed to write png frame" );
-    return false;
+
+
+#if HAVE_LIBPNG
+static void	Avi_PngWriteData ( png_structp png_ptr , png_bytep data , png_size_t length )
+{
+	AVI_BUFFER	*pBuf = png_get_io_ptr ( png_ptr );
+	Uint8		*pData;
+
+	if ( pBuf->Size + (int)length > pBuf->Alloc )
+	{
+		pData = realloc ( pBuf->Data , ( pBuf->Size + length ) * 2 );
+		if ( !pData )
+			png_error ( png_ptr , "out of memory" );
+		pBuf->Data = pData;
+		pBuf->Alloc = ( pBuf->Size + length ) * 2;
+	}
+	memcpy ( pBuf->Data + pBuf->Size , data , length );
+	pBuf->Size += length;
+}
+
+static void	Avi_PngFlush ( png_structp png_ptr )
+{
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Compress a 24 bit RGB frame as PNG image into pBuf (called from the
+ * writer thread). Return png image size > 0 for success.
+ */
+static int	Avi_EncodeFrame_PNG ( RECORD_AVI_PARAMS *pAviParams , Uint8 *pFrame , AVI_BUFFER *pBuf )
+{
+	png_structp	png_ptr;
+	png_infop	info_ptr;
+	int		y;
+	int		ret = -1;
+
+	pBuf->Size = 0;
+
+	png_ptr = png_create_write_struct ( PNG_LIBPNG_VER_STRING , NULL , NULL , NULL );
+	if ( !png_ptr )
+		return ret;
+	info_ptr = png_create_info_struct ( png_ptr );
+	if ( !info_ptr )
+		goto png_cleanup;
+	if ( setjmp ( png_jmpbuf ( png_ptr ) ) )
+		goto png_cleanup;
+
+	png_set_write_fn ( png_ptr , pBuf , Avi_PngWriteData , Avi_PngFlush );
+	png_set_IHDR ( png_ptr , info_ptr , pAviParams->Width , pAviParams->Height , 8 , PNG_COLOR_TYPE_RGB ,
+		PNG_INTERLACE_NONE , PNG_COMPRESSION_TYPE_DEFAULT , PNG_FILTER_TYPE_DEFAULT );
+	png_set_compression_level ( png_ptr , pAviParams->VideoCodecCompressionLevel );
+	png_set_filter ( png_ptr , 0 , PNG_FILTER_NONE );
+
+	png_write_info ( png_ptr , info_ptr );
+	for ( y=0 ; y<pAviParams->Height ; y++ )
+		png_write_row ( png_ptr , pFrame + y * pAviParams->Width * 3 );
+	png_write_end ( png_ptr , NULL );
+
+	ret = pBuf->Size;
+png_cleanup:
+	png_destroy_write_struct ( &png_ptr , &info_ptr );
+	return ret;
 }
 #endif  /* HAVE_LIBPNG */
 
 
 
-bool	Avi_RecordVideoStream ( void )
+/*-----------------------------------------------------------------------*/
+/**
+ * Writer thread: compress the queued video frames and write the queued
+ * chunks to the file, until recording stops and the queue is empty.
+ */
+static int	Avi_WriterThread ( void *pData )
 {
-	if ( AviParams.VideoCodec == AVI_RECORD_VIDEO_CODEC_BMP )
+	RECORD_AVI_PARAMS	*pAviParams = pData;
+	AVI_QUEUE_ITEM		Item;
+	bool			ok;
+#if HAVE_LIBPNG
+	AVI_BUFFER		PngBuf = { NULL , 0 , 0 };
+	int			SizeImage;
+#endif
+
+	SDL_LockMutex ( AviQueueMutex );
+	for ( ;; )
 	{
-		if ( Avi_RecordVideoStream_BMP ( &AviParams ) == false )
+		while ( AviQueueCount == 0 && !AviQueueQuit )
+			SDL_CondWait ( AviQueueCond , AviQueueMutex );
+		if ( AviQueueCount == 0 )
+			break;
+
+		Item = AviQueue[ AviQueueHead ];
+		AviQueueHead = ( AviQueueHead + 1 ) % AVI_QUEUE_LEN;
+		AviQueueCount--;
+		SDL_CondBroadcast ( AviQueueCond );
+		SDL_UnlockMutex ( AviQueueMutex );
+
+		if ( SDL_AtomicGet ( &AviWriteError ) == 0 )
 		{
-			return false;
+			if ( Item.Type == AVI_QUEUE_AUDIO )
+				ok = Avi_WriteChunk ( pAviParams , "01wb" , Item.Data , Item.Size );	/* stream 1, wave bytes */
+			else if ( pAviParams->VideoCodec == AVI_RECORD_VIDEO_CODEC_BMP )
+				ok = Avi_WriteChunk ( pAviParams , "00db" , Item.Data , Item.Size );	/* stream 0, uncompressed DIB bytes */
+#if HAVE_LIBPNG
+			else
+			{
+				SizeImage = Avi_EncodeFrame_PNG ( pAviParams , Item.Data , &PngBuf );
+				ok = SizeImage > 0 && Avi_WriteChunk ( pAviParams , "00dc" , PngBuf.Data , SizeImage );	/* stream 0, compressed DIB bytes */
+			}
+#else
+			else
+				ok = false;
+#endif
+			if ( !ok )
+			{
+				perror ( "Avi_WriterThread" );
+				SDL_AtomicSet ( &AviWriteError , 1 );
+			}
 		}
+		free ( Item.Data );
+
+		SDL_LockMutex ( AviQueueMutex );
 	}
+	SDL_UnlockMutex ( AviQueueMutex );
+
 #if HAVE_LIBPNG
-	else if ( AviParams.VideoCodec == AVI_RECORD_VIDEO_CODEC_PNG )
+	free ( PngBuf.Data );
+#endif
+	return 0;
+}
+
+
+
+bool	Avi_RecordVideoStream ( void )
+{
+	Uint8	*pFrame;
+
+	pFrame = Avi_GrabFrame ( &AviParams );
+	if ( !pFrame )
 	{
-		if ( Avi_RecordVideoStream_PNG ( &AviParams ) == false )
-		{
-			return false;
-		}
+		Log_AlertDlg ( LOG_ERROR, "AVI recording : failed to allocate video frame" );
+		return false;
 	}
-#endif
-	else
+	if ( Avi_QueueChunk ( AVI_QUEUE_VIDEO , pFrame , Avi_GetBmpSize ( AviParams.Width , AviParams.Height , AviParams.BitCount ) ) == false )
 	{
 		return false;
 	}
@@ -515,36 +714,24 @@ bool	Avi_RecordVideoStream ( void )
 
 static bool	Avi_RecordAudioStream_PCM ( RECORD_AVI_PARAMS *pAviParams , Sint16 pSamples[][2] , int SampleIndex , int SampleLength )
 {
-	AVI_CHUNK	Chunk;
-	Sint16		sample[2];
+	Sint16		*pData;
 	int		i;
 
-	/* Write the audio frame header */
-	Avi_Store4cc ( Chunk.ChunkName , "01wb" );				/* stream 1, wave bytes */
-	Avi_StoreU32 ( Chunk.ChunkSize , SampleLength * 4 );			/* 16 bits, stereo -> 4 bytes */
-	if ( fwrite ( &Chunk , sizeof ( Chunk ) , 1 , pAviParams->FileOut ) != 1 )
+	pData = malloc ( SampleLength * 4 );					/* 16 bits, stereo -> 4 bytes */
+	if ( !pData )
 	{
-		perror ( "Avi_RecordAudioStream_PCM" );
-		Log_AlertDlg ( LOG_ERROR, "AVI recording : failed to write pcm frame header" );
+		Log_AlertDlg ( LOG_ERROR, "AVI recording : failed to allocate pcm frame" );
 		return false;
 	}
 
-	/* Write the audio frame data */
 	for ( i = 0 ; i < SampleLength; i++ )
 	{
 		/* Convert sample to little endian */
-		sample[0] = SDL_SwapLE16 ( pSamples[ (SampleIndex+i) % MIXBUFFER_SIZE ][0]);
-		sample[1] = SDL_SwapLE16 ( pSamples[ (SampleIndex+i) % MIXBUFFER_SIZE ][1]);
-		/* And store */
-		if ( fwrite ( &sample , sizeof ( sample ) , 1 , pAviParams->FileOut ) != 1 )
-		{
-			perror ( "Avi_RecordAudioStream_PCM" );
-			Log_AlertDlg ( LOG_ERROR, "AVI recording : failed to write pcm frame" );
-			return false;
-		}
+		pData[ i*2 ] = SDL_SwapLE16 ( pSamples[ (SampleIndex+i) % MIXBUFFER_SIZE ][0]);
+		pData[ i*2+1 ] = SDL_SwapLE16 ( pSamples[ (SampleIndex+i) % MIXBUFFER_SIZE ][1]);
 	}
 
-	return true;
+	return Avi_QueueChunk ( AVI_QUEUE_AUDIO , (Uint8 *)pData , SampleLength * 4 );
 }
 
 
@@ -722,56 +909,18 @@ static void	Avi_BuildFileHeader ( RECORD_AVI_PARAMS *pAviParams , AVI_FILE_HEADE
 static bool	Avi_BuildIndex ( RECORD_AVI_PARAMS *pAviParams )
 {
 	AVI_CHUNK	Chunk;
-	long		IndexChunkPosStart;
-	long		Pos , PosWrite;
-	Uint8		TempSize[4];
-	AVI_CHUNK_INDEX	ChunkIndex;
-	Uint32		Size;
 
-	fseek ( pAviParams->FileOut , 0 , SEEK_END );				/* go to the end of the file */
+	/* The index follows the 'movi' chunk */
+	if ( fseek ( pAviParams->FileOut , pAviParams->MoviChunkPosEnd , SEEK_SET ) != 0 )
+        goto index_error;
 
-	/* Write the 'idx1' chunk header */
-	IndexChunkPosStart = ftell ( pAviParams->FileOut );
-	Avi_Store4cc ( Chunk.ChunkName , "idx1" );				/* stream 0, uncompressed DIB bytes */
-	Avi_StoreU32 ( Chunk.ChunkSize , 0 );					/* index size (-> completed later) */
+	/* Write the 'idx1' chunk with the entries collected by the writer thread */
+	Avi_Store4cc ( Chunk.ChunkName , "idx1" );
+	Avi_StoreU32 ( Chunk.ChunkSize , pAviParams->IndexCount * sizeof ( AVI_CHUNK_INDEX ) );
 	if ( fwrite ( &Chunk , sizeof ( Chunk ) , 1 , pAviParams->FileOut ) != 1 )
         goto index_error;
-	PosWrite = ftell ( pAviParams->FileOut );				/* position to start writing indexes */
-
-	/* Go to the first data chunk in the 'movi' chunk */
-	fseek ( pAviParams->FileOut , pAviParams->MoviChunkPosStart + sizeof ( AVI_STREAM_LIST_MOVI ) , SEEK_SET );
-	Pos = ftell ( pAviParams->FileOut );
-
-	/* Build the index : we seek/read one data chunk and seek/write the */
-	/* corresponding infos at the end of the index, until we reach the */
-	/* end of the 'movi' chunk. */
-	while ( Pos < pAviParams->MoviChunkPosEnd )
-	{
-		/* Read the header for this data chunk: ChunkName and ChunkSize */
-		if (fread(&Chunk, sizeof(Chunk), 1, pAviParams->FileOut) != 1)
-            goto index_error;
-		Size = Avi_ReadU32 ( Chunk.ChunkSize );
-
-		/* Write the index infos for this chunk */
-		fseek ( pAviParams->FileOut , PosWrite , SEEK_SET );
-		Avi_Store4cc ( ChunkIndex.identifier , (char *)Chunk.ChunkName );	/* 00dc, 00db, 01wb, ... */
-		Avi_StoreU32 ( ChunkIndex.flags , AVIIF_KEYFRAME );		/* AVIIF_KEYFRAME */
-		Avi_StoreU32 ( ChunkIndex.offset , Pos - pAviParams->MoviChunkPosStart - 8  );	/* pos relative to 'movi' */
-		Avi_StoreU32 ( ChunkIndex.length , Size );
-		if (fwrite ( &ChunkIndex , sizeof ( ChunkIndex ) , 1 , pAviParams->FileOut ) != 1)
-            goto index_error;
-		PosWrite = ftell ( pAviParams->FileOut );			/* position for the next index */
-
-		/* Go to the next data chunk in the 'movi' chunk */
-		Pos = Pos + sizeof ( Chunk ) + Size;				/* position of the next data chunk */
-		fseek ( pAviParams->FileOut , Pos , SEEK_SET );
-	}
-
-	/* Update the size of the 'idx1' chunk */
-	Avi_StoreU32 ( TempSize , PosWrite - IndexChunkPosStart - 8 );
-	if ( fseek ( pAviParams->FileOut , IndexChunkPosStart+4 , SEEK_SET ) != 0 )
-        goto index_error;
-  	if ( fwrite ( TempSize , sizeof ( TempSize ) , 1 , pAviParams->FileOut ) != 1 )
+	if ( pAviParams->IndexCount > 0
+	  && fwrite ( pAviParams->Index , sizeof ( AVI_CHUNK_INDEX ) , pAviParams->IndexCount , pAviParams->FileOut ) != (size_t)pAviParams->IndexCount )
         goto index_error;
 	return true;
 
@@ -783,6 +932,15 @@ index_error:
 }
 
 
+static void	Avi_FreeIndex ( RECORD_AVI_PARAMS *pAviParams )
+{
+	free ( pAviParams->Index );
+	pAviParams->Index = NULL;
+	pAviParams->IndexCount = 0;
+	pAviParams->IndexAlloc = 0;
+}
+
+
 static bool	Avi_StartRecording_WithParams ( RECORD_AVI_PARAMS *pAviParams , char *AviFileName )
 {
 	AVI_STREAM_LIST_INFO	ListInfo;
@@ -864,6 +1022,28 @@ static bool	Avi_StartRecording_WithParams ( RECORD_AVI_PARAMS *pAviParams , char
 	}
 
 
+	/* Start the writer thread */
+	pAviParams->MoviChunkPosEnd = pAviParams->MoviChunkPosStart + sizeof ( ListMovi );
+	pAviParams->Index = NULL;
+	pAviParams->IndexCount = 0;
+	pAviParams->IndexAlloc = 0;
+	SDL_AtomicSet ( &AviWriteError , 0 );
+	AviQueueHead = 0;
+	AviQueueCount = 0;
+	AviQueueQuit = false;
+	if ( !AviQueueMutex )
+		AviQueueMutex = SDL_CreateMutex ();
+	if ( !AviQueueCond )
+		AviQueueCond = SDL_CreateCond ();
+	if ( AviQueueMutex && AviQueueCond )
+		pAviParams->Writer = SDL_CreateThread ( Avi_WriterThread , "AviWriter" , pAviParams );
+	if ( !pAviParams->Writer )
+	{
+		fclose ( pAviParams->FileOut );
+		Log_AlertDlg ( LOG_ERROR, "AVI recording : failed to start writer thread" );
+		return false;
+	}
+
 	/* We're ok to record */
 	Log_AlertDlg ( LOG_INFO, "AVI recording has been started");
 	bRecordingAvi = true;
@@ -882,31 +1062,50 @@ static bool	Avi_StopRecording_WithParams ( RECORD_AVI_PARAMS *pAviParams )
 	if ( bRecordingAvi == false )						/* no recording ? */
 		return true;
 
+	/* Wait until the writer thread has written all queued chunks */
+	SDL_LockMutex ( AviQueueMutex );
+	AviQueueQuit = true;
+	SDL_CondBroadcast ( AviQueueCond );
+	SDL_UnlockMutex ( AviQueueMutex );
+	SDL_WaitThread ( pAviParams->Writer , NULL );
+	pAviParams->Writer = NULL;
+	bRecordingAvi = false;
+
+	if ( SDL_AtomicGet ( &AviWriteError ) )
+	{
+		fclose ( pAviParams->FileOut );
+		Avi_FreeIndex ( pAviParams );
+		Log_AlertDlg ( LOG_ERROR, "AVI recording : failed to write video and audio data" );
+		return false;
+	}
+
 	/* Update the size of the 'movi' chunk */
-	fseek ( pAviParams->FileOut , 0 , SEEK_END );				/* go to the end of the 'movi' chunk */
-	pAviParams->MoviChunkPosEnd = ftell ( pAviParams->FileOut );
 	Avi_StoreU32 ( TempSize , pAviParams->MoviChunkPosEnd - pAviParams->MoviChunkPosStart - 8 );
 
 	if ( fseek ( pAviParams->FileOut , pAviParams->MoviChunkPosStart+4 , SEEK_SET ) != 0 )
 	{
 		perror ( "AviStopRecording" );
 		Log_AlertDlg ( LOG_ERROR, "AVI recording : failed to update movi header" );
+		Avi_FreeIndex ( pAviParams );
 		return false;
 	}
 	if ( fwrite ( TempSize , sizeof ( TempSize ) , 1 , pAviParams->FileOut ) != 1 )
 	{
 		perror ( "AviStopRecording" );
 		Log_AlertDlg ( LOG_ERROR, "AVI recording : failed to update movi header" );
+		Avi_FreeIndex ( pAviParams );
 		return false;
 	}
 
-	/* Build the index chunk */
+	/* Build the index chunk, the entries are not needed after that */
 	if ( ! Avi_BuildIndex ( pAviParams ) )
 	{
 		perror ( "AviStopRecording" );
 		Log_AlertDlg ( LOG_ERROR, "AVI recording : failed to build index" );
+		Avi_FreeIndex ( pAviParams );
 		return false;
 	}
+	Avi_FreeIndex ( pAviParams );
 	
 	/* Update the avi header (file size, number of output frames, ...) */
 	fseek ( pAviParams->FileOut , 0 , SEEK_END );				/* go to the end of the file */
@@ -935,7 +1134,6 @@ static bool	Avi_StopRecording_WithParams ( RECORD_AVI_PARAMS *pAviParams )
 	fclose ( pAviParams->FileOut );
 
 	Log_AlertDlg ( LOG_INFO, "AVI recording has been stopped");
-	bRecordingAvi = false;
 
 	return true;
 }
@@ -959,7 +1157,7 @@ bool	Avi_StartRecording ( char *FileName , bool CropGui , Uint32 Fps , Uint32 Fp
 	memset ( &AviParams , 0 , sizeof ( AviParams ) );
 
 	AviParams.VideoCodec = VideoCodec;
-	AviParams.VideoCodecCompressionLevel = 9;	/* png compression level */
+	AviParams.VideoCodecCompressionLevel = ConfigureParams.Video.AviRecordPngLevel;	/* png compression level */
 	AviParams.AudioCodec = AVI_RECORD_AUDIO_CODEC_PCM;
 	AviParams.AudioFreq = ConfigureParams.Sound.nPlaybackFreq;
 	AviParams.Surface = sdlscrn;
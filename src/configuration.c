@@ -36,6 +36,7 @@ static const struct Config_Tag configs_Log[] =
 {
 	{ "sLogFileName", String_Tag, ConfigureParams.Log.sLogFileName },
 	{ "sTraceFileName", String_Tag, ConfigureParams.Log.sTraceFileName },
+	{ "sTraceBinFileName", String_Tag, ConfigureParams.Log.sTraceBinFileName },
 	{ "nTextLogLevel", Int_Tag, &ConfigureParams.Log.nTextLogLevel },
 	{ "nAlertDlgLogLevel", Int_Tag, &ConfigureParams.Log.nAlertDlgLogLevel },
 	{ "bConfirmQuit", Bool_Tag, &ConfigureParams.Log.bConfirmQuit },
@@ -75,6 +76,7 @@ static const struct Config_Tag configs_Screen[] =
 	{ "nVdiColors", Int_Tag, &ConfigureParams.Screen.nVdiColors },
 	{ "bShowStatusbar", Bool_Tag, &ConfigureParams.Screen.bShowStatusbar },
 	{ "bShowDriveLed", Bool_Tag, &ConfigureParams.Screen.bShowDriveLed },
+	{ "bShowPerformance", Bool_Tag, &ConfigureParams.Screen.bShowPerformance },
 	{ "bCrop", Bool_Tag, &ConfigureParams.Screen.bCrop },
 	{ "nMaxWidth", Int_Tag, &ConfigureParams.Screen.nMaxWidth },
 	{ "nMaxHeight", Int_Tag, &ConfigureParams.Screen.nMaxHeight },
@@ -225,6 +227,8 @@ static const struct Config_Tag configs_SCSI[] =
     { "bDiskInserted6", Bool_Tag, &ConfigureParams.SCSI.target[6].bDiskInserted },
     { "bWriteProtected6", Bool_Tag, &ConfigureParams.SCSI.target[6].bWriteProtected },
 
+    { "nOverlayMode", Int_Tag, &ConfigureParams.SCSI.nOverlayMode },
+
     { NULL , Error_Tag, NULL }
 };
 
@@ -241,6 +245,8 @@ static const struct Config_Tag configs_MO[] =
     { "bDiskInserted1", Bool_Tag, &ConfigureParams.MO.drive[1].bDiskInserted },
     { "bWriteProtected1", Bool_Tag, &ConfigureParams.MO.drive[1].bWriteProtected },
 
+    { "nOverlayMode", Int_Tag, &ConfigureParams.MO.nOverlayMode },
+
 	{ NULL , Error_Tag, NULL }
 };
 
@@ -323,6 +329,9 @@ static const struct Config_Tag configs_System[] =
 	{ "bRealTimeClock", Bool_Tag, &ConfigureParams.System.bRealTimeClock },
 	{ "bPatchTimerD", Bool_Tag, &ConfigureParams.System.bPatchTimerD },
 	{ "bFastForward", Bool_Tag, &ConfigureParams.System.bFastForward },
+	{ "bFastBoot", Bool_Tag, &ConfigureParams.System.bFastBoot },
+	{ "nSpeedPercent", Int_Tag, &ConfigureParams.System.nSpeedPercent },
+	{ "nCoprocQuantum", Int_Tag, &ConfigureParams.System.nCoprocQuantum },
     
     { "bAddressSpace24", Bool_Tag, &ConfigureParams.System.bAddressSpace24 },
     { "bCycleExactCpu", Bool_Tag, &ConfigureParams.System.bCycleExactCpu },
@@ -349,6 +358,7 @@ static const struct Config_Tag configs_Video[] =
 {
     { "AviRecordVcodec", Int_Tag, &ConfigureParams.Video.AviRecordVcodec },
     { "AviRecordFps", Int_Tag, &ConfigureParams.Video.AviRecordFps },
+    { "AviRecordPngLevel", Int_Tag, &ConfigureParams.Video.AviRecordPngLevel },
     { "AviRecordFile", String_Tag, ConfigureParams.Video.AviRecordFile },
 	{ NULL , Error_Tag, NULL }
 };
@@ -374,6 +384,9 @@ void Configuration_SetDefault(void)
 	/* Set defaults for logging and tracing */
 	strcpy(ConfigureParams.Log.sLogFileName, "stderr");
 	strcpy(ConfigureParams.Log.sTraceFileName, "stderr");
+	ConfigureParams.Log.sTraceBinFileName[0] = '\0';
+	ConfigureParams.Log.sInputRecordFileName[0] = '\0';
+	ConfigureParams.Log.sInputReplayFileName[0] = '\0';
 	ConfigureParams.Log.nTextLogLevel = LOG_TODO;
 	ConfigureParams.Log.nAlertDlgLogLevel = LOG_ERROR;
 	ConfigureParams.Log.bConfirmQuit = true;
@@ -403,6 +416,7 @@ void Configuration_SetDefault(void)
         ConfigureParams.SCSI.target[i].bDiskInserted = false;
         ConfigureParams.SCSI.target[i].bWriteProtected = false;
     }
+    ConfigureParams.SCSI.nOverlayMode = OVERLAY_OFF;
     
     /* Set defaults for MO drives */
     for (i = 0; i < MO_MAX_DRIVES; i++) {
@@ -411,6 +425,7 @@ void Configuration_SetDefault(void)
         ConfigureParams.MO.drive[i].bDiskInserted = false;
         ConfigureParams.MO.drive[i].bWriteProtected = false;
     }
+    ConfigureParams.MO.nOverlayMode = OVERLAY_OFF;
     
     /* Set defaults for floppy drives */
     for (i = 0; i < FLP_MAX_DRIVES; i++) {
@@ -498,6 +513,7 @@ void Configuration_SetDefault(void)
 	ConfigureParams.Screen.bUseExtVdiResolutions = false;
 	ConfigureParams.Screen.bShowStatusbar = true;
 	ConfigureParams.Screen.bShowDriveLed = true;
+	ConfigureParams.Screen.bShowPerformance = false;
 	ConfigureParams.Screen.bCrop = false;
 	/* target 800x600 screen with statusbar out of screen */
 	ConfigureParams.Screen.nMaxWidth = 0;
@@ -533,6 +549,9 @@ void Configuration_SetDefault(void)
 	ConfigureParams.System.bPatchTimerD = true;
 	ConfigureParams.System.bRealTimeClock = true;
 	ConfigureParams.System.bFastForward = false;
+	ConfigureParams.System.bFastBoot = false;
+	ConfigureParams.System.nSpeedPercent = 100;
+	ConfigureParams.System.nCoprocQuantum = 256;
     
     ConfigureParams.System.bAddressSpace24 = false;
     ConfigureParams.System.bCycleExactCpu = false;
@@ -556,6 +575,7 @@ void Configuration_SetDefault(void)
     ConfigureParams.Video.AviRecordVcodec = AVI_RECORD_VIDEO_CODEC_BMP;
 #endif
     ConfigureParams.Video.AviRecordFps = 0;			/* automatic FPS */
+    ConfigureParams.Video.AviRecordPngLevel = 3;		/* fast png compression */
     sprintf(ConfigureParams.Video.AviRecordFile, "%s%chatari.avi", psWorkingDir, PATHSEP);
 
 
@@ -644,6 +664,7 @@ void Configuration_Apply(bool bReset)
 	/* make path names absolute, but handle special file names */
 	File_MakeAbsoluteSpecialName(ConfigureParams.Log.sLogFileName);
 	File_MakeAbsoluteSpecialName(ConfigureParams.Log.sTraceFileName);
+	File_MakeAbsoluteSpecialName(ConfigureParams.Log.sTraceBinFileName);
 	File_MakeAbsoluteSpecialName(ConfigureParams.RS232.szInFileName);
 	File_MakeAbsoluteSpecialName(ConfigureParams.RS232.szOutFileName);
 	File_MakeAbsoluteSpecialName(ConfigureParams.Midi.sMidiInFileName);
@@ -27,6 +27,7 @@ const char Control_fileid[] = "Hatari control.c : " __DATE__ " " __TIME__;
 #include "debugui.h"
 #include "file.h"
 #include "log.h"
+#include "perfstats.h"
 #include "screen.h"
 #include "shortcut.h"
 #include "str.h"
@@ -42,6 +43,11 @@ static bool bSendEmbedInfo;
 /* Pausing triggered remotely (battery save pause) */
 static bool bRemotePaused;
 
+#if HAVE_UNIX_DOMAIN_SOCKETS
+/* socket from which control command line options are read */
+static int ControlSocket;
+#endif
+
 
 /*-----------------------------------------------------------------------*/
 /**
@@ -256,6 +262,27 @@ static bool Control_SetPath(char *name)
 	return false;
 }
 
+/*-----------------------------------------------------------------------*/
+/**
+ * Send performance statistics as "name value" lines back through the
+ * control socket, or show them if there is none.
+ */
+static void Control_SendStats(void)
+{
+	char buffer[2048];
+	int len;
+
+	len = PerfStats_Print(buffer, sizeof(buffer));
+#if HAVE_UNIX_DOMAIN_SOCKETS
+	if (ControlSocket) {
+		if (write(ControlSocket, buffer, len) < 0)
+			perror("Control_SendStats write");
+		return;
+	}
+#endif
+	fputs(buffer, stderr);
+}
+
 /*-----------------------------------------------------------------------*/
 /**
  * Show Hatari remote usage info and return false
@@ -272,6 +299,7 @@ static bool Control_Usage(const char *cmd)
 		"- hatari-path <config name> <new path>\n"
 		"- hatari-shortcut <shortcut name>\n"
 		"- hatari-embed-info\n"
+		"- hatari-stats\n"
 		"- hatari-stop\n"
 		"- hatari-cont\n"
 		"The last two can be used to stop and continue the Hatari emulation.\n"
@@ -327,6 +355,8 @@ void Control_ProcessBuffer(char *buffer)
 			if (strcmp(cmd, "hatari-embed-info") == 0) {
 				fprintf(stderr, "Embedded window ID change messages = ON\n");
 				bSendEmbedInfo = true;
+			} else if (strcmp(cmd, "hatari-stats") == 0) {
+				Control_SendStats();
 			} else if (strcmp(cmd, "hatari-stop") == 0) {
 				Main_PauseEmulation(true);
 				bRemotePaused = true;
@@ -346,9 +376,6 @@ void Control_ProcessBuffer(char *buffer)
 
 #if HAVE_UNIX_DOMAIN_SOCKETS
 
-/* socket from which control command line options are read */
-static int ControlSocket;
-
 /* pre-declared local functions */
 static int Control_GetUISocket(void);
 
@@ -115,7 +115,7 @@ static char buffer[832*1152*4];
 static void InvalidateScreenBuffer(void) {
     int i;
 #if ENABLE_DIMENSION
-    if (ConfigureParams.Screen.nMonitorType==MONITOR_TYPE_DIMENSION) {
+    if (ConfigureParams.Screen.nMonitorType==MONITOR_TYPE_DIMENSION && ND_vram) {
         for (i = 0; i < (832*1152*4); i++)
             buffer[i] = ND_vram[i]+1;
         return;
@@ -143,7 +143,7 @@ static void ConvertHighRes_640x8Bit(void)
 
 #if ENABLE_DIMENSION
     /* dimension */
-    if (ConfigureParams.Screen.nMonitorType==MONITOR_TYPE_DIMENSION) {
+    if (ConfigureParams.Screen.nMonitorType==MONITOR_TYPE_DIMENSION && ND_vram) {
         for (y = 0; y < 832; y++)
         {
             adr=y*288*16;
@@ -502,6 +502,37 @@ uaecptr REGPARAM2 mmu_translate(uaecptr addr, bool super, bool data, bool write)
 
 }
 
+/*
+ * Translate an instruction address for the trace buffer. Only the
+ * transparent regions and the ATC are looked at; nothing is allocated
+ * or faulted, so the emulation is not affected.
+ */
+bool mmu_translate_peek(uaecptr addr, bool super, uaecptr *phys, uae_u32 *pagemask)
+{
+	int way, index;
+	uae_u32 tag;
+
+	if ((!regs.mmu_enabled) || (mmu_match_ttr(addr,super,false,false)!=TTR_NO_MATCH)) {
+		*phys = addr;
+		*pagemask = 0xffffffff;
+		return true;
+	}
+	tag = ((super ? 0x80000000 : 0x00000000) | (addr >> 1)) & mmu_tagmask;
+	if (mmu_pagesize_8k)
+		index=(addr & 0x0001E000)>>13;
+	else
+		index=(addr & 0x0000F000)>>12;
+	for (way = 0; way < ATC_WAYS; way++) {
+		struct mmu_atc_line *l = &mmu_atc_array[0][way][index];
+		if (l->valid && l->tag == tag) {
+			*phys = mmu_get_real_address(addr, l);
+			*pagemask = mmu_pagemask;
+			return true;
+		}
+	}
+	return false;
+}
+
 /*
  * Lookup the address by walking the page table and updating
  * the page descriptors accordingly. Returns the found descriptor
@@ -2153,6 +2153,32 @@ uaecptr mmu030_translate(uaecptr addr, bool super, bool data, bool write)
     }
 }
 
+/* Used by the trace buffer: translate an instruction address with the
+ * current ATC contents only, without faulting or updating history bits */
+bool mmu030_translate_peek(uaecptr addr, bool super, uaecptr *phys, uae_u32 *pagemask)
+{
+    uae_u32 fc = (super ? 4 : 0) | 2;
+    uae_u32 addr_mask = mmu030.translation.page.imask;
+    int i;
+
+    if ((!mmu030.enabled) || (mmu030_match_ttr(addr,fc,false)&TT_OK_MATCH)) {
+        *phys = addr;
+        *pagemask = 0xffffffff;
+        return true;
+    }
+    for (i=0; i<ATC030_NUM_ENTRIES; i++) {
+        if (mmu030.atc[i].logical.valid && mmu030.atc[i].logical.fc==fc &&
+            (addr&addr_mask)==(mmu030.atc[i].logical.addr&addr_mask)) {
+            if (mmu030.atc[i].physical.bus_error)
+                return false;
+            *phys = (mmu030.atc[i].physical.addr&addr_mask) + (addr&mmu030.translation.page.mask);
+            *pagemask = mmu030.translation.page.mask;
+            return true;
+        }
+    }
+    return false;
+}
+
 /* MMU Reset */
 void mmu030_reset(int hardreset)
 {
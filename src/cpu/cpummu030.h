@@ -71,6 +71,7 @@ void mmu030_flush_atc_page_fc(uaecptr logical_addr, uae_u32 fc_base, uae_u32 fc_
 void mmu030_flush_atc_all(void);
 void mmu030_reset(int hardreset);
 uaecptr mmu030_translate(uaecptr addr, bool super, bool data, bool write);
+bool mmu030_translate_peek(uaecptr addr, bool super, uaecptr *phys, uae_u32 *pagemask);
 
 int mmu030_match_ttr(uaecptr addr, uae_u32 fc, bool write);
 int mmu030_match_ttr_access(uaecptr addr, uae_u32 fc, bool write);
@@ -2199,24 +2199,30 @@ typedef enum
 }
 flagtypes;
 
+/* Logical, add, sub and cmp only record result and destination, N, Z and V
+ * are computed when they are read (see MakeFlags), C and X right away. */
 static void genflags_normal (flagtypes type, wordsizes size, char *value, char *src, char *dst)
 {
 	char vstr[100], sstr[100], dstr[100];
 	char usstr[100], udstr[100];
 	char unsstr[100], undstr[100];
+	const char *msb;
 
 	switch (size) {
 	case sz_byte:
 		strcpy (vstr, "((uae_s8)(");
 		strcpy (usstr, "((uae_u8)(");
+		msb = "0x80";
 		break;
 	case sz_word:
 		strcpy (vstr, "((uae_s16)(");
 		strcpy (usstr, "((uae_u16)(");
+		msb = "0x8000";
 		break;
 	case sz_long:
 		strcpy (vstr, "((uae_s32)(");
 		strcpy (usstr, "((uae_u32)(");
+		msb = "0x80000000";
 		break;
 	default:
 		term ();
@@ -2272,13 +2278,13 @@ static void genflags_normal (flagtypes type, wordsizes size, char *value, char *
 	case flag_logical_noclobber:
 	case flag_logical:
 	case flag_zn:
-		break;
-
 	case flag_add:
 	case flag_sub:
+	case flag_cmp:
+		break;
+
 	case flag_addx:
 	case flag_subx:
-	case flag_cmp:
 	case flag_av:
 	case flag_sv:
 		start_brace ();
@@ -2290,9 +2296,7 @@ static void genflags_normal (flagtypes type, wordsizes size, char *value, char *
 
 	switch (type) {
 	case flag_logical:
-		printf ("\tCLEAR_CZNV ();\n");
-		printf ("\tSET_ZFLG (%s == 0);\n", vstr);
-		printf ("\tSET_NFLG (%s < 0);\n", vstr);
+		printf ("\tSET_LAZY_LOGICAL (%s, %s);\n", msb, vstr);
 		break;
 	case flag_logical_noclobber:
 		printf ("\tSET_ZFLG (%s == 0);\n", vstr);
@@ -2312,18 +2316,12 @@ static void genflags_normal (flagtypes type, wordsizes size, char *value, char *
 		printf ("\tSET_NFLG (%s < 0);\n", vstr);
 		break;
 	case flag_add:
-		printf ("\tSET_ZFLG (%s == 0);\n", vstr);
-		printf ("\tSET_VFLG ((flgs ^ flgn) & (flgo ^ flgn));\n");
-		printf ("\tSET_CFLG (%s < %s);\n", undstr, usstr);
+		printf ("\tSET_LAZY_ARITH (FLAGLAZY_ADD, %s, %s, %s, %s < %s);\n", msb, dstr, value, undstr, usstr);
 		duplicate_carry (0);
-		printf ("\tSET_NFLG (flgn != 0);\n");
 		break;
 	case flag_sub:
-		printf ("\tSET_ZFLG (%s == 0);\n", vstr);
-		printf ("\tSET_VFLG ((flgs ^ flgo) & (flgn ^ flgo));\n");
-		printf ("\tSET_CFLG (%s > %s);\n", usstr, udstr);
+		printf ("\tSET_LAZY_ARITH (FLAGLAZY_SUB, %s, %s, %s, %s > %s);\n", msb, dstr, value, usstr, udstr);
 		duplicate_carry (0);
-		printf ("\tSET_NFLG (flgn != 0);\n");
 		break;
 	case flag_addx:
 		printf ("\tSET_VFLG ((flgs ^ flgn) & (flgo ^ flgn));\n"); /* minterm SON: 0x42 */
@@ -2336,10 +2334,7 @@ static void genflags_normal (flagtypes type, wordsizes size, char *value, char *
 		duplicate_carry (0);
 		break;
 	case flag_cmp:
-		printf ("\tSET_ZFLG (%s == 0);\n", vstr);
-		printf ("\tSET_VFLG ((flgs != flgo) && (flgn != flgo));\n");
-		printf ("\tSET_CFLG (%s > %s);\n", usstr, udstr);
-		printf ("\tSET_NFLG (flgn != 0);\n");
+		printf ("\tSET_LAZY_ARITH (FLAGLAZY_SUB, %s, %s, %s, %s > %s);\n", msb, dstr, value, usstr, udstr);
 		break;
 	}
 }
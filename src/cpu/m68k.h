@@ -13,9 +13,13 @@
 struct flag_struct {
     unsigned int cznv;
     unsigned int x;
+    unsigned int lazy;		/* FLAGLAZY_* | sign bit of operand size, 0 = none */
+    uae_u32 lazy_dst;
+    uae_u32 lazy_res;
 };
 
 extern struct flag_struct regflags;
+extern void MakeFlags (void);
 
 /*
  * The bits in the cznv field in the above structure are assigned to
@@ -43,22 +47,48 @@ extern struct flag_struct regflags;
 #define FLAGVAL_V	(1 << FLAGBIT_V)
 #define FLAGVAL_X	(1 << FLAGBIT_X)
 
-#define SET_ZFLG(y)	(regflags.cznv = (regflags.cznv & ~FLAGVAL_Z) | (((y) ? 1 : 0) << FLAGBIT_Z))
+/*
+ * Lazy flags: the most common instructions (MOVE, TST, logical ops, ADD,
+ * SUB, CMP, ...) only record their result and destination operand and
+ * leave N, Z and V to be computed by MakeFlags when they are read. Most
+ * of them are overwritten by the next instruction before that happens.
+ * C and X are always computed right away, so they stay valid in cznv
+ * and x while the other flags are pending.
+ */
+#define FLAGLAZY_LOGICAL	1	/* N, Z from result, V = 0 */
+#define FLAGLAZY_ADD		2	/* result = dst + src */
+#define FLAGLAZY_SUB		3	/* result = dst - src, also CMP */
+#define FLAGLAZY_MASK		3
+
+#define SET_LAZY_LOGICAL(msb, res) \
+	(regflags.cznv = 0, regflags.lazy = FLAGLAZY_LOGICAL | (msb), regflags.lazy_res = (res))
+#define SET_LAZY_ARITH(type, msb, dst, res, c) \
+	(regflags.cznv = ((c) ? 1 : 0) << FLAGBIT_C, regflags.lazy = (type) | (msb), \
+	 regflags.lazy_dst = (dst), regflags.lazy_res = (res))
+
+STATIC_INLINE uae_u32 get_cznv (void)
+{
+    if (regflags.lazy)
+	MakeFlags ();
+    return regflags.cznv;
+}
+
+#define SET_ZFLG(y)	(regflags.cznv = (get_cznv () & ~FLAGVAL_Z) | (((y) ? 1 : 0) << FLAGBIT_Z))
 #define SET_CFLG(y)	(regflags.cznv = (regflags.cznv & ~FLAGVAL_C) | (((y) ? 1 : 0) << FLAGBIT_C))
-#define SET_VFLG(y)	(regflags.cznv = (regflags.cznv & ~FLAGVAL_V) | (((y) ? 1 : 0) << FLAGBIT_V))
-#define SET_NFLG(y)	(regflags.cznv = (regflags.cznv & ~FLAGVAL_N) | (((y) ? 1 : 0) << FLAGBIT_N))
+#define SET_VFLG(y)	(regflags.cznv = (get_cznv () & ~FLAGVAL_V) | (((y) ? 1 : 0) << FLAGBIT_V))
+#define SET_NFLG(y)	(regflags.cznv = (get_cznv () & ~FLAGVAL_N) | (((y) ? 1 : 0) << FLAGBIT_N))
 #define SET_XFLG(y)	(regflags.x    = ((y) ? 1 : 0) << FLAGBIT_X)
 
-#define GET_ZFLG()	((regflags.cznv >> FLAGBIT_Z) & 1)
+#define GET_ZFLG()	((get_cznv () >> FLAGBIT_Z) & 1)
 #define GET_CFLG()	((regflags.cznv >> FLAGBIT_C) & 1)
-#define GET_VFLG()	((regflags.cznv >> FLAGBIT_V) & 1)
-#define GET_NFLG()	((regflags.cznv >> FLAGBIT_N) & 1)
+#define GET_VFLG()	((get_cznv () >> FLAGBIT_V) & 1)
+#define GET_NFLG()	((get_cznv () >> FLAGBIT_N) & 1)
 #define GET_XFLG()	((regflags.x    >> FLAGBIT_X) & 1)
 
-#define CLEAR_CZNV()	(regflags.cznv  = 0)
-#define GET_CZNV()	(regflags.cznv)
-#define IOR_CZNV(X)	(regflags.cznv |= (X))
-#define SET_CZNV(X)	(regflags.cznv  = (X))
+#define CLEAR_CZNV()	(regflags.lazy = 0, regflags.cznv = 0)
+#define GET_CZNV()	(get_cznv ())
+#define IOR_CZNV(X)	(regflags.cznv = get_cznv () | (X))
+#define SET_CZNV(X)	(regflags.lazy = 0, regflags.cznv = (X))
 
 #define COPY_CARRY() (regflags.x = regflags.cznv)
 
@@ -68,7 +98,17 @@ extern struct flag_struct regflags;
  */
 STATIC_INLINE int cctrue (int cc)
 {
-    uae_u32 cznv = regflags.cznv;
+    uae_u32 cznv;
+
+    if (regflags.lazy) {
+	uae_u32 msb = regflags.lazy & ~FLAGLAZY_MASK;
+	/* EQ and NE (the most common ones) directly from the result */
+	if (cc == 6 || cc == 7)
+	    return ((regflags.lazy_res & ((msb << 1) - 1)) == 0) == (cc == 7);
+	if (cc > 1 && cc != 4 && cc != 5)
+	    MakeFlags ();
+    }
+    cznv = regflags.cznv;
 
     switch (cc) {
 	case 0:  return 1;								/*				T  */
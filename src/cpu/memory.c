@@ -28,6 +28,7 @@ const char Memory_fileid[] = "Previous memory.c : " __DATE__ " " __TIME__;
 #include "nextMemory.h"
 #include "m68000.h"
 #include "configuration.h"
+#include "fastboot.h"
 
 #include "newcpu.h"
 
@@ -1038,6 +1039,7 @@ const char* memory_init(int *nNewNEXTMemSize)
 {
 	int i;
 	uae_u32 bankstart[4];
+	uae_u32 bankmask, bankend, ramsize;
 	
 	/* Set machine dependent variables */
 	if (ConfigureParams.System.bTurbo) {
@@ -1058,6 +1060,25 @@ const char* memory_init(int *nNewNEXTMemSize)
 		bankstart[i] = NEXT_RAM_START + (NEXT_ram_bank_size * i);
 	}
 	
+	/* Allocate host memory up to the end of the highest bank, the
+	 * new mapping also clears the memory */
+	ramsize = 0;
+	for (i=0; i<N_BANKS; i++) {
+		if (nNewNEXTMemSize[i]) {
+			bankmask = NEXT_ram_bank_mask|((nNewNEXTMemSize[i]<<20)-1);
+			bankend = ((bankstart[i]+(nNewNEXTMemSize[i]<<20)-1)&bankmask)+1;
+			if (bankend > ramsize) {
+				ramsize = bankend;
+			}
+		}
+	}
+	NEXTMemory_FreeRam(NEXTRam, NEXTRamEnd);
+	NEXTRam = NEXTMemory_AllocRam(ramsize);
+	NEXTRamEnd = NEXTRam ? ramsize : 0;
+	if (!NEXTRam) {
+		return "Cannot allocate main memory";
+	}
+	
 	/* Fill every 65536 bank with dummy */
 	init_mem_banks();
 	
@@ -1216,12 +1237,12 @@ const char* memory_init(int *nNewNEXTMemSize)
 		
 		write_log("Read ROM %d\n",ret);
 		fclose(fin);
+		FastBoot_Init(ROMmemory, ret);
 	}
 	
 	{
 		int i;
 		for (i=0;i<sizeof(NEXTVideo);i++) NEXTVideo[i]=0;
-		for (i=0;i<sizeof(NEXTRam);i++) NEXTRam[i]=0;
 		for (i=0;i<sizeof(NEXTIo);i++) NEXTIo[i]=0;
 	}
 	
@@ -1236,6 +1257,9 @@ const char* memory_init(int *nNewNEXTMemSize)
  */
 void memory_uninit (void)
 {
+	NEXTMemory_FreeRam(NEXTRam, NEXTRamEnd);
+	NEXTRam = NULL;
+	NEXTRamEnd = 0;
 }
 
 
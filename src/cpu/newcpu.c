@@ -37,6 +37,9 @@
 #include "log.h"
 #include "debugui.h"
 #include "debugcpu.h"
+#include "fastboot.h"
+#include "tracebuf.h"
+#include "perfstats.h"
 
 
 #ifdef JIT
@@ -312,6 +315,7 @@ void set_cpu_caches (bool flush)
 
 STATIC_INLINE void count_instr (unsigned int opcode)
 {
+	nPerfCpuInstr++;
 }
 
 //static unsigned long REGPARAM3 op_illg_1 (uae_u32 opcode) REGPARAM;
@@ -954,6 +958,35 @@ STATIC_INLINE int in_rtarea (uaecptr pc)
 }
 #endif
 
+/* Compute N, Z and V left pending by an instruction with lazy flags */
+void MakeFlags (void)
+{
+	uae_u32 msb = regflags.lazy & ~FLAGLAZY_MASK;
+	uae_u32 dst = regflags.lazy_dst;
+	uae_u32 res = regflags.lazy_res;
+	uae_u32 src;
+	uae_u32 cznv = regflags.cznv & FLAGVAL_C;
+
+	if (res & msb)
+		cznv |= FLAGVAL_N;
+	if ((res & ((msb << 1) - 1)) == 0)
+		cznv |= FLAGVAL_Z;
+	switch (regflags.lazy & FLAGLAZY_MASK) {
+	case FLAGLAZY_ADD:
+		src = res - dst;
+		if ((src ^ res) & (dst ^ res) & msb)
+			cznv |= FLAGVAL_V;
+		break;
+	case FLAGLAZY_SUB:
+		src = dst - res;
+		if ((src ^ dst) & (res ^ dst) & msb)
+			cznv |= FLAGVAL_V;
+		break;
+	}
+	regflags.cznv = cznv;
+	regflags.lazy = 0;
+}
+
 void REGPARAM2 MakeSR (void)
 {
 	regs.sr = ((regs.t1 << 15) | (regs.t0 << 14)
@@ -2231,7 +2264,9 @@ static void m68k_run_1 (void)
 		count_instr (opcode);
 
 	/*m68k_dumpstate(stderr, NULL);*/
-	if (LOG_TRACE_LEVEL(TRACE_CPU_DISASM))
+	if (LOG_TRACE_LEVEL(TRACE_CPU_DISASM) && bTraceBufEnabled)
+		TraceBuf_CpuDisasm(m68k_getpc ());
+	else if (LOG_TRACE_LEVEL(TRACE_CPU_DISASM))
 	{
 	    int FrameCycles, HblCounterVideo, LineCycles;
 
@@ -2288,7 +2323,9 @@ static void m68k_run_1_ce (void)
 		uae_u32 opcode = r->ir;
 
 		/*m68k_dumpstate(stderr, NULL);*/
-		if (LOG_TRACE_LEVEL(TRACE_CPU_DISASM))
+		if (LOG_TRACE_LEVEL(TRACE_CPU_DISASM) && bTraceBufEnabled)
+			TraceBuf_CpuDisasm(m68k_getpc ());
+		else if (LOG_TRACE_LEVEL(TRACE_CPU_DISASM))
 		{
 			int FrameCycles, HblCounterVideo, LineCycles;
 			Video_GetPosition ( &FrameCycles , &HblCounterVideo , &LineCycles );
@@ -2384,7 +2421,9 @@ static void m68k_run_jit (void)
 	for (;;) {
 
 		/*m68k_dumpstate(stderr, NULL);*/
-		if (LOG_TRACE_LEVEL(TRACE_CPU_DISASM))
+		if (LOG_TRACE_LEVEL(TRACE_CPU_DISASM) && bTraceBufEnabled)
+			TraceBuf_CpuDisasm(m68k_getpc ());
+		else if (LOG_TRACE_LEVEL(TRACE_CPU_DISASM))
 		{
 			int FrameCycles, HblCounterVideo, LineCycles;
 			Video_GetPosition ( &FrameCycles , &HblCounterVideo , &LineCycles );
@@ -2444,6 +2483,25 @@ static void opcodedebug (uae_u32 pc, uae_u16 opcode)
 #endif
 
 
+/* Trace an instruction fetched through the MMU. The words following the
+ * opcode are read through the translation the opcode fetch has set up,
+ * without faulting; past the page end nothing is recorded. */
+static void m68k_trace_mmu (uaecptr pc, uae_u16 opcode, bool mmu040)
+{
+	uaecptr phys;
+	uae_u32 pagemask;
+	bool found;
+
+	if (mmu040)
+		found = mmu_translate_peek (pc, regs.s != 0, &phys, &pagemask);
+	else
+		found = mmu030_translate_peek (pc, regs.s != 0, &phys, &pagemask);
+	if (found)
+		TraceBuf_CpuOpcode (pc, opcode, phys, (pagemask & ~pc) / 2 + 1);
+	else
+		TraceBuf_CpuOpcode (pc, opcode, 0, 1);
+}
+
 // Previous MMU 68030
 static void m68k_run_mmu030 (void)
 {
@@ -2461,8 +2519,9 @@ retry:
 			int cnt;
 insretry:
 			pc = regs.instruction_pc = m68k_getpc ();
-			f.cznv = regflags.cznv;
-			f.x = regflags.x;
+			if (bFastBootArmed)
+				FastBoot_Skip(pc);
+			f = regflags;
 
 			mmu030_state[0] = mmu030_state[1] = mmu030_state[2] = 0;
 			mmu030_opcode = -1;
@@ -2480,6 +2539,10 @@ insretry:
 			for (;;) {
 				opcode = mmu030_opcode;
 				mmu030_idx = 0;
+				if (LOG_TRACE_LEVEL(TRACE_CPU_DISASM) && bTraceBufEnabled)
+					m68k_trace_mmu (pc, opcode, false);
+				else if (LOG_TRACE_LEVEL(TRACE_CPU_DISASM))
+					LOG_TRACE_PRINT ( "cpu pc=%08x : %04x\n" , pc, opcode );
 				count_instr (opcode);
 				do_cycles (cpu_cycles);
 				mmu030_retry = false;
@@ -2497,10 +2560,7 @@ insretry:
 
 			mmu030_opcode = -1;
             
-			DSP_Run(cpu_cycles * 2 / CYCLE_UNIT);
-#if ENABLE_DIMENSION
-            i860_Run(cpu_cycles * 2 / CYCLE_UNIT);
-#endif
+			M68000_RunCoprocessors(cpu_cycles * 2 / CYCLE_UNIT);
 
 			M68000_AddCycles(cpu_cycles * 2 / CYCLE_UNIT);
 
@@ -2539,8 +2599,7 @@ insretry:
 	} CATCH (prb) {
 		save_except = __exvalue;
 
-		regflags.cznv = f.cznv;
-		regflags.x = f.x;
+		regflags = f;
 
 		m68k_setpc (regs.instruction_pc);
 
@@ -2577,22 +2636,24 @@ static void m68k_run_mmu040 (void)
 	for (;;) {
 	TRY (prb) {
 		for (;;) {
-			f.cznv = regflags.cznv;
-			f.x = regflags.x;
+			f = regflags;
 			mmu_restart = true;
 			pc = regs.instruction_pc = m68k_getpc ();
+			if (bFastBootArmed)
+				FastBoot_Skip(pc);
 
 			do_cycles (cpu_cycles);
 
 			mmu_opcode = -1;
 			mmu_opcode = opcode = x_prefetch (0);
+			if (LOG_TRACE_LEVEL(TRACE_CPU_DISASM) && bTraceBufEnabled)
+				m68k_trace_mmu (pc, opcode, true);
+			else if (LOG_TRACE_LEVEL(TRACE_CPU_DISASM))
+				LOG_TRACE_PRINT ( "cpu pc=%08x : %04x\n" , pc, opcode );
 			count_instr (opcode);
 			cpu_cycles = (*cpufunctbl[opcode])(opcode);
 
-			DSP_Run(cpu_cycles * 2 / CYCLE_UNIT);
-#if ENABLE_DIMENSION
-            i860_Run(cpu_cycles * 2 / CYCLE_UNIT);
-#endif
+			M68000_RunCoprocessors(cpu_cycles * 2 / CYCLE_UNIT);
 
 			M68000_AddCycles(cpu_cycles * 2 / CYCLE_UNIT);
 
@@ -2634,8 +2695,7 @@ static void m68k_run_mmu040 (void)
 
 		if (mmu_restart) {
 			/* restore state if instruction restart */
-			regflags.cznv = f.cznv;
-			regflags.x = f.x;
+			regflags = f;
 			m68k_setpc (regs.instruction_pc);
 		}
 
@@ -2666,7 +2726,9 @@ static void m68k_run_2ce (void)
 	for (;;) {
 		uae_u32 opcode = 0;		// 25/12/2013 - Strict C (pre 1999) does not allow variables to be declared after the start of a scoping brace
 		/*m68k_dumpstate(stderr, NULL);*/
-		if (LOG_TRACE_LEVEL(TRACE_CPU_DISASM))
+		if (LOG_TRACE_LEVEL(TRACE_CPU_DISASM) && bTraceBufEnabled)
+			TraceBuf_CpuDisasm(m68k_getpc ());
+		else if (LOG_TRACE_LEVEL(TRACE_CPU_DISASM))
 		{
 			int FrameCycles, HblCounterVideo, LineCycles;
 			Video_GetPosition ( &FrameCycles , &HblCounterVideo , &LineCycles );
@@ -2706,7 +2768,9 @@ static void m68k_run_2p (void)
 		uae_u32 pc = m68k_getpc ();
 
 		/*m68k_dumpstate(stderr, NULL);*/
-		if (LOG_TRACE_LEVEL(TRACE_CPU_DISASM))
+		if (LOG_TRACE_LEVEL(TRACE_CPU_DISASM) && bTraceBufEnabled)
+			TraceBuf_CpuDisasm(m68k_getpc ());
+		else if (LOG_TRACE_LEVEL(TRACE_CPU_DISASM))
 		{
 			int FrameCycles, HblCounterVideo, LineCycles;
 			Video_GetPosition ( &FrameCycles , &HblCounterVideo , &LineCycles );
@@ -2774,7 +2838,9 @@ static void m68k_run_2 (void)
 		count_instr (opcode);
 
 		/*m68k_dumpstate(stderr, NULL);*/
-		if (LOG_TRACE_LEVEL(TRACE_CPU_DISASM))
+		if (LOG_TRACE_LEVEL(TRACE_CPU_DISASM) && bTraceBufEnabled)
+			TraceBuf_CpuDisasm(m68k_getpc ());
+		else if (LOG_TRACE_LEVEL(TRACE_CPU_DISASM))
 		{
 			int FrameCycles, HblCounterVideo, LineCycles;
 			Video_GetPosition ( &FrameCycles , &HblCounterVideo , &LineCycles );
@@ -2827,7 +2893,9 @@ static void m68k_run_mmu (void)
 	for (;;) {
 		uae_u32 opcode = 0;		// 25/12/2013 - Strict C adhearance (if your going to use C99 IMO you may as well use C++!)
 		/*m68k_dumpstate(stderr, NULL);*/
-		if (LOG_TRACE_LEVEL(TRACE_CPU_DISASM))
+		if (LOG_TRACE_LEVEL(TRACE_CPU_DISASM) && bTraceBufEnabled)
+			TraceBuf_CpuDisasm(m68k_getpc ());
+		else if (LOG_TRACE_LEVEL(TRACE_CPU_DISASM))
 		{
 			int FrameCycles, HblCounterVideo, LineCycles;
 			Video_GetPosition ( &FrameCycles , &HblCounterVideo , &LineCycles );
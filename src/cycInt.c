@@ -63,6 +63,7 @@ const char CycInt_fileid[] = "Hatari cycInt.c : " __DATE__ " " __TIME__;
 #include "floppy.h"
 #include "snd.h"
 #include "printer.h"
+#include "inputlog.h"
 
 
 void (*PendingInterruptFunction)(void);
@@ -87,9 +88,33 @@ static void (* const pIntHandlerFunctions[MAX_INTERRUPTS])(void) =
     ENET_IO_Handler,
     FLP_IO_Handler,
     SND_IO_Handler,
-    Printer_IO_Handler
+    Printer_IO_Handler,
+    InputLog_InterruptHandler
 };
 
+/* Names of the interrupt handlers for the statistics */
+static const char * const pIntHandlerNames[MAX_INTERRUPTS] =
+{
+	"null",
+	"vbl",
+	"hardclock",
+	"esp",
+	"esp_io",
+	"m2r_dma",
+	"r2m_dma",
+	"mo",
+	"mo_io",
+	"ecc_io",
+	"enet_io",
+	"flp_io",
+	"snd_io",
+	"lp_io",
+	"inputlog"
+};
+
+/* How often each handler was called, never reset */
+static Uint64 nInterruptEvents[MAX_INTERRUPTS];
+
 /* Event timer structure - keeps next timer to occur in structure so don't need
  * to check all entries */
 typedef struct
@@ -290,6 +315,7 @@ void CycInt_AcknowledgeInterrupt(void)
 
 	/* Disable interrupt entry which has just occured */
 	InterruptHandlers[ActiveInterrupt].bUsed = false;
+	nInterruptEvents[ActiveInterrupt]++;
 
 	/* Set new */
 	CycInt_SetNewInterrupt();
@@ -439,3 +465,14 @@ int CycInt_FindCyclesPassed(interrupt_id Handler, int CycleType)
 
 	return INT_CONVERT_FROM_INTERNAL ( CyclesPassed , CycleType ) ;
 }
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Return name of an interrupt handler and how often it was called
+ */
+const char *CycInt_GetEventCount(interrupt_id Handler, Uint64 *pCount)
+{
+	*pCount = nInterruptEvents[Handler];
+	return pIntHandlerNames[Handler];
+}
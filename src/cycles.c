@@ -35,6 +35,7 @@ const char Cycles_fileid[] = "Hatari cycles.c : " __DATE__ " " __TIME__;
 
 
 int nCyclesMainCounter;				/* Main cycles counter */
+Uint64 nCyclesClock;				/* Emulated cycles since start, never reset */
 
 static int nCyclesCounter[CYCLES_COUNTER_MAX];	/* Array with all counters */
 
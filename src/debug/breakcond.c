@@ -66,7 +66,7 @@ static inline bool is_register_type(value_t vtype) {
 	return (vtype == VALUE_TYPE_REG16 || vtype == VALUE_TYPE_REG32);
 }
 
-typedef struct {
+typedef struct bc_value_s {
 	bool is_indirect;
 	char dsp_space;	/* DSP has P, X, Y address spaces, zero if not DSP */
 	value_t valuetype;	/* Hatari value variable type */
@@ -79,6 +79,8 @@ typedef struct {
 	} value;
 	Uint32 bits;	/* CPU has 8/16/32 bit address widths */
 	Uint32 mask;	/* <width mask> && <value mask> */
+	/* accessor selected for the value type when breakpoint is added */
+	Uint32 (*get)(const struct bc_value_s *bc_value);
 } bc_value_t;
 
 typedef struct {
@@ -102,6 +104,8 @@ typedef struct {
 	bc_condition_t conditions[BC_MAX_CONDITIONS_PER_BREAKPOINT];
 	int ccount;	/* condition count */
 	int hits;	/* how many times breakpoint hit */
+	bool anchored;	/* can match only when PC == anchor */
+	Uint32 anchor;
 } bc_breakpoint_t;
 
 static bc_breakpoint_t BreakPointsCpu[BC_MAX_CONDITION_BREAKPOINTS];
@@ -109,6 +113,10 @@ static bc_breakpoint_t BreakPointsDsp[BC_MAX_CONDITION_BREAKPOINTS];
 static int BreakPointCpuCount;
 static int BreakPointDspCount;
 
+/* hashed PCs of anchored CPU breakpoints, checked by the CPU core */
+Uint32 BreakCond_CpuPcFilter[BC_PC_FILTER_SIZE/32];
+bool BreakCond_CpuAnyPc;
+
 
 /* forward declarations */
 static bool BreakCond_Remove(int position, bool bForDsp);
@@ -232,6 +240,24 @@ static Uint32 BreakCond_GetValue(const bc_value_t *bc_value)
 	return (value & bc_value->mask);
 }
 
+/* Accessors for the direct value types, selected by BreakCond_Compile() */
+static Uint32 BreakCond_GetNumber(const bc_value_t *bc_value)
+{
+	return bc_value->value.number & bc_value->mask;
+}
+static Uint32 BreakCond_GetFunction32(const bc_value_t *bc_value)
+{
+	return bc_value->value.func32() & bc_value->mask;
+}
+static Uint32 BreakCond_GetReg16(const bc_value_t *bc_value)
+{
+	return *(bc_value->value.reg16) & bc_value->mask;
+}
+static Uint32 BreakCond_GetReg32(const bc_value_t *bc_value)
+{
+	return *(bc_value->value.reg32) & bc_value->mask;
+}
+
 
 /**
  * Return true if all of the given breakpoint's conditions match
@@ -244,8 +270,8 @@ static bool BreakCond_MatchConditions(const bc_condition_t *condition, int count
 	
 	for (i = 0; i < count; condition++, i++) {
 
-		lvalue = BreakCond_GetValue(&(condition->lvalue));
-		rvalue = BreakCond_GetValue(&(condition->rvalue));
+		lvalue = condition->lvalue.get(&(condition->lvalue));
+		rvalue = condition->rvalue.get(&(condition->rvalue));
 
 		switch (condition->comparison) {
 		case '<':
@@ -313,11 +339,14 @@ static void BreakCond_ShowTracked(bc_condition_t *condition, int count)
  * Return which of the given condition breakpoints match
  * or zero if none matched
  */
-static int BreakCond_MatchBreakPoints(bc_breakpoint_t *bp, int count, const char *name)
+static int BreakCond_MatchBreakPoints(bc_breakpoint_t *bp, int count, Uint32 pc, const char *name)
 {
 	int i;
 	
 	for (i = 0; i < count; bp++, i++) {
+		if (bp->anchored && bp->anchor != pc) {
+			continue;
+		}
 		if (BreakCond_MatchConditions(bp->conditions, bp->ccount)) {
 			BreakCond_ShowTracked(bp->conditions, bp->ccount);
 			bp->hits++;
@@ -358,7 +387,7 @@ static int BreakCond_MatchBreakPoints(bc_breakpoint_t *bp, int count, const char
  */
 int BreakCond_MatchCpu(void)
 {
-	return BreakCond_MatchBreakPoints(BreakPointsCpu, BreakPointCpuCount, "CPU");
+	return BreakCond_MatchBreakPoints(BreakPointsCpu, BreakPointCpuCount, M68000_GetPC(), "CPU");
 }
 
 /**
@@ -366,7 +395,7 @@ int BreakCond_MatchCpu(void)
  */
 int BreakCond_MatchDsp(void)
 {
-	return BreakCond_MatchBreakPoints(BreakPointsDsp, BreakPointDspCount, "DSP");
+	return BreakCond_MatchBreakPoints(BreakPointsDsp, BreakPointDspCount, 0, "DSP");
 }
 
 /**
@@ -1294,6 +1323,111 @@ static void BreakCond_CheckTracking(bc_breakpoint_t *bp)
 }
 
 
+/**
+ * Select the accessor for given value so that matching doesn't
+ * need to go through the generic BreakCond_GetValue().
+ */
+static void BreakCond_CompileValue(bc_value_t *bc_value)
+{
+	if (bc_value->is_indirect) {
+		bc_value->get = BreakCond_GetValue;
+		return;
+	}
+	switch (bc_value->valuetype) {
+	case VALUE_TYPE_NUMBER:
+		bc_value->get = BreakCond_GetNumber;
+		break;
+	case VALUE_TYPE_FUNCTION32:
+		bc_value->get = BreakCond_GetFunction32;
+		break;
+	case VALUE_TYPE_REG16:
+		bc_value->get = BreakCond_GetReg16;
+		break;
+	case VALUE_TYPE_VAR32:
+	case VALUE_TYPE_REG32:
+		bc_value->get = BreakCond_GetReg32;
+		break;
+	default:
+		bc_value->get = BreakCond_GetValue;
+	}
+}
+
+/**
+ * Return true if given value is the plain CPU PC register
+ */
+static bool BreakCond_IsCpuPC(const bc_value_t *bc_value)
+{
+	return (!bc_value->is_indirect &&
+		bc_value->valuetype == VALUE_TYPE_FUNCTION32 &&
+		bc_value->value.func32 == GetCpuPC &&
+		bc_value->mask == BITMASK(32));
+}
+
+/**
+ * Return true if given value is a constant number
+ */
+static bool BreakCond_IsConstant(const bc_value_t *bc_value)
+{
+	return (!bc_value->is_indirect &&
+		bc_value->valuetype == VALUE_TYPE_NUMBER);
+}
+
+/**
+ * Prepare the breakpoints of given list for matching: select value
+ * accessors and, for the CPU, anchor breakpoints that have a "pc = <number>"
+ * condition to that address.  The CPU core checks the hashed anchors
+ * and calls BreakCond_MatchCpu() only for PCs that can match.
+ */
+static void BreakCond_Compile(bool bForDsp)
+{
+	bc_condition_t *condition;
+	bc_breakpoint_t *bp;
+	int i, j, count;
+	Uint32 hash;
+
+	if (bForDsp) {
+		bp = BreakPointsDsp;
+		count = BreakPointDspCount;
+	} else {
+		bp = BreakPointsCpu;
+		count = BreakPointCpuCount;
+		memset(BreakCond_CpuPcFilter, 0, sizeof(BreakCond_CpuPcFilter));
+		BreakCond_CpuAnyPc = false;
+	}
+	for (i = 0; i < count; bp++, i++) {
+		bp->anchored = false;
+		condition = bp->conditions;
+		for (j = 0; j < bp->ccount; condition++, j++) {
+			BreakCond_CompileValue(&(condition->lvalue));
+			BreakCond_CompileValue(&(condition->rvalue));
+
+			if (bForDsp || bp->anchored ||
+			    condition->comparison != '=' || condition->track) {
+				continue;
+			}
+			if (BreakCond_IsCpuPC(&(condition->lvalue)) &&
+			    BreakCond_IsConstant(&(condition->rvalue))) {
+				bp->anchor = condition->rvalue.value.number & condition->rvalue.mask;
+				bp->anchored = true;
+			} else if (BreakCond_IsCpuPC(&(condition->rvalue)) &&
+				   BreakCond_IsConstant(&(condition->lvalue))) {
+				bp->anchor = condition->lvalue.value.number & condition->lvalue.mask;
+				bp->anchored = true;
+			}
+		}
+		if (bForDsp) {
+			continue;
+		}
+		if (bp->anchored) {
+			hash = BC_PC_FILTER_HASH(bp->anchor);
+			BreakCond_CpuPcFilter[hash >> 5] |= 1u << (hash & 31);
+		} else {
+			BreakCond_CpuAnyPc = true;
+		}
+	}
+}
+
+
 /**
  * Parse given breakpoint expression and store it.
  * Return true for success and false for failure.
@@ -1332,6 +1466,7 @@ static bool BreakCond_Parse(const char *expression, bc_options_t *options, bool
 		fprintf(stderr, "%s condition breakpoint %d with %d condition(s) added:\n\t%s\n",
 			name, *bcount, ccount, bp->expression);
 		BreakCond_CheckTracking(bp);
+		BreakCond_Compile(bForDsp);
 		if (options->skip) {
             fprintf(stderr, "-> Break only on every %d hit.\n", options->skip);
             bp->options.skip = options->skip;
@@ -1461,6 +1596,7 @@ static bool BreakCond_Remove(int position, bool bForDsp)
 			(*bcount-position)*sizeof(bc_breakpoint_t));
 	}
 	(*bcount)--;
+	BreakCond_Compile(bForDsp);
 	return true;
 }
 
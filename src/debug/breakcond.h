@@ -20,6 +20,22 @@ extern bool BreakCond_GetHatariVariable(const char *name, Uint32 *value);
 extern const char BreakCond_Description[];
 extern const char BreakAddr_Description[];
 
+/* for the CPU core: PCs of "pc = <address>" breakpoints are hashed
+ * into a bitmap, other conditions need to be checked at any PC
+ */
+#define BC_PC_FILTER_SIZE 4096
+#define BC_PC_FILTER_HASH(pc) (((pc) >> 1) & (BC_PC_FILTER_SIZE-1))
+
+extern Uint32 BreakCond_CpuPcFilter[BC_PC_FILTER_SIZE/32];
+extern bool BreakCond_CpuAnyPc;
+
+static inline bool BreakCond_CpuPcMayMatch(Uint32 pc)
+{
+	Uint32 hash = BC_PC_FILTER_HASH(pc);
+	return BreakCond_CpuAnyPc ||
+		(BreakCond_CpuPcFilter[hash >> 5] & (1u << (hash & 31)));
+}
+
 extern int BreakCond_MatchCpu(void);
 extern int BreakCond_MatchDsp(void);
 extern int BreakCond_BreakPointCount(bool bForDsp);
@@ -522,7 +522,7 @@ void DebugCpu_Check(void)
 	{
 		DebugCpu_ShowAddressInfo(M68000_GetPC());
 	}
-	if (nCpuActiveCBs)
+	if (nCpuActiveCBs && BreakCond_CpuPcMayMatch(M68000_GetPC()))
 	{
 		if (BreakCond_MatchCpu())
 			DebugUI();
@@ -543,6 +543,7 @@ void DebugCpu_Check(void)
 void DebugCpu_SetDebugging(void)
 {
     bCpuProfiling = Profile_CpuStart();
+    Profile_I860Start();
 	nCpuActiveCBs = BreakCond_BreakPointCount(false);
     
 	if (nCpuActiveCBs || nCpuSteps || bCpuProfiling)
@@ -653,4 +654,5 @@ void DebugCpu_InitSession(void)
 {
 	disasm_addr = M68000_GetPC();
     Profile_CpuStop();
+    Profile_I860Stop();
 }
@@ -27,6 +27,7 @@ const char Log_fileid[] = "Hatari log.c : " __DATE__ " " __TIME__;
 #include "log.h"
 #include "screen.h"
 #include "file.h"
+#include "tracebuf.h"
 
 
 static struct {
@@ -99,6 +100,8 @@ TraceOptions[] = {
     { TRACE_DSP_STATE	 , "dsp_state" },
     { TRACE_DSP_ALL		 , "dsp_all" },
 
+	{ TRACE_I860_DISASM	 , "i860_disasm" },
+
 	{ TRACE_ALL		 , "all" }
 };
 
@@ -107,7 +110,7 @@ Uint64	LogTraceFlags = TRACE_NONE;
 FILE *TraceFile = NULL;
 
 static FILE *hLogFile = NULL;
-static LOGTYPE TextLogLevel;
+LOGTYPE LogTextLevel;
 static LOGTYPE AlertDlgLogLevel;
 
 /*-----------------------------------------------------------------------*/
@@ -118,11 +121,12 @@ static LOGTYPE AlertDlgLogLevel;
  */
 int Log_Init(void)
 {
-	TextLogLevel = ConfigureParams.Log.nTextLogLevel;
+	LogTextLevel = ConfigureParams.Log.nTextLogLevel;
 	AlertDlgLogLevel = ConfigureParams.Log.nAlertDlgLogLevel;
 
 	hLogFile = File_Open(ConfigureParams.Log.sLogFileName, "w");
 	TraceFile = File_Open(ConfigureParams.Log.sTraceFileName, "w");
+	TraceBuf_Init(ConfigureParams.Log.sTraceBinFileName);
    
 	return (hLogFile && TraceFile);
 }
@@ -146,6 +150,7 @@ int Log_SetAlertLevel(int level)
  */
 void Log_UnInit(void)
 {
+	TraceBuf_UnInit();
 	hLogFile = File_Close(hLogFile);
 	TraceFile = File_Close(TraceFile);
 }
@@ -153,13 +158,14 @@ void Log_UnInit(void)
 
 /*-----------------------------------------------------------------------*/
 /**
- * Output string to log file
+ * Output string to log file (the Log_Printf macro in log.h checks
+ * the level before calling this)
  */
-void Log_Printf(LOGTYPE nType, const char *psFormat, ...)
+void (Log_Printf)(LOGTYPE nType, const char *psFormat, ...)
 {
 	va_list argptr;
 
-	if (hLogFile && nType <= TextLogLevel)
+	if (hLogFile && nType <= LogTextLevel)
 	{
 		va_start(argptr, psFormat);
 		vfprintf(hLogFile, psFormat, argptr);
@@ -180,7 +186,7 @@ void Log_AlertDlg(LOGTYPE nType, const char *psFormat, ...)
 	va_list argptr;
 
 	/* Output to log file: */
-	if (hLogFile && nType <= TextLogLevel)
+	if (hLogFile && nType <= LogTextLevel)
 	{
 		va_start(argptr, psFormat);
 		vfprintf(hLogFile, psFormat, argptr);
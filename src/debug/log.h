@@ -49,6 +49,28 @@ extern char *Log_MatchTrace(const char *text, int state);
 #undef __attribute__
 #endif
 
+#include "config.h"
+
+/* Log_Printf() checks the level at the call site, so the arguments of
+ * messages that are not logged are not evaluated and no call is made.
+ * Debug level messages are compiled in only with ENABLE_DEBUG_LOG.
+ */
+extern LOGTYPE LogTextLevel;
+
+#if ENABLE_DEBUG_LOG
+#define LOG_COMPILED_LEVEL	LOG_DEBUG
+#else
+#define LOG_COMPILED_LEVEL	LOG_TODO
+#endif
+
+#define LOG_LEVEL_ENABLED(level) \
+	((level) <= LOG_COMPILED_LEVEL && (level) <= LogTextLevel)
+
+#ifndef _VCWIN_
+#define Log_Printf(level, args...) \
+	do { if (LOG_LEVEL_ENABLED(level)) (Log_Printf)(level, args); } while (0)
+#endif
+
 
 
 /* Tracing
@@ -61,7 +83,6 @@ extern char *Log_MatchTrace(const char *text, int state);
  * Tracing can be enabled by defining ENABLE_TRACING
  * in the top level config.h
  */
-#include "config.h"
 
 /* Up to 64 levels when using Uint32 for HatariTraceFlags */
 #define	TRACE_VIDEO_SYNC	 (1<<0)
@@ -119,6 +140,8 @@ extern char *Log_MatchTrace(const char *text, int state);
 #define TRACE_DSP_STATE		 (1ll<<40)
 #define TRACE_DSP_INTERRUPT	 (1ll<<41)
 
+#define TRACE_I860_DISASM	 (1ll<<42)
+
 #define	TRACE_NONE		 (0)
 #define	TRACE_ALL		 (~0)
 
@@ -150,11 +173,16 @@ extern char *Log_MatchTrace(const char *text, int state);
 extern FILE *TraceFile;
 extern Uint64 LogTraceFlags;
 
+/* Binary tracing (tracebuf.c) */
+extern bool bTraceBufEnabled;
+extern void TraceBuf_Printf(const char *format, ...);
+
 #if ENABLE_TRACING
 
 #ifndef _VCWIN_
 #define	LOG_TRACE(level, args...) \
-	if (unlikely(LogTraceFlags & level)) fprintf(TraceFile, args)
+	if (unlikely(LogTraceFlags & level)) \
+		bTraceBufEnabled ? TraceBuf_Printf(args) : (void)fprintf(TraceFile, args)
 #endif
 #define LOG_TRACE_LEVEL( level )	(unlikely(LogTraceFlags & level))
 
@@ -172,7 +200,8 @@ extern Uint64 LogTraceFlags;
  * is disabled.
  */
 #ifndef _VCWIN_
-#define LOG_TRACE_PRINT(args...)	fprintf(TraceFile , args)
+#define LOG_TRACE_PRINT(args...) \
+	(bTraceBufEnabled ? TraceBuf_Printf(args) : (void)fprintf(TraceFile , args))
 #endif
 
 
@@ -6,7 +6,7 @@
  * This file is distributed under the GNU Public License, version 2 or at
  * your option any later version. Read the file gpl.txt for details.
  *
- * profile.c - functions for profiling CPU and DSP and showing the results.
+ * profile.c - functions for profiling CPU, DSP and i860 and showing the results.
  */
 const char Profile_fileid[] = "Hatari profile.c : " __DATE__ " " __TIME__;
 
@@ -17,6 +17,7 @@ const char Profile_fileid[] = "Hatari profile.c : " __DATE__ " " __TIME__;
 #include "profile.h"
 #include "nextMemory.h"
 #include "symbols.h"
+#include "evaluate.h"
 
 #define MAX_PROFILE_VALUE 0xFFFFFFFF
 
@@ -56,6 +57,43 @@ static struct {
 } dsp_profile;
 
 
+/* i860 code can be anywhere in its 4GB address space, so profile
+ * data is allocated in 64KB pages as addresses get executed.
+ */
+#define I860_PROFILE_PAGE_BITS 16
+#define I860_PROFILE_PAGES     (1 << (32 - I860_PROFILE_PAGE_BITS))
+#define I860_PROFILE_PAGE_SIZE (1 << (I860_PROFILE_PAGE_BITS - 2))
+
+typedef struct {
+	Uint32 count;	/* how many times this address is executed */
+	Uint32 cycles;	/* estimated cycles, including stalls */
+	Uint32 dual;	/* executions in dual instruction mode */
+	Uint32 stalls;	/* estimated load interlock freeze cycles */
+} i860_profile_item_t;
+
+typedef struct {
+	const char *name;
+	Uint32 lowest, highest;	/* address range */
+} i860_profile_range_t;
+
+static const i860_profile_range_t i860_profile_ranges[] = {
+	{ "ND DRAM", 0xF8000000, 0xFBFFFFFF },
+	{ "ND VRAM", 0xFE000000, 0xFE3FFFFF },
+	{ "ND ROM",  0xFFFE0000, 0xFFFFFFFF }
+};
+
+static struct {
+	i860_profile_item_t *page[I860_PROFILE_PAGES];
+	Uint32 *sort_arr;     /* active addresses used for sorting */
+	Uint32 active;        /* number of active addresses */
+	unsigned long long all_cycles, all_count;
+	int load_reg;         /* destination of previous load or -1 */
+	bool enabled;         /* true when profiling enabled */
+} i860_profile;
+
+bool bI860Profiling;          /* true while i860 profile data is collected */
+
+
 /* ------------------ CPU profile results ----------------- */
 
 /**
@@ -783,6 +821,314 @@ void Profile_DspStop(void)
 }
 
 
+/* ------------------ i860 profile results ----------------- */
+
+/**
+ * Return i860 profile data item for given address or NULL.
+ */
+static i860_profile_item_t *i860_profile_item(Uint32 addr)
+{
+	i860_profile_item_t *page = i860_profile.page[addr >> I860_PROFILE_PAGE_BITS];
+	if (!page) {
+		return NULL;
+	}
+	return page + ((addr & ((1 << I860_PROFILE_PAGE_BITS) - 1)) >> 2);
+}
+
+/**
+ * Show i860 profile statistics for given address range.
+ */
+static void show_i860_range_stats(const char *name, Uint32 lowest, Uint32 highest)
+{
+	unsigned long long count = 0, cycles = 0, dual = 0, stalls = 0;
+	Uint32 *sort_arr, *end, addr, active = 0;
+	Uint32 max_cycles = 0, max_cycles_addr = 0;
+	i860_profile_item_t *item;
+
+	sort_arr = i860_profile.sort_arr;
+	for (end = sort_arr + i860_profile.active; sort_arr < end; sort_arr++) {
+		addr = *sort_arr;
+		if (addr < lowest || addr > highest) {
+			continue;
+		}
+		item = i860_profile_item(addr);
+		count += item->count;
+		cycles += item->cycles;
+		dual += item->dual;
+		stalls += item->stalls;
+		if (item->cycles > max_cycles) {
+			max_cycles = item->cycles;
+			max_cycles_addr = addr;
+		}
+		active++;
+	}
+	fprintf(stderr, "%s (0x%08x-0x%08x):\n", name, lowest, highest);
+	if (!active) {
+		fprintf(stderr, "- no activity\n");
+		return;
+	}
+	fprintf(stderr, "- active instruction addresses:\n  %d (%.2f%% of all)\n",
+		active, (float)active/i860_profile.active*100);
+	fprintf(stderr, "- executed instructions:\n  %llu (%.2f%% of all)\n",
+		count, (float)count/i860_profile.all_count*100);
+	fprintf(stderr, "- estimated cycles:\n  %llu (%.2f%% of all)\n",
+		cycles, (float)cycles/i860_profile.all_cycles*100);
+	fprintf(stderr, "- in dual instruction mode:\n  %llu (%.2f%% of instructions)\n",
+		dual, (float)dual/count*100);
+	fprintf(stderr, "- load interlock stalls:\n  %llu (%.2f%% of cycles)\n",
+		stalls, (float)stalls/cycles*100);
+	fprintf(stderr, "- address with most cycles:\n  0x%08x, %d cycles (%.2f%% of all in range)\n",
+		max_cycles_addr, max_cycles, (float)max_cycles/cycles*100);
+}
+
+/**
+ * Show i860 profile statistics for the board memory areas.
+ */
+void Profile_I860ShowStats(void)
+{
+	int i;
+
+	if (!i860_profile.sort_arr) {
+		fprintf(stderr, "ERROR: no i860 profiling data available!\n");
+		return;
+	}
+	for (i = 0; i < (int)ARRAYSIZE(i860_profile_ranges); i++) {
+		show_i860_range_stats(i860_profile_ranges[i].name,
+				      i860_profile_ranges[i].lowest,
+				      i860_profile_ranges[i].highest);
+	}
+}
+
+/**
+ * Show i860 profile statistics for given address range expression.
+ */
+void Profile_I860ShowRange(char *range)
+{
+	Uint32 lowest, highest;
+
+	if (!i860_profile.sort_arr) {
+		fprintf(stderr, "ERROR: no i860 profiling data available!\n");
+		return;
+	}
+	switch (Eval_Range(range, &lowest, &highest, false)) {
+	case -1:
+		fprintf(stderr, "ERROR: invalid address range '%s'!\n", range);
+		return;
+	case 0:
+		highest = lowest;
+		break;
+	}
+	show_i860_range_stats("Address range", lowest, highest);
+}
+
+/**
+ * compare function for qsort() to sort i860 profile data by descending
+ * address cycles counts.
+ */
+static int profile_by_i860_cycles(const void *p1, const void *p2)
+{
+	Uint32 count1 = i860_profile_item(*(const Uint32*)p1)->cycles;
+	Uint32 count2 = i860_profile_item(*(const Uint32*)p2)->cycles;
+	if (count1 > count2) {
+		return -1;
+	}
+	if (count1 < count2) {
+		return 1;
+	}
+	return 0;
+}
+
+/**
+ * compare function for qsort() to sort i860 profile data by descending
+ * address access counts.
+ */
+static int profile_by_i860_count(const void *p1, const void *p2)
+{
+	Uint32 count1 = i860_profile_item(*(const Uint32*)p1)->count;
+	Uint32 count2 = i860_profile_item(*(const Uint32*)p2)->count;
+	if (count1 > count2) {
+		return -1;
+	}
+	if (count1 < count2) {
+		return 1;
+	}
+	return 0;
+}
+
+/**
+ * Sort i860 profile data addresses by cycles or counts and show the
+ * results with dual instruction mode and stall counts.
+ */
+void Profile_I860ShowCounts(unsigned int show, bool by_cycles)
+{
+	Uint32 *sort_arr, *end, addr, active;
+	i860_profile_item_t *item;
+
+	if (!i860_profile.sort_arr) {
+		fprintf(stderr, "ERROR: no i860 profiling data available!\n");
+		return;
+	}
+	active = i860_profile.active;
+	sort_arr = i860_profile.sort_arr;
+	qsort(sort_arr, active, sizeof(*sort_arr),
+	      by_cycles ? profile_by_i860_cycles : profile_by_i860_count);
+
+	printf("addr:		cycles:			count:		dual:	stalls:\n");
+	show = (show < active ? show : active);
+	for (end = sort_arr + show; sort_arr < end; sort_arr++) {
+		addr = *sort_arr;
+		item = i860_profile_item(addr);
+		printf("0x%08x	%.2f%%	%d		%d		%d	%d%s\n", addr,
+		       100.0*item->cycles/i860_profile.all_cycles, item->cycles,
+		       item->count, item->dual, item->stalls,
+		       item->cycles == MAX_PROFILE_VALUE ? " (OVERFLOW)" : "");
+	}
+	printf("%d i860 addresses listed.\n", show);
+}
+
+
+/* ------------------ i860 profile control ----------------- */
+
+/**
+ * Initialize i860 profiling when necessary.  Return true if profiling.
+ */
+bool Profile_I860Start(void)
+{
+	int i;
+
+	if (i860_profile.sort_arr) {
+		/* remove previous results */
+		free(i860_profile.sort_arr);
+		i860_profile.sort_arr = NULL;
+		for (i = 0; i < I860_PROFILE_PAGES; i++) {
+			free(i860_profile.page[i]);
+			i860_profile.page[i] = NULL;
+		}
+		printf("Freed previous i860 profile buffers.\n");
+	}
+	i860_profile.load_reg = -1;
+	bI860Profiling = i860_profile.enabled;
+	return bI860Profiling;
+}
+
+/**
+ * Update i860 statistics for the instruction at given address.
+ *
+ * The i860 core doesn't emulate timing, so cycles are estimated: one
+ * per instruction, none for the core half of a dual instruction mode
+ * pair, and one extra freeze cycle when an instruction uses the
+ * destination register of the preceding (integer or FP) load.
+ */
+void Profile_I860Update(Uint32 pc, Uint32 insn, int dual)
+{
+	i860_profile_item_t *page, *item;
+	int op = (insn >> 26) & 0x3f;
+	Uint32 cycles, stall = 0;
+
+	page = i860_profile.page[pc >> I860_PROFILE_PAGE_BITS];
+	if (unlikely(!page)) {
+		page = calloc(I860_PROFILE_PAGE_SIZE, sizeof(*page));
+		if (!page) {
+			return;
+		}
+		i860_profile.page[pc >> I860_PROFILE_PAGE_BITS] = page;
+	}
+	item = page + ((pc & ((1 << I860_PROFILE_PAGE_BITS) - 1)) >> 2);
+
+	/* integer load result used by core instruction,
+	 * FP load result (register + 32) used by FP instruction
+	 */
+	if (i860_profile.load_reg >= 0 && (i860_profile.load_reg & 0x1f)) {
+		Uint32 reg = i860_profile.load_reg & 0x1f;
+		bool fp = i860_profile.load_reg >= 32;
+		if (fp == (op == 0x12) &&
+		    (((insn >> 11) & 0x1f) == reg || ((insn >> 21) & 0x1f) == reg)) {
+			stall = 1;
+		}
+	}
+	switch (op) {
+	case 0x00: case 0x01: case 0x04: case 0x05:	/* ld.x */
+		i860_profile.load_reg = (insn >> 16) & 0x1f;
+		break;
+	case 0x08: case 0x09:				/* fld.x */
+		i860_profile.load_reg = 32 + ((insn >> 16) & 0x1f);
+		break;
+	default:
+		i860_profile.load_reg = -1;
+	}
+
+	cycles = ((dual && (pc & 4)) ? 0 : 1) + stall;
+
+	if (likely(item->count < MAX_PROFILE_VALUE)) {
+		item->count++;
+		if (dual) {
+			item->dual++;
+		}
+	}
+	if (likely(item->cycles < MAX_PROFILE_VALUE - cycles)) {
+		item->cycles += cycles;
+		item->stalls += stall;
+	}
+}
+
+/**
+ * Stop and process the i860 profiling data; collect the active
+ * addresses for sorting.
+ */
+void Profile_I860Stop(void)
+{
+	i860_profile_item_t *item;
+	Uint32 *sort_arr;
+	Uint32 i, j, active;
+
+	if (!bI860Profiling) {
+		return;
+	}
+	bI860Profiling = false;
+
+	i860_profile.all_count = i860_profile.all_cycles = 0;
+	active = 0;
+	for (i = 0; i < I860_PROFILE_PAGES; i++) {
+		if (!(item = i860_profile.page[i])) {
+			continue;
+		}
+		for (j = 0; j < I860_PROFILE_PAGE_SIZE; j++, item++) {
+			if (item->count) {
+				i860_profile.all_count += item->count;
+				i860_profile.all_cycles += item->cycles;
+				active++;
+			}
+		}
+	}
+
+	/* allocate address array for sorting (at least one item so
+	 * that profile data is marked as available)
+	 */
+	sort_arr = calloc(active+1, sizeof(*sort_arr));
+	if (!sort_arr) {
+		perror("ERROR: allocating i860 profile address data");
+		return;
+	}
+	printf("Allocated i860 profile address buffer (%d KB).\n",
+	       (int)sizeof(*sort_arr)*(active+1)/1024);
+	i860_profile.sort_arr = sort_arr;
+	i860_profile.active = active;
+
+	for (i = 0; i < I860_PROFILE_PAGES; i++) {
+		if (!(item = i860_profile.page[i])) {
+			continue;
+		}
+		for (j = 0; j < I860_PROFILE_PAGE_SIZE; j++, item++) {
+			if (item->count) {
+				*sort_arr++ = (i << I860_PROFILE_PAGE_BITS) | (j << 2);
+			}
+		}
+	}
+
+	Profile_I860ShowStats();
+}
+
+
 /* ------------------- command parsing ---------------------- */
 
 /**
@@ -793,7 +1139,7 @@ void Profile_DspStop(void)
 char *Profile_Match(const char *text, int state)
 {
 	static const char *names[] = {
-		"on", "off", "counts", "cycles", "symbols", "stats"
+		"on", "off", "counts", "cycles", "symbols", "stats", "i860", "range"
 	};
 	static int i, len;
 	
@@ -817,7 +1163,44 @@ const char Profile_Description[] =
 	  "\tuntil debugger is entered again after which you can view\n"
 	  "\tstatistics about the data or view PC addresses that took\n"
 	  "\tmost cycles or functions/symbols called most often.\n"
-	  "\tYou can specify how many items are shown at most.";
+	  "\tYou can specify how many items are shown at most.\n"
+	  "\n"
+	  "\tWith 'i860 <on|off|counts|cycles|stats>' the same is done\n"
+	  "\tfor the NeXTdimension i860, showing also executions in dual\n"
+	  "\tinstruction mode and estimated load stalls per address.\n"
+	  "\t'i860 range <start>-<end>' shows statistics for an address\n"
+	  "\trange, e.g. a function.";
+
+
+/**
+ * Command: i860 profiling, subcommand arguments start at psArgs[1].
+ */
+static bool Profile_I860Command(int nArgc, char *psArgs[], int show)
+{
+	if (nArgc < 2) {
+		DebugUI_PrintCmdHelp("profile");
+		return false;
+	}
+	if (strcmp(psArgs[1], "on") == 0) {
+		i860_profile.enabled = true;
+		fprintf(stderr, "i860 profiling enabled.\n");
+	} else if (strcmp(psArgs[1], "off") == 0) {
+		i860_profile.enabled = false;
+		fprintf(stderr, "i860 profiling disabled.\n");
+	} else if (strcmp(psArgs[1], "stats") == 0) {
+		Profile_I860ShowStats();
+	} else if (strcmp(psArgs[1], "cycles") == 0) {
+		Profile_I860ShowCounts(show, true);
+	} else if (strcmp(psArgs[1], "counts") == 0) {
+		Profile_I860ShowCounts(show, false);
+	} else if (strcmp(psArgs[1], "range") == 0 && nArgc > 2) {
+		Profile_I860ShowRange(psArgs[2]);
+	} else {
+		DebugUI_PrintCmdHelp("profile");
+		return false;
+	}
+	return true;
+}
 
 
 /**
@@ -833,6 +1216,12 @@ bool Profile_Command(int nArgc, char *psArgs[], bool bForDsp)
 		DebugUI_PrintCmdHelp(psArgs[0]);
 		return true;
 	}
+	if (strcmp(psArgs[1], "i860") == 0) {
+		if (nArgc > 3 && strcmp(psArgs[2], "range") != 0) {
+			show = atoi(psArgs[3]);
+		}
+		return Profile_I860Command(nArgc-1, psArgs+1, show);
+	}
 	if (nArgc > 2) {
 		show = atoi(psArgs[2]);
 	}
@@ -33,4 +33,14 @@ extern void Profile_DspShowCycles(unsigned int show);
 extern void Profile_DspShowCounts(unsigned int show, bool only_symbols);
 extern bool Profile_DspAddressData(Uint16 addr, Uint32 *count, Uint32 *cycles);
 
+/* i860 profile control */
+extern bool bI860Profiling;
+extern bool Profile_I860Start(void);
+extern void Profile_I860Update(Uint32 pc, Uint32 insn, int dual);
+extern void Profile_I860Stop(void);
+/* i860 profile results */
+extern void Profile_I860ShowStats(void);
+extern void Profile_I860ShowRange(char *range);
+extern void Profile_I860ShowCounts(unsigned int show, bool by_cycles);
+
 #endif
@@ -0,0 +1,580 @@
+/*
+ * Hatari - tracebuf.c
+ *
+ * This file is distributed under the GNU Public License, version 2 or at
+ * your option any later version. Read the file gpl.txt for details.
+ *
+ * Binary tracing. Instead of formatting every trace message with fprintf,
+ * the trace points store fixed size records (emulated cycle time stamp,
+ * event id and raw arguments) in a lock-free ring buffer owned by the
+ * calling thread. A background thread writes the rings to the trace file,
+ * which is turned back into text by the offline decoder (tracedec).
+ *
+ * Format strings (and string arguments) are not copied into each record:
+ * they get an id and their text is stored once per thread in a
+ * TRACEBUF_EV_STRING record. String arguments therefore have to be
+ * constant strings. When a ring is full, records are dropped and counted
+ * instead of stalling the emulation.
+ */
+const char TraceBuf_fileid[] = "Hatari tracebuf.c : " __DATE__ " " __TIME__;
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <SDL.h>
+
+#include "main.h"
+#include "m68000.h"
+#include "video.h"
+#include "log.h"
+#include "tracebuf.h"
+
+#define TRACEBUF_RING_SIZE	(1<<16)		/* records per thread, power of two */
+#define TRACEBUF_RING_MASK	(TRACEBUF_RING_SIZE-1)
+#define TRACEBUF_WAKEUP		(TRACEBUF_RING_SIZE/4)
+#define TRACEBUF_MAX_THREADS	8
+#define TRACEBUF_CACHE_SIZE	256		/* string ids cached per thread */
+#define TRACEBUF_CACHE_HASH(p)	((((uintptr_t)(p)) >> 3) & (TRACEBUF_CACHE_SIZE-1))
+#define TRACEBUF_MAX_STRING	255
+
+typedef struct {
+	const char *str;
+	Uint32 id;
+	int count;			/* number of format arguments */
+	char types[TRACEBUF_ARGS];	/* format argument types */
+} tracebuf_string_t;
+
+typedef struct {
+	TRACEBUF_RECORD *rec;
+	SDL_atomic_t head;		/* written by the producer */
+	SDL_atomic_t tail;		/* written by the writer thread */
+	Uint32 head_local;		/* producer copy of head */
+	Uint32 tail_cache;		/* last tail seen by the producer */
+	Uint32 dropped;
+	int thread;
+	tracebuf_string_t cache[TRACEBUF_CACHE_SIZE];
+} tracebuf_ring_t;
+
+bool bTraceBufEnabled = false;
+
+static FILE *TraceBufFile;
+static SDL_TLSID TraceBuf_Tls;
+static SDL_mutex *TraceBuf_Mutex;
+static SDL_sem *TraceBuf_Wakeup;
+static SDL_Thread *TraceBuf_Thread;
+static SDL_atomic_t TraceBuf_Quit;
+
+static tracebuf_ring_t *TraceBuf_Rings[TRACEBUF_MAX_THREADS];
+static SDL_atomic_t nTraceBufRings;
+
+/* Global string table (string pointer -> id), protected by TraceBuf_Mutex */
+typedef struct {
+	const char *str;
+	Uint32 id;
+} tracebuf_id_t;
+
+static tracebuf_id_t *TraceBuf_Strings;
+static Uint32 nTraceBufStringsSize;
+static Uint32 nTraceBufStrings;
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Return the ring of the calling thread, create it on first use.
+ */
+static tracebuf_ring_t *TraceBuf_GetRing(void)
+{
+	tracebuf_ring_t *ring = SDL_TLSGet(TraceBuf_Tls);
+	int n;
+
+	if (likely(ring))
+		return ring;
+
+	SDL_LockMutex(TraceBuf_Mutex);
+	n = SDL_AtomicGet(&nTraceBufRings);
+	if (n < TRACEBUF_MAX_THREADS)
+	{
+		ring = calloc(1, sizeof(*ring));
+		if (ring)
+			ring->rec = malloc(TRACEBUF_RING_SIZE * sizeof(TRACEBUF_RECORD));
+		if (ring && ring->rec)
+		{
+			ring->thread = n;
+			TraceBuf_Rings[n] = ring;
+			SDL_AtomicSet(&nTraceBufRings, n + 1);
+			SDL_TLSSet(TraceBuf_Tls, ring, NULL);
+		}
+		else
+		{
+			free(ring);
+			ring = NULL;
+		}
+	}
+	SDL_UnlockMutex(TraceBuf_Mutex);
+
+	return ring;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Reserve n consecutive records in the ring. Return false if the ring
+ * is full (the records are then dropped).
+ */
+static bool TraceBuf_Reserve(tracebuf_ring_t *ring, Uint32 n)
+{
+	if (ring->head_local - ring->tail_cache > TRACEBUF_RING_SIZE - n)
+	{
+		ring->tail_cache = SDL_AtomicGet(&ring->tail);
+		/* Don't reuse the records before the writer is done with them */
+		SDL_MemoryBarrierAcquire();
+		if (ring->head_local - ring->tail_cache > TRACEBUF_RING_SIZE - n)
+		{
+			ring->dropped += n;
+			return false;
+		}
+	}
+	return true;
+}
+
+static inline TRACEBUF_RECORD *TraceBuf_Slot(tracebuf_ring_t *ring, Uint32 i)
+{
+	return &ring->rec[(ring->head_local + i) & TRACEBUF_RING_MASK];
+}
+
+/**
+ * Publish n reserved records to the writer thread.
+ */
+static void TraceBuf_Commit(tracebuf_ring_t *ring, Uint32 n)
+{
+	ring->head_local += n;
+	/* The records have to be visible before the new head */
+	SDL_MemoryBarrierRelease();
+	SDL_AtomicSet(&ring->head, (int)ring->head_local);
+
+	/* Wake up the writer every quarter ring */
+	if ((ring->head_local & (TRACEBUF_WAKEUP-1)) < n)
+		SDL_SemPost(TraceBuf_Wakeup);
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Return the global id of a string.
+ */
+static inline Uint32 TraceBuf_Hash(const char *str)
+{
+	return (Uint32)((uintptr_t)str >> 3) * 2654435761u;
+}
+
+static Uint32 TraceBuf_StringId(const char *str)
+{
+	Uint32 i, id;
+
+	SDL_LockMutex(TraceBuf_Mutex);
+
+	if (nTraceBufStrings * 4 >= nTraceBufStringsSize * 3)
+	{
+		/* Grow and rehash */
+		tracebuf_id_t *old = TraceBuf_Strings;
+		Uint32 oldsize = nTraceBufStringsSize;
+
+		nTraceBufStringsSize = oldsize ? oldsize * 2 : 256;
+		TraceBuf_Strings = calloc(nTraceBufStringsSize, sizeof(tracebuf_id_t));
+		for (i = 0; i < oldsize; i++)
+		{
+			Uint32 j;
+			if (!old[i].str)
+				continue;
+			for (j = TraceBuf_Hash(old[i].str); TraceBuf_Strings[j & (nTraceBufStringsSize-1)].str; j++)
+				;
+			TraceBuf_Strings[j & (nTraceBufStringsSize-1)] = old[i];
+		}
+		free(old);
+	}
+
+	for (i = TraceBuf_Hash(str); ; i++)
+	{
+		i &= nTraceBufStringsSize - 1;
+		if (TraceBuf_Strings[i].str == str)
+			break;
+		if (!TraceBuf_Strings[i].str)
+		{
+			TraceBuf_Strings[i].str = str;
+			TraceBuf_Strings[i].id = nTraceBufStrings++;
+			break;
+		}
+	}
+	id = TraceBuf_Strings[i].id;
+
+	SDL_UnlockMutex(TraceBuf_Mutex);
+	return id;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Put a string into the cache of the ring and store its text in the
+ * trace. Return the cache entry or NULL if the ring is full.
+ */
+static tracebuf_string_t *TraceBuf_String(tracebuf_ring_t *ring, const char *str, bool format)
+{
+	tracebuf_string_t *entry = &ring->cache[TRACEBUF_CACHE_HASH(str)];
+	TRACEBUF_RECORD *rec;
+	Uint32 len, n, i;
+
+	if (likely(entry->str == str))
+		return entry;
+
+	len = strlen(str);
+	if (len > TRACEBUF_MAX_STRING)
+		len = TRACEBUF_MAX_STRING;
+	n = (len + sizeof(TRACEBUF_RECORD) - 1) / sizeof(TRACEBUF_RECORD);
+	if (!TraceBuf_Reserve(ring, n + 1))
+		return NULL;
+
+	entry->str = NULL;
+	entry->id = TraceBuf_StringId(str);
+	entry->count = 0;
+	if (format)
+	{
+		const char *p = str;
+		char type;
+		int stars;
+		while ((p = TraceBuf_NextConversion(p, &type, &stars)) && type)
+		{
+			while (stars-- > 0 && entry->count < TRACEBUF_ARGS)
+				entry->types[entry->count++] = 'i';
+			if (entry->count < TRACEBUF_ARGS)
+				entry->types[entry->count++] = type;
+		}
+	}
+
+	rec = TraceBuf_Slot(ring, 0);
+	rec->cycles = nCyclesClock;
+	rec->event = TRACEBUF_EV_STRING;
+	rec->thread = ring->thread;
+	rec->count = 1;
+	rec->id = entry->id;
+	rec->args[0] = len;
+	for (i = 0; i < n; i++)
+	{
+		Uint32 size = len - i * sizeof(TRACEBUF_RECORD);
+		if (size > sizeof(TRACEBUF_RECORD))
+			size = sizeof(TRACEBUF_RECORD);
+		rec = TraceBuf_Slot(ring, i + 1);
+		memset(rec, 0, sizeof(*rec));
+		memcpy(rec, str + i * sizeof(TRACEBUF_RECORD), size);
+	}
+	TraceBuf_Commit(ring, n + 1);
+
+	entry->str = str;
+	return entry;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Store one record with the given event and arguments.
+ */
+static void TraceBuf_Store(Uint16 event, Uint32 id, int count, const Uint64 *args)
+{
+	tracebuf_ring_t *ring = TraceBuf_GetRing();
+	TRACEBUF_RECORD *rec;
+
+	if (!ring || !TraceBuf_Reserve(ring, 1))
+		return;
+
+	rec = TraceBuf_Slot(ring, 0);
+	rec->cycles = nCyclesClock;
+	rec->event = event;
+	rec->thread = ring->thread;
+	rec->count = count;
+	rec->id = id;
+	memcpy(rec->args, args, sizeof(rec->args));
+	TraceBuf_Commit(ring, 1);
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Binary version of fprintf(TraceFile, format, ...) used by LOG_TRACE.
+ */
+void TraceBuf_Printf(const char *format, ...)
+{
+	tracebuf_ring_t *ring = TraceBuf_GetRing();
+	tracebuf_string_t *entry, format_entry;
+	Uint64 args[TRACEBUF_ARGS];
+	va_list ap;
+	int i;
+
+	if (!ring)
+		return;
+	entry = TraceBuf_String(ring, format, true);
+	if (!entry)
+		return;
+	/* String arguments may evict the format from the cache */
+	format_entry = *entry;
+
+	memset(args, 0, sizeof(args));
+	va_start(ap, format);
+	for (i = 0; i < format_entry.count; i++)
+	{
+		switch (format_entry.types[i])
+		{
+		 case 'i':
+			args[i] = (Uint64)(Sint64)va_arg(ap, int);
+			break;
+		 case 'l':
+			args[i] = (Uint64)(Sint64)va_arg(ap, long);
+			break;
+		 case 'L':
+			args[i] = (Uint64)va_arg(ap, long long);
+			break;
+		 case 'z':
+			args[i] = (Uint64)va_arg(ap, size_t);
+			break;
+		 case 'p':
+			args[i] = (Uint64)(uintptr_t)va_arg(ap, void *);
+			break;
+		 case 'f':
+		 {
+			double d = va_arg(ap, double);
+			memcpy(&args[i], &d, sizeof(d));
+			break;
+		 }
+		 case 's':
+		 {
+			const char *s = va_arg(ap, const char *);
+			tracebuf_string_t *str = s ? TraceBuf_String(ring, s, false) : NULL;
+			args[i] = str ? str->id : 0xFFFFFFFF;
+			break;
+		 }
+		}
+	}
+	va_end(ap);
+
+	TraceBuf_Store(TRACEBUF_EV_PRINTF, format_entry.id, format_entry.count, args);
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Store a CPU instruction record with the video position.
+ */
+static void TraceBuf_StoreCpu(Uint64 *args, int words)
+{
+	int FrameCycles, HblCounterVideo, LineCycles;
+
+	Video_GetPosition(&FrameCycles, &HblCounterVideo, &LineCycles);
+	args[4] = FrameCycles;
+	args[5] = (LineCycles << 16) | (HblCounterVideo & 0xFFFF);
+
+	TraceBuf_Store(TRACEBUF_EV_CPU_DISASM, 0, words, args);
+}
+
+/**
+ * Trace the CPU instruction at pc. The words following the opcode are
+ * only read from plain RAM/ROM banks to avoid side effects on IO.
+ */
+void TraceBuf_CpuDisasm(Uint32 pc)
+{
+	Uint64 args[TRACEBUF_ARGS];
+	int n = 1;
+
+	memset(args, 0, sizeof(args));
+	args[0] = pc;
+	args[1] = get_word(pc);
+	if (get_mem_bank(pc).flags & (ABFLAG_RAM | ABFLAG_ROM))
+	{
+		for (n = 1; n < 12 && bankindex(pc + n * 2) == bankindex(pc); n++)
+			args[1 + n / 4] |= (Uint64)get_word(pc + n * 2) << (16 * (n % 4));
+	}
+	TraceBuf_StoreCpu(args, n);
+}
+
+/**
+ * Trace a CPU instruction with MMU translation, where pc is a logical
+ * address and phys its physical address. Besides the already fetched
+ * opcode, at most 'words' words are read from phys on; the words not
+ * stored are shown as unknown by tracedec.
+ */
+void TraceBuf_CpuOpcode(Uint32 pc, Uint16 opcode, Uint32 phys, int words)
+{
+	Uint64 args[TRACEBUF_ARGS];
+	int n = 1;
+
+	memset(args, 0, sizeof(args));
+	args[0] = pc;
+	args[1] = opcode;
+	if (words > 1 && (get_mem_bank(phys).flags & (ABFLAG_RAM | ABFLAG_ROM)))
+	{
+		for (n = 1; n < 12 && n < words && bankindex(phys + n * 2) == bankindex(phys); n++)
+			args[1 + n / 4] |= (Uint64)get_word(phys + n * 2) << (16 * (n % 4));
+	}
+	TraceBuf_StoreCpu(args, n);
+}
+
+
+/**
+ * Trace a DSP instruction (after it has been executed).
+ */
+void TraceBuf_DspDisasm(Uint32 pc, Uint32 inst, Uint32 inst2, int cycles)
+{
+	Uint64 args[TRACEBUF_ARGS] = { pc, inst, inst2, cycles };
+
+	TraceBuf_Store(TRACEBUF_EV_DSP_DISASM, 0, 4, args);
+}
+
+
+/**
+ * Trace an i860 instruction.
+ */
+void TraceBuf_I860Disasm(Uint32 pc, Uint32 insn)
+{
+	Uint64 args[TRACEBUF_ARGS] = { pc, insn };
+
+	TraceBuf_Store(TRACEBUF_EV_I860_DISASM, 0, 2, args);
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Write all published records to the trace file. Return true if
+ * anything was written.
+ */
+static bool TraceBuf_Drain(void)
+{
+	int i, n = SDL_AtomicGet(&nTraceBufRings);
+	bool written = false;
+
+	for (i = 0; i < n; i++)
+	{
+		tracebuf_ring_t *ring = TraceBuf_Rings[i];
+		Uint32 tail = SDL_AtomicGet(&ring->tail);
+		Uint32 head = SDL_AtomicGet(&ring->head);
+
+		/* Read the records only after head (see TraceBuf_Commit) */
+		SDL_MemoryBarrierAcquire();
+		while (tail != head)
+		{
+			Uint32 start = tail & TRACEBUF_RING_MASK;
+			Uint32 len = head - tail;
+			if (len > TRACEBUF_RING_SIZE - start)
+				len = TRACEBUF_RING_SIZE - start;
+			fwrite(&ring->rec[start], sizeof(TRACEBUF_RECORD), len, TraceBufFile);
+			tail += len;
+			written = true;
+		}
+		SDL_MemoryBarrierRelease();
+		SDL_AtomicSet(&ring->tail, (int)tail);
+	}
+	return written;
+}
+
+/**
+ * Writer thread.
+ */
+static int TraceBuf_Writer(void *arg)
+{
+	while (!SDL_AtomicGet(&TraceBuf_Quit))
+	{
+		if (!TraceBuf_Drain())
+			SDL_SemWaitTimeout(TraceBuf_Wakeup, 10);
+	}
+	return 0;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Open the binary trace file and start the writer thread.
+ * An empty file name disables binary tracing.
+ */
+bool TraceBuf_Init(const char *filename)
+{
+	TRACEBUF_HEADER header;
+	int i;
+
+	bTraceBufEnabled = false;
+	if (!filename[0])
+		return true;
+
+	if (!TraceBuf_Mutex)
+	{
+		TraceBuf_Mutex = SDL_CreateMutex();
+		TraceBuf_Wakeup = SDL_CreateSemaphore(0);
+		TraceBuf_Tls = SDL_TLSCreate();
+	}
+	if (!TraceBuf_Mutex || !TraceBuf_Wakeup || !TraceBuf_Tls)
+	{
+		Log_Printf(LOG_WARN, "Binary tracing initialization failed: %s\n", SDL_GetError());
+		return false;
+	}
+
+	TraceBufFile = fopen(filename, "wb");
+	if (!TraceBufFile)
+	{
+		Log_Printf(LOG_WARN, "Can't open binary trace file '%s'\n", filename);
+		return false;
+	}
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, TRACEBUF_MAGIC, sizeof(header.magic));
+	header.version = TRACEBUF_VERSION;
+	header.byteorder = TRACEBUF_BYTEORDER;
+	header.recsize = sizeof(TRACEBUF_RECORD);
+	fwrite(&header, sizeof(header), 1, TraceBufFile);
+
+	/* Rings of a previous session are reused, their strings are in the old file */
+	for (i = 0; i < SDL_AtomicGet(&nTraceBufRings); i++)
+	{
+		tracebuf_ring_t *ring = TraceBuf_Rings[i];
+		ring->head_local = ring->tail_cache = ring->dropped = 0;
+		SDL_AtomicSet(&ring->head, 0);
+		SDL_AtomicSet(&ring->tail, 0);
+		memset(ring->cache, 0, sizeof(ring->cache));
+	}
+
+	SDL_AtomicSet(&TraceBuf_Quit, 0);
+	TraceBuf_Thread = SDL_CreateThread(TraceBuf_Writer, "TraceBufWriter", NULL);
+	if (!TraceBuf_Thread)
+	{
+		Log_Printf(LOG_WARN, "Can't start binary trace writer: %s\n", SDL_GetError());
+		fclose(TraceBufFile);
+		TraceBufFile = NULL;
+		return false;
+	}
+
+	bTraceBufEnabled = true;
+	return true;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Stop the writer thread, flush the rings and close the trace file.
+ */
+void TraceBuf_UnInit(void)
+{
+	Uint32 dropped = 0;
+	int i;
+
+	if (!bTraceBufEnabled)
+		return;
+	bTraceBufEnabled = false;
+
+	SDL_AtomicSet(&TraceBuf_Quit, 1);
+	SDL_SemPost(TraceBuf_Wakeup);
+	SDL_WaitThread(TraceBuf_Thread, NULL);
+	TraceBuf_Thread = NULL;
+
+	TraceBuf_Drain();
+	fclose(TraceBufFile);
+	TraceBufFile = NULL;
+
+	for (i = 0; i < SDL_AtomicGet(&nTraceBufRings); i++)
+		dropped += TraceBuf_Rings[i]->dropped;
+	if (dropped)
+		Log_Printf(LOG_WARN, "Binary tracing: %u records dropped (trace buffer full)\n", dropped);
+}
@@ -0,0 +1,111 @@
+/*
+  Hatari - tracebuf.h
+
+  This file is distributed under the GNU Public License, version 2 or at
+  your option any later version. Read the file gpl.txt for details.
+
+  Binary trace buffer: fixed size trace records, file format shared
+  with the offline decoder (tracedec).
+*/
+
+#ifndef HATARI_TRACEBUF_H
+#define HATARI_TRACEBUF_H
+
+#include <stdbool.h>
+#include <string.h>
+#include <SDL_types.h>
+
+#define TRACEBUF_MAGIC		"PRVTRACE"
+#define TRACEBUF_VERSION	1
+#define TRACEBUF_BYTEORDER	0x01020304
+#define TRACEBUF_ARGS		6
+
+/* Trace file header */
+typedef struct {
+	char magic[8];
+	Uint32 version;
+	Uint32 byteorder;	/* TRACEBUF_BYTEORDER in the writer's byte order */
+	Uint32 recsize;		/* sizeof(TRACEBUF_RECORD) */
+	Uint32 reserved;
+} TRACEBUF_HEADER;
+
+/* Events */
+enum {
+	TRACEBUF_EV_STRING,	/* id = string id, count = length, text in the following records */
+	TRACEBUF_EV_PRINTF,	/* id = format string id, args = conversions */
+	TRACEBUF_EV_CPU_DISASM,	/* args: pc, 12 opcode words (count = words), video position */
+	TRACEBUF_EV_DSP_DISASM,	/* args: pc, instruction, next word, cycles */
+	TRACEBUF_EV_I860_DISASM	/* args: pc, instruction */
+};
+
+/* One trace record, all records have the same size */
+typedef struct {
+	Uint64 cycles;		/* emulated CPU cycles (nCyclesClock) */
+	Uint16 event;		/* TRACEBUF_EV_* */
+	Uint8 thread;		/* producer thread */
+	Uint8 count;		/* number of used arguments (or bytes/words) */
+	Uint32 id;
+	Uint64 args[TRACEBUF_ARGS];
+} TRACEBUF_RECORD;
+
+/**
+ * Find the next conversion of a printf format string. Return a pointer
+ * after it or NULL when there are no more conversions. Sets type to the
+ * argument type ('i'nt, 'l'ong, 'L'ong long, si'z'e_t, 'f'loat, 'p'ointer,
+ * 's'tring or 0 for unsupported conversions) and stars to the number of
+ * additional int arguments for '*' width/precision.
+ */
+static inline const char *TraceBuf_NextConversion(const char *fmt, char *type, int *stars)
+{
+	int longs = 0;
+
+	*type = 0;
+	*stars = 0;
+	for (;;)
+	{
+		fmt = strchr(fmt, '%');
+		if (!fmt)
+			return NULL;
+		if (fmt[1] != '%')
+			break;
+		fmt += 2;
+	}
+	for (fmt++; *fmt && strchr("-+ #0123456789.*", *fmt); fmt++)
+	{
+		if (*fmt == '*')
+			(*stars)++;
+	}
+	for (; *fmt && strchr("hlzjt", *fmt); fmt++)
+	{
+		if (*fmt == 'l')
+			longs++;
+		else if (*fmt == 'z' || *fmt == 't')
+			longs = -1;
+		else if (*fmt == 'j')
+			longs = 2;
+	}
+	if (!*fmt)
+		return NULL;
+
+	if (strchr("diouxXc", *fmt))
+		*type = longs < 0 ? 'z' : longs == 1 ? 'l' : longs == 2 ? 'L' : 'i';
+	else if (strchr("eEfFgGaA", *fmt))
+		*type = 'f';
+	else if (*fmt == 'p')
+		*type = 'p';
+	else if (*fmt == 's')
+		*type = 's';
+	return fmt + 1;
+}
+
+extern bool bTraceBufEnabled;
+
+extern bool TraceBuf_Init(const char *filename);
+extern void TraceBuf_UnInit(void);
+extern void TraceBuf_Printf(const char *format, ...);
+extern void TraceBuf_CpuDisasm(Uint32 pc);
+extern void TraceBuf_CpuOpcode(Uint32 pc, Uint16 opcode, Uint32 phys, int words);
+extern void TraceBuf_DspDisasm(Uint32 pc, Uint32 inst, Uint32 inst2, int cycles);
+extern void TraceBuf_I860Disasm(Uint32 pc, Uint32 insn);
+
+#endif /* HATARI_TRACEBUF_H */
@@ -0,0 +1,396 @@
+/*
+ * Hatari - tracedec.c
+ *
+ * This file is distributed under the GNU Public License, version 2 or at
+ * your option any later version. Read the file gpl.txt for details.
+ *
+ * Offline decoder for binary traces (written with --trace-bin). Turns the
+ * trace records back into the text LOG_TRACE would have printed, with the
+ * emulated cycle count in front. CPU, DSP and i860 instructions are
+ * disassembled with the emulator's own disassemblers from the instruction
+ * words stored in the records.
+ *
+ * Usage: tracedec <trace file>
+ */
+const char TraceDec_fileid[] = "Hatari tracedec.c : " __DATE__ " " __TIME__;
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <inttypes.h>
+
+#include "config.h"
+#include "sysdeps.h"
+#include "main.h"
+#include "newcpu.h"
+#include "68kDisass.h"
+#include "dsp_core.h"
+#include "dsp_cpu.h"
+#include "dsp_disasm.h"
+#include "profile.h"
+#include "paths.h"
+#include "tracebuf.h"
+
+extern int i860_disassembler(Uint32 pc, Uint32 insn, char *buffer);
+
+static char **TraceDec_Strings;
+static Uint32 nTraceDecStrings;
+
+/* The CPU instruction being decoded */
+static Uint32 TraceDec_Pc;
+static Uint16 TraceDec_Words[12];
+static int nTraceDecWords;
+static bool bTraceDecUnknown;	/* Disassembler read a word not recorded */
+
+
+/* ------------------------------------------------------------------------
+ * Emulator symbols needed by the disassemblers
+ */
+addrbank *mem_banks[65536];
+dsp_core_t dsp_core;
+Uint32 DSP_RAMSIZE = DSP_RAMSIZE_96kB;
+
+/**
+ * Memory bank which returns the recorded instruction words.
+ */
+static uae_u32 TraceDec_wget(uaecptr addr)
+{
+	Uint32 offset = (addr - TraceDec_Pc) / 2;
+
+	if (offset < (Uint32)nTraceDecWords)
+		return TraceDec_Words[offset];
+	bTraceDecUnknown = true;
+	return 0;
+}
+
+static uae_u32 TraceDec_lget(uaecptr addr)
+{
+	return (TraceDec_wget(addr) << 16) | TraceDec_wget(addr + 2);
+}
+
+static uae_u32 TraceDec_bget(uaecptr addr)
+{
+	return (TraceDec_wget(addr & ~1) >> ((addr & 1) ? 0 : 8)) & 0xFF;
+}
+
+static void TraceDec_put(uaecptr addr, uae_u32 val)
+{
+}
+
+static addrbank TraceDec_bank =
+{
+	TraceDec_lget, TraceDec_wget, TraceDec_bget,
+	TraceDec_put, TraceDec_put, TraceDec_put,
+	TraceDec_lget, TraceDec_wget, ABFLAG_ROM
+};
+
+void m68k_disasm(FILE *f, uaecptr addr, uaecptr *nextpc, int cnt)
+{
+	Disasm(f, addr, nextpc, cnt, DISASM_ENGINE_EXT);
+}
+
+const char *Paths_GetHatariHome(void)
+{
+	return ".";
+}
+
+bool Profile_DspAddressData(Uint16 addr, Uint32 *count, Uint32 *cycles)
+{
+	return false;
+}
+
+
+/* ------------------------------------------------------------------------
+ * Decoding
+ */
+
+/* Print one conversion, with the '*' width/precision arguments */
+#define TRACEDEC_PRINT(val) \
+	do { \
+		if (stars == 0) printf(spec, val); \
+		else if (stars == 1) printf(spec, width[0], val); \
+		else printf(spec, width[0], width[1], val); \
+	} while (0)
+
+/**
+ * Print a LOG_TRACE message from its format string and the recorded arguments.
+ */
+static void TraceDec_Printf(const char *format, const TRACEBUF_RECORD *rec)
+{
+	const char *start = format, *end;
+	char spec[256], type;
+	int stars, arg = 0;
+
+	while ((end = TraceBuf_NextConversion(start, &type, &stars)) && type)
+	{
+		int width[2] = { 0, 0 }, i;
+		Uint64 val;
+
+		if (end - start >= (int)sizeof(spec) || arg + stars >= rec->count)
+			break;
+		memcpy(spec, start, end - start);
+		spec[end - start] = '\0';
+		for (i = 0; i < stars; i++)
+			width[i] = (int)rec->args[arg++];
+		val = rec->args[arg++];
+
+		switch (type)
+		{
+		 case 'i':
+			TRACEDEC_PRINT((int)val);
+			break;
+		 case 'l':
+			TRACEDEC_PRINT((long)val);
+			break;
+		 case 'L':
+			TRACEDEC_PRINT((long long)val);
+			break;
+		 case 'z':
+			TRACEDEC_PRINT((size_t)val);
+			break;
+		 case 'p':
+			TRACEDEC_PRINT((void *)(uintptr_t)val);
+			break;
+		 case 'f':
+		 {
+			double d;
+			memcpy(&d, &val, sizeof(d));
+			TRACEDEC_PRINT(d);
+			break;
+		 }
+		 case 's':
+			TRACEDEC_PRINT(val < nTraceDecStrings && TraceDec_Strings[val]
+			               ? TraceDec_Strings[val] : "(null)");
+			break;
+		}
+		start = end;
+	}
+
+	/* Rest of the format without conversions */
+	for (; *start; start++)
+	{
+		if (start[0] == '%' && start[1] == '%')
+			start++;
+		putchar(*start);
+	}
+}
+
+/**
+ * Mark the instruction words which were not recorded as "????" in the
+ * hexdump of a disassembled line. The operands decoded from them are
+ * meaningless, so they are replaced with "????" too.
+ */
+static void TraceDec_MarkUnknown(char *line, int words)
+{
+	char *p = strstr(line, " :");
+	int i;
+
+	if (!p)
+		return;
+	for (p += 2; *p == ' '; p++)
+		;
+	for (i = 0; i < words && isxdigit((unsigned char)p[0]) && isxdigit((unsigned char)p[1])
+	            && isxdigit((unsigned char)p[2]) && isxdigit((unsigned char)p[3]); i++)
+	{
+		if (i >= nTraceDecWords)
+			memcpy(p, "????", 4);
+		p += 4;
+		if (*p != ' ')
+			break;
+		p++;
+	}
+
+	/* Skip the rest of the hexdump, which may end with a truncated word */
+	for (; *p && *p != ' ' && *p != '\n'; p++)
+	{
+		if (i < words && i >= nTraceDecWords && isxdigit((unsigned char)*p))
+			*p = '?';
+	}
+	/* and the opcode */
+	p += strspn(p, " ");
+	p += strcspn(p, " \n");
+	if (*p == ' ')
+		strcpy(p + strspn(p, " "), "????\n");
+}
+
+/**
+ * Print a 68k instruction like the TRACE_CPU_DISASM trace does.
+ */
+static void TraceDec_Cpu(const TRACEBUF_RECORD *rec)
+{
+	static FILE *tmp;
+	char line[1024];
+	uaecptr nextpc;
+	int i;
+
+	TraceDec_Pc = rec->args[0];
+	nTraceDecWords = rec->count;
+	for (i = 0; i < nTraceDecWords; i++)
+		TraceDec_Words[i] = rec->args[1 + i / 4] >> (16 * (i % 4));
+
+	printf("cpu video_cyc=%6d %3d@%3d : ", (int)rec->args[4],
+	       (int)(rec->args[5] >> 16), (int)(rec->args[5] & 0xFFFF));
+
+	/* Disassemble into a temporary file to mark the unknown words */
+	if (!tmp && !(tmp = tmpfile()))
+	{
+		Disasm(stdout, TraceDec_Pc, NULL, 1, DISASM_ENGINE_EXT);
+		return;
+	}
+	bTraceDecUnknown = false;
+	rewind(tmp);
+	Disasm(tmp, TraceDec_Pc, &nextpc, 1, DISASM_ENGINE_EXT);
+	fflush(tmp);
+	rewind(tmp);
+	if (!fgets(line, sizeof(line), tmp))
+	{
+		putchar('\n');
+		return;
+	}
+	if (bTraceDecUnknown)
+		TraceDec_MarkUnknown(line, (nextpc - TraceDec_Pc) / 2);
+	fputs(line, stdout);
+}
+
+/**
+ * Print a DSP instruction like the TRACE_DSP_DISASM trace does.
+ */
+static void TraceDec_Dsp(const TRACEBUF_RECORD *rec)
+{
+	Uint32 pc = rec->args[0];
+	int i;
+
+	for (i = 0; i < 2; i++, pc++)
+	{
+		if (pc < 0x200)
+			dsp_core.ramint[DSP_SPACE_P][pc] = rec->args[1 + i];
+		else
+			dsp_core.ramext[pc & (DSP_RAMSIZE-1)] = rec->args[1 + i];
+	}
+	dsp_core.pc = rec->args[0];
+	dsp_core.instr_cycle = rec->args[3];
+
+	dsp56k_disasm(DSP_DISASM_MODE);
+	fputs(dsp56k_getInstructionText(), stdout);
+}
+
+/**
+ * Print an i860 instruction.
+ */
+static void TraceDec_I860(const TRACEBUF_RECORD *rec)
+{
+	char buf[256];
+
+	i860_disassembler(rec->args[0], rec->args[1], buf);
+	printf("i860 %08x: %08x  %s\n", (Uint32)rec->args[0], (Uint32)rec->args[1], buf);
+}
+
+/**
+ * Read the text of a string definition.
+ */
+static bool TraceDec_String(FILE *fp, const TRACEBUF_RECORD *rec)
+{
+	Uint32 len = rec->args[0];
+	Uint32 n = (len + sizeof(TRACEBUF_RECORD) - 1) / sizeof(TRACEBUF_RECORD);
+	char *str = calloc(n + 1, sizeof(TRACEBUF_RECORD));
+
+	if (!str || fread(str, sizeof(TRACEBUF_RECORD), n, fp) != n)
+	{
+		free(str);
+		return false;
+	}
+	str[len] = '\0';
+
+	if (rec->id >= nTraceDecStrings)
+	{
+		Uint32 size = rec->id + 256;
+		TraceDec_Strings = realloc(TraceDec_Strings, size * sizeof(char *));
+		memset(TraceDec_Strings + nTraceDecStrings, 0, (size - nTraceDecStrings) * sizeof(char *));
+		nTraceDecStrings = size;
+	}
+	free(TraceDec_Strings[rec->id]);
+	TraceDec_Strings[rec->id] = str;
+	return true;
+}
+
+
+int main(int argc, char *argv[])
+{
+	TRACEBUF_HEADER header;
+	TRACEBUF_RECORD rec;
+	FILE *fp;
+	int i;
+
+	if (argc != 2)
+	{
+		fprintf(stderr, "Usage: %s <trace file>\n", argv[0]);
+		return 1;
+	}
+	fp = fopen(argv[1], "rb");
+	if (!fp)
+	{
+		perror(argv[1]);
+		return 1;
+	}
+	if (fread(&header, sizeof(header), 1, fp) != 1
+	    || memcmp(header.magic, TRACEBUF_MAGIC, sizeof(header.magic)) != 0)
+	{
+		fprintf(stderr, "%s: not a binary trace file\n", argv[1]);
+		return 1;
+	}
+	if (header.byteorder != TRACEBUF_BYTEORDER)
+	{
+		fprintf(stderr, "%s: trace was written on a host with different byte order\n", argv[1]);
+		return 1;
+	}
+	if (header.version != TRACEBUF_VERSION || header.recsize != sizeof(TRACEBUF_RECORD))
+	{
+		fprintf(stderr, "%s: unsupported trace version %u\n", argv[1], header.version);
+		return 1;
+	}
+
+	for (i = 0; i < 65536; i++)
+		mem_banks[i] = &TraceDec_bank;
+	dsp56k_disasm_init();
+
+	while (fread(&rec, sizeof(rec), 1, fp) == 1)
+	{
+		if (rec.event == TRACEBUF_EV_STRING)
+		{
+			if (!TraceDec_String(fp, &rec))
+				break;
+			continue;
+		}
+
+		if (rec.thread)
+			printf("%12"PRIu64" [%d] ", rec.cycles, rec.thread);
+		else
+			printf("%12"PRIu64" ", rec.cycles);
+
+		switch (rec.event)
+		{
+		 case TRACEBUF_EV_PRINTF:
+			if (rec.id < nTraceDecStrings && TraceDec_Strings[rec.id])
+				TraceDec_Printf(TraceDec_Strings[rec.id], &rec);
+			else
+				printf("<unknown format %u>\n", rec.id);
+			break;
+		 case TRACEBUF_EV_CPU_DISASM:
+			TraceDec_Cpu(&rec);
+			break;
+		 case TRACEBUF_EV_DSP_DISASM:
+			TraceDec_Dsp(&rec);
+			break;
+		 case TRACEBUF_EV_I860_DISASM:
+			TraceDec_I860(&rec);
+			break;
+		 default:
+			printf("<unknown event %d>\n", rec.event);
+			break;
+		}
+	}
+
+	fclose(fp);
+	return 0;
+}
@@ -20,6 +20,16 @@
 
 #define ND_NBIC_SPACE   0xFFFFFFE8
 
+#define ND_IO_SPACE     0xFF800000
+#define ND_IO_BITS      0xFFFF0000
+
+/* Let the i860 catch up before the CPU touches board registers, the
+ * whole 64 kB IO bank (registers and their aliases) counts */
+static inline void nd_sync_io(Uint32 addr) {
+    if ((addr & ND_IO_BITS) == ND_IO_SPACE)
+        M68000_SyncCoprocessors();
+}
+
 
 /* NeXTdimension slot memory access */
 Uint32 nd_slot_lget(Uint32 addr) {
@@ -29,6 +39,7 @@ Uint32 nd_slot_lget(Uint32 addr) {
     if (addr<ND_NBIC_SPACE) {
         return nd_longget(addr);
     } else {
+        M68000_SyncCoprocessors();
         return nd_nbic_lget(addr);
     }
 }
@@ -40,6 +51,7 @@ Uint16 nd_slot_wget(Uint32 addr) {
     if (addr<ND_NBIC_SPACE) {
         return nd_wordget(addr);
     } else {
+        M68000_SyncCoprocessors();
         return nd_nbic_wget(addr);
     }
 }
@@ -51,6 +63,7 @@ Uint8 nd_slot_bget(Uint32 addr) {
     if (addr<ND_NBIC_SPACE) {
         return nd_byteget(addr);
     } else {
+        M68000_SyncCoprocessors();
         return nd_nbic_bget(addr);
     }
 }
@@ -62,6 +75,7 @@ void nd_slot_lput(Uint32 addr, Uint32 l) {
     if (addr<ND_NBIC_SPACE) {
         nd_longput(addr, l);
     } else {
+        M68000_SyncCoprocessors();
         nd_nbic_lput(addr, l);
     }
 }
@@ -73,6 +87,7 @@ void nd_slot_wput(Uint32 addr, Uint16 w) {
     if (addr<ND_NBIC_SPACE) {
         nd_wordput(addr, w);
     } else {
+        M68000_SyncCoprocessors();
         nd_nbic_wput(addr, w);
     }
 }
@@ -84,6 +99,7 @@ void nd_slot_bput(Uint32 addr, Uint8 b) {
     if (addr<ND_NBIC_SPACE) {
         nd_byteput(addr, b);
     } else {
+        M68000_SyncCoprocessors();
         nd_nbic_bput(addr, b);
     }
 }
@@ -91,36 +107,43 @@ void nd_slot_bput(Uint32 addr, Uint8 b) {
 /* NeXTdimension board memory access */
 inline Uint32 nd_board_lget(Uint32 addr) {
     addr |= ND_BOARD_BITS;
+    nd_sync_io(addr);
     return nd_longget(addr);
 }
 
 inline Uint16 nd_board_wget(Uint32 addr) {
     addr |= ND_BOARD_BITS;
+    nd_sync_io(addr);
     return nd_wordget(addr);
 }
 
 inline Uint8 nd_board_bget(Uint32 addr) {
     addr |= ND_BOARD_BITS;
+    nd_sync_io(addr);
     return nd_byteget(addr);
 }
 
 inline void nd_board_lput(Uint32 addr, Uint32 l) {
     addr |= ND_BOARD_BITS;
+    nd_sync_io(addr);
     nd_longput(addr, l);
 }
 
 inline void nd_board_wput(Uint32 addr, Uint16 w) {
     addr |= ND_BOARD_BITS;
+    nd_sync_io(addr);
     nd_wordput(addr, w);
 }
 
 inline void nd_board_bput(Uint32 addr, Uint8 b) {
     addr |= ND_BOARD_BITS;
+    nd_sync_io(addr);
     nd_byteput(addr, b);
 }
 
 inline Uint8 nd_board_cs8get(Uint32 addr) {
     addr |= ND_BOARD_BITS;
+    nd_sync_io(addr);
     return nd_cs8get(addr);
 }
 
@@ -151,6 +174,7 @@ void dimension_init(void) {
 
 void dimension_uninit(void) {
 	nd_i860_uninit();
+	nd_memory_uninit();
 }
 
 #endif
@@ -27,15 +27,16 @@ Uint64 swap64(Uint64 val);
 Uint32 swap32(Uint32 val);
 Uint16 swap16(Uint16 val);
 
-extern Uint8 ND_ram[64*1024*1024];
+extern Uint8 *ND_ram;
 extern Uint8 ND_rom[128*1024];
-extern Uint8 ND_vram[4*1024*1024];
+extern Uint8 *ND_vram;
 
 void dimension_init(void);
 void dimension_uninit(void);
 void nd_i860_init();
 void nd_i860_uninit();
 void i860_Run(int nHostCycles);
+void i860_RunSteps(int nSteps, int nHostCycles);
 bool i860_dbg_break(Uint32 addr);
 void i860_reset();
 void nd_start_debugger(void);
@@ -25,6 +25,19 @@
 
 static i860_cpu_device nd_i860;
 
+/* TRACE_I860_DISASM in log.h */
+#define I860_TRACE_DISASM (1ll<<42)
+
+static void i860_trace_disasm(UINT32 pc, UINT32 insn) {
+    if(bTraceBufEnabled) {
+        TraceBuf_I860Disasm(pc, insn);
+    } else {
+        char buf[256];
+        i860_disassembler(pc, insn, buf);
+        fprintf(TraceFile, "i860 %08x: %08x  %s\n", pc, insn, buf);
+    }
+}
+
 extern "C" {
     void nd_i860_init() {
         nd_i860.init();
@@ -57,6 +70,18 @@ extern "C" {
 		}
 	}
 	
+	/* Run the instructions of several CPU steps, spreading the host cycles */
+	void i860_RunSteps(int nSteps, int nHostCycles) {
+		if (nd_speed_hack) {
+			i860_Run(nHostCycles);
+			return;
+		}
+		int cycles = nHostCycles / nSteps;
+		int extra  = nHostCycles - cycles * nSteps;
+		while(nSteps--)
+			i860_Run(nSteps < extra ? cycles + 1 : cycles);
+	}
+	
     offs_t i860_Disasm(char* buffer, offs_t pc) {
         return nd_i860.disasm(buffer, pc);
     }
@@ -68,18 +93,31 @@ extern "C" {
 
 void i860_cpu_device::run_cycle(int nHostCycles) {
 
+    nPerfI860Steps++;
     if(m_halt) return;
     
+    nPerfI860Instr++;
+    
     UINT32 savepc = m_pc;
     m_pc_updated = 0;
     m_pending_trap = 0;
     
     savepc = m_pc;
     
-    decode_exec (ifetch (m_pc), 1);
+    UINT32 insn = ifetch (m_pc);
+    if(bI860Profiling && !m_exiting_ifetch)
+        Profile_I860Update(m_pc, insn, m_dim == 2);
+    if((LogTraceFlags & I860_TRACE_DISASM) && !m_exiting_ifetch)
+        i860_trace_disasm(m_pc, insn);
+    decode_exec (insn, 1);
     
     if(!(m_pending_trap)) {
-        if(nd_process_interrupts(nHostCycles))
+        /* Board interrupts are only re-evaluated when a deadline passes */
+        nd_irq_countdown -= nHostCycles;
+        if(nd_irq_countdown <= 0)
+            nd_process_interrupts();
+        
+        if(nd_irq_line)
             i860_gen_interrupt();
         else
             i860_clr_interrupt();
@@ -322,6 +360,13 @@ void i860_cpu_device::init() {
     err = memtest(true); if(err) goto error;
     err = memtest(false); if(err) goto error;
     
+    err = fzchktest();
+    if(err) {
+        fprintf(stderr, "NeXTdimension i860 emulator: vectorized graphics unit does not match the scalar version. Error %d. Exiting.\n", err);
+        fflush(stderr);
+        exit(err);
+    }
+    
 error:
     if(err) {
         fprintf(stderr, "NeXTdimension i860 emulator requires a little-endian host. This system seems to be big endian. Error %d. Exiting.\n", err);
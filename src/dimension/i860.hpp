@@ -58,10 +58,21 @@ extern "C" {
     void   nd_board_wput(UINT32 addr, UINT16 val);
     UINT32 nd_board_lget(UINT32 addr);
     void   nd_board_lput(UINT32 addr, UINT32 val);
-    int    nd_process_interrupts(int nHostCycles);
+    void   nd_process_interrupts(void);
+    extern int nd_irq_countdown;
+    extern int nd_irq_line;
+    void   Profile_I860Update(UINT32 pc, UINT32 insn, int dual);
+    extern bool bI860Profiling;
+    extern UINT64 LogTraceFlags;
+    extern FILE* TraceFile;
+    extern bool bTraceBufEnabled;
+    void   TraceBuf_I860Disasm(UINT32 pc, UINT32 insn);
     bool   nd_dbg_cmd(const char* cmd);
     bool   i860_dbg_break(UINT32 addr);
     void   Statusbar_SetNdLed(int state);
+    extern UINT8* nd_mem_direct[65536];
+    extern UINT64 nPerfI860Instr;
+    extern UINT64 nPerfI860Steps;
 }
 
 /***************************************************************************
@@ -325,52 +336,50 @@ private:
     
 	UINT64 m_merge;
 
-	/* The adder pipeline, always 3 stages.  */
-	struct
-	{
-		/* The stage contents.  */
-		union {
-			float s;
-			double d;
-		} val;
+	/* A stage of the floating point pipelines.  */
+	union fpstage {
+		float s;
+		double d;
+	};
 
-		/* The stage status bits.  */
-		struct {
-			/* Adder result precision (1 = dbl, 0 = sgl).  */
-			char arp;
-		} stat;
-	} m_A[3];
+	/* The adder, multiplier and load pipelines are ring buffers: stage n
+	   (0 = first) is val[(head + n) & 3] and its result precision
+	   (1 = dbl, 0 = sgl) is bit n of prec.  Advancing a pipeline moves
+	   head back by one and writes the new first stage, so no stage
+	   contents are copied.  */
+	struct fppipe {
+		fpstage val[4];
+		UINT8   head;
+		UINT8   prec;
+
+		fpstage& stage (int n) { return val[(head + n) & 3]; }
+		int rp (int n) const { return (prec >> n) & 1; }
+
+		/* Advance the pipeline and return the new first stage.  With
+		   2 stages (double precision multiply) the 3rd stage is kept.  */
+		fpstage& advance (int dbl, int stages) {
+			head = (head - 1) & 3;
+			if (stages == 3) {
+				prec = ((prec << 1) | dbl) & 7;
+			} else {
+				val[(head + 2) & 3] = val[(head + 3) & 3];
+				prec = (prec & 4) | ((prec << 1) & 2) | dbl;
+			}
+			return val[head];
+		}
+		void push_s (float v, int stages = 3) { advance (0, stages).s = v; }
+		void push_d (double v, int stages = 3) { advance (1, stages).d = v; }
+	};
+
+	/* The adder pipeline, always 3 stages.  */
+	fppipe m_A;
 
 	/* The multiplier pipeline. 3 stages for single precision, 2 stages
 	   for double precision, and confusing for mixed precision.  */
-	struct {
-		/* The stage contents.  */
-		union {
-			float s;
-			double d;
-		} val;
-
-		/* The stage status bits.  */
-		struct {
-			/* Multiplier result precision (1 = dbl, 0 = sgl).  */
-			char mrp;
-		} stat;
-	} m_M[3];
+	fppipe m_M;
 
 	/* The load pipeline, always 3 stages.  */
-	struct {
-		/* The stage contents.  */
-		union {
-			float s;
-			double d;
-		} val;
-
-		/* The stage status bits.  */
-		struct {
-			/* Load result precision (1 = dbl, 0 = sgl).  */
-			char lrp;
-		} stat;
-	} m_L[3];
+	fppipe m_L;
 
 	/* The graphics/integer pipeline, always 1 stage.  */
 	struct {
@@ -449,12 +458,40 @@ private:
         }
     }
 
+    /* Host pointer for plain ND memory (RAM, VRAM) or NULL if the
+       address must go through the bank handlers (IO, RAMDAC, DP, ROM).  */
+    inline UINT8* nd_direct(UINT32 addr) {
+        UINT8* page = nd_mem_direct[(addr >> 16) | 0xF000];
+        return page ? page + (addr & 0xFFFF) : NULL;
+    }
+    
+    /* ND memory is big endian */
+    inline UINT32 nd_direct_rd32(const UINT8* p) {
+        return (p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+    }
+    
+    inline UINT16 nd_direct_rd16(const UINT8* p) {
+        return (p[0] << 8) | p[1];
+    }
+    
+    inline void nd_direct_wr32(UINT8* p, UINT32 val) {
+        p[0] = val >> 24; p[1] = val >> 16; p[2] = val >> 8; p[3] = val;
+    }
+    
+    inline void nd_direct_wr16(UINT8* p, UINT16 val) {
+        p[0] = val >> 8; p[1] = val;
+    }
+    
     inline UINT32 rd32i(UINT32 addr) {
+        UINT8* mem = nd_direct(addr^4);
+        if (mem) return nd_direct_rd32(mem);
         return nd_board_lget(addr^4);
     }
     
     inline void wr32i(UINT32 addr, UINT32 val) {
-        nd_board_lput(addr^4, val);
+        UINT8* mem = nd_direct(addr^4);
+        if (mem) nd_direct_wr32(mem, val);
+        else     nd_board_lput(addr^4, val);
     }
     
     inline UINT8 rdcs8(UINT32 addr) {
@@ -462,33 +499,45 @@ private:
     }
     
     inline UINT8 rd8(UINT32 addr) {
-        if (GET_EPSR_BE())  return nd_board_bget(addr);
-        else                return nd_board_bget(addr^7);
+        if (!GET_EPSR_BE()) addr ^= 7;
+        UINT8* mem = nd_direct(addr);
+        if (mem) return *mem;
+        return nd_board_bget(addr);
     }
     
     inline UINT16 rd16(UINT32 addr) {
-        if (GET_EPSR_BE())  return nd_board_wget(addr);
-        else                return nd_board_wget(addr^6);
+        if (!GET_EPSR_BE()) addr ^= 6;
+        UINT8* mem = nd_direct(addr);
+        if (mem) return nd_direct_rd16(mem);
+        return nd_board_wget(addr);
     }
     
     inline UINT32 rd32(UINT32 addr) {
-        if(GET_EPSR_BE())   return nd_board_lget(addr);
-        else                return nd_board_lget(addr^4);
+        if (!GET_EPSR_BE()) addr ^= 4;
+        UINT8* mem = nd_direct(addr);
+        if (mem) return nd_direct_rd32(mem);
+        return nd_board_lget(addr);
     }
     
     inline void wr8(UINT32 addr, UINT8 val) {
-        if (GET_EPSR_BE())  nd_board_bput(addr,   val);
-        else                nd_board_bput(addr^7, val);
+        if (!GET_EPSR_BE()) addr ^= 7;
+        UINT8* mem = nd_direct(addr);
+        if (mem) *mem = val;
+        else     nd_board_bput(addr, val);
     }
     
     inline void wr16(UINT32 addr, UINT16 val) {
-        if (GET_EPSR_BE())  nd_board_wput(addr,   val);
-        else                nd_board_wput(addr^6, val);
+        if (!GET_EPSR_BE()) addr ^= 6;
+        UINT8* mem = nd_direct(addr);
+        if (mem) nd_direct_wr16(mem, val);
+        else     nd_board_wput(addr, val);
     }
     
     inline void wr32(UINT32 addr, UINT32 val) {
-        if (GET_EPSR_BE())  nd_board_lput(addr  , val);
-        else                nd_board_lput(addr^4, val);
+        if (!GET_EPSR_BE()) addr ^= 4;
+        UINT8* mem = nd_direct(addr);
+        if (mem) nd_direct_wr32(mem, val);
+        else     nd_board_lput(addr, val);
     }
     
 	void writememi_emu (UINT32 addr, int size, UINT32 data);
@@ -582,6 +631,7 @@ private:
 	float  get_fval_from_optype_s (UINT32 insn, int optype);
 	double get_fval_from_optype_d (UINT32 insn, int optype);
     int    memtest(bool be);
+    int    fzchktest();
     
 	typedef void (i860_cpu_device::*insn_func)(UINT32);
 	struct decode_tbl_t
@@ -597,6 +647,6 @@ private:
 };
 
 /* disassembler */
-int i860_disassembler(UINT32 pc, UINT32 insn, char* buffer);
+extern "C" int i860_disassembler(UINT32 pc, UINT32 insn, char* buffer);
 
 #endif /* __I860_H__ */
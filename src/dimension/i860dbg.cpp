@@ -15,7 +15,7 @@
  
 ***************************************************************************/
 
-extern int i860_disassembler(UINT32 pc, UINT32 insn, char* buffer);
+extern "C" int i860_disassembler(UINT32 pc, UINT32 insn, char* buffer);
 
 /* A simple internal debugger.  */
 void i860_cpu_device::debugger() {
@@ -240,12 +240,12 @@ void i860_cpu_device::dump_pipe (int type)
         fprintf (stderr, "  A: ");
         for (i = 0; i < 3; i++)
         {
-            if (m_A[i].stat.arp)
+            if (m_A.rp (i))
                 fprintf (stderr, "[%dd] 0x%016llx ", i + 1,
-                         *(UINT64 *)(&m_A[i].val.d));
+                         *(UINT64 *)(&m_A.stage (i).d));
             else
                 fprintf (stderr, "[%ds] 0x%08x ", i + 1,
-                         *(UINT32 *)(&m_A[i].val.s));
+                         *(UINT32 *)(&m_A.stage (i).s));
         }
         fprintf (stderr, "\n");
     }
@@ -257,12 +257,12 @@ void i860_cpu_device::dump_pipe (int type)
         fprintf (stderr, "  M: ");
         for (i = 0; i < 3; i++)
         {
-            if (m_M[i].stat.mrp)
+            if (m_M.rp (i))
                 fprintf (stderr, "[%dd] 0x%016llx ", i + 1,
-                         *(UINT64 *)(&m_M[i].val.d));
+                         *(UINT64 *)(&m_M.stage (i).d));
             else
                 fprintf (stderr, "[%ds] 0x%08x ", i + 1,
-                         *(UINT32 *)(&m_M[i].val.s));
+                         *(UINT32 *)(&m_M.stage (i).s));
         }
         fprintf (stderr, "\n");
     }
@@ -273,12 +273,12 @@ void i860_cpu_device::dump_pipe (int type)
         fprintf (stderr, "  L: ");
         for (i = 0; i < 3; i++)
         {
-            if (m_L[i].stat.lrp)
+            if (m_L.rp (i))
                 fprintf (stderr, "[%dd] 0x%016llx ", i + 1,
-                         *(UINT64 *)(&m_L[i].val.d));
+                         *(UINT64 *)(&m_L.stage (i).d));
             else
                 fprintf (stderr, "[%ds] 0x%08x ", i + 1,
-                         *(UINT32 *)(&m_L[i].val.s));
+                         *(UINT32 *)(&m_L.stage (i).s));
         }
         fprintf (stderr, "\n");
     }
@@ -45,6 +45,12 @@
 #include <math.h>
 #include <assert.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
 /* Get/set general register value -- watch for r0 on writes.  */
 #define get_iregval(gr)       (m_iregs[(gr)])
 #define set_iregval(gr, val)  (m_iregs[(gr)] = ((gr) == 0 ? 0 : (val)))
@@ -925,26 +931,21 @@ void i860_cpu_device::insn_fldy (UINT32 insn)
 		   bit of the stage's result-status bits.  */
 #if 1 /* FIXME: WIP on FSR update.  This may not be correct.  */
 		/* Copy 3rd stage LRP to FSR.  */
-		if (m_L[1 /* 2 */].stat.lrp)
+		if (m_L.rp (1 /* 2 */))
 			m_cregs[CR_FSR] |= 0x04000000;
 		else
 			m_cregs[CR_FSR] &= ~0x04000000;
 #endif
-		if (m_L[2].stat.lrp)  /* 3rd (last) stage.  */
-			set_fregval_d (fdest, m_L[2].val.d);
+		if (m_L.rp (2))  /* 3rd (last) stage.  */
+			set_fregval_d (fdest, m_L.stage (2).d);
 		else
-			set_fregval_s (fdest, m_L[2].val.s);
+			set_fregval_s (fdest, m_L.stage (2).s);
 
 		/* Now advance pipeline and write loaded data to first stage.  */
-		m_L[2] = m_L[1];
-		m_L[1] = m_L[0];
-		if (size == 8) {
-            m_L[0].val.d = *((double*)bebuf);
-			m_L[0].stat.lrp = 1;
-		} else {
-            m_L[0].val.s = *((float*)bebuf);
-			m_L[0].stat.lrp = 0;
-		}
+		if (size == 8)
+			m_L.push_d (*((double*)bebuf));
+		else
+			m_L.push_s (*((float*)bebuf));
 	}
 
 	ab_op:;
@@ -2289,10 +2290,10 @@ void i860_cpu_device::insn_fmul (UINT32 insn)
 	   operation.  */
 	if (piped)
 	{
-		if (m_M[num_stages - 1].stat.mrp)
-			dbl_last_stage_contents = m_M[num_stages - 1].val.d;
+		if (m_M.rp (num_stages - 1))
+			dbl_last_stage_contents = m_M.stage (num_stages - 1).d;
 		else
-			sgl_last_stage_contents = m_M[num_stages - 1].val.s;
+			sgl_last_stage_contents = m_M.stage (num_stages - 1).s;
 	}
 
 	/* Do the operation, being careful about source and result
@@ -2353,37 +2354,23 @@ void i860_cpu_device::insn_fmul (UINT32 insn)
 		   stage of the pipeline.  */
 #if 1 /* FIXME: WIP on FSR update.  This may not be correct.  */
 		/* Copy 3rd stage MRP to FSR.  */
-		if (m_M[num_stages - 2  /* 1 */].stat.mrp)
+		if (m_M.rp (num_stages - 2  /* 1 */))
 			m_cregs[CR_FSR] |= 0x10000000;
 		else
 			m_cregs[CR_FSR] &= ~0x10000000;
 #endif
 
-		if (m_M[num_stages - 1].stat.mrp)
+		if (m_M.rp (num_stages - 1))
 			set_fregval_d (fdest, dbl_last_stage_contents);
 		else
 			set_fregval_s (fdest, sgl_last_stage_contents);
 
 		/* Now advance pipeline and write current calculation to
 		   first stage.  */
-		if (num_stages == 3)
-		{
-			m_M[2] = m_M[1];
-			m_M[1] = m_M[0];
-		}
-		else
-			m_M[1]  = m_M[0];
-
 		if (res_prec)
-		{
-			m_M[0].val.d = dbl_tmp_dest;
-			m_M[0].stat.mrp = 1;
-		}
+			m_M.push_d (dbl_tmp_dest, num_stages);
 		else
-		{
-			m_M[0].val.s = sgl_tmp_dest;
-			m_M[0].stat.mrp = 0;
-		}
+			m_M.push_s (sgl_tmp_dest, num_stages);
 	}
 }
 
@@ -2449,10 +2436,10 @@ void i860_cpu_device::insn_fadd_sub (UINT32 insn)
 	   for pfadd/pfsub.  */
 	if (piped)
 	{
-		if (m_A[2].stat.arp)
-			dbl_last_stage_contents = m_A[2].val.d;
+		if (m_A.rp (2))
+			dbl_last_stage_contents = m_A.stage (2).d;
 		else
-			sgl_last_stage_contents = m_A[2].val.s;
+			sgl_last_stage_contents = m_A.stage (2).s;
 	}
 
 	/* Do the operation, being careful about source and result
@@ -2513,30 +2500,22 @@ void i860_cpu_device::insn_fadd_sub (UINT32 insn)
 		   bit of the stage's result-status bits.  */
 #if 1 /* FIXME: WIP on FSR update.  This may not be correct.  */
 		/* Copy 3rd stage ARP to FSR.  */
-		if (m_A[1 /* 2 */].stat.arp)
+		if (m_A.rp (1 /* 2 */))
 			m_cregs[CR_FSR] |= 0x20000000;
 		else
 			m_cregs[CR_FSR] &= ~0x20000000;
 #endif
-		if (m_A[2].stat.arp)  /* 3rd (last) stage.  */
+		if (m_A.rp (2))  /* 3rd (last) stage.  */
 			set_fregval_d (fdest, dbl_last_stage_contents);
 		else
 			set_fregval_s (fdest, sgl_last_stage_contents);
 
 		/* Now advance pipeline and write current calculation to
 		   first stage.  */
-		m_A[2] = m_A[1];
-		m_A[1] = m_A[0];
 		if (res_prec)
-		{
-			m_A[0].val.d = dbl_tmp_dest;
-			m_A[0].stat.arp = 1;
-		}
+			m_A.push_d (dbl_tmp_dest);
 		else
-		{
-			m_A[0].val.s = sgl_tmp_dest;
-			m_A[0].stat.arp = 0;
-		}
+			m_A.push_s (sgl_tmp_dest);
 	}
 }
 
@@ -2613,10 +2592,10 @@ float i860_cpu_device::get_fval_from_optype_s (UINT32 insn, int optype)
 		break;
 	case OP_MPIPE:
 		/* Last stage is 3rd stage for single precision input.  */
-		retval = m_M[2].val.s;
+		retval = m_M.stage (2).s;
 		break;
 	case OP_APIPE:
-		retval = m_A[2].val.s;
+		retval = m_A.stage (2).s;
 		break;
 	default:
 		assert (0);
@@ -2652,10 +2631,10 @@ double i860_cpu_device::get_fval_from_optype_d (UINT32 insn, int optype)
 		break;
 	case OP_MPIPE:
 		/* Last stage is 2nd stage for double precision input.  */
-		retval = m_M[1].val.d;
+		retval = m_M.stage (1).d;
 		break;
 	case OP_APIPE:
-		retval = m_A[2].val.d;
+		retval = m_A.stage (2).d;
 		break;
 	default:
 		assert (0);
@@ -2731,16 +2710,16 @@ void i860_cpu_device::insn_dualop (UINT32 insn)
 	   whose precision is specified by the MRP bit of the stage's result-
 	   status bits.  Note for multiply, the number of stages is determined
 	   by the source precision of the current operation.  */
-	if (m_M[num_mul_stages - 1].stat.mrp)
-		dbl_last_Mstage_contents = m_M[num_mul_stages - 1].val.d;
+	if (m_M.rp (num_mul_stages - 1))
+		dbl_last_Mstage_contents = m_M.stage (num_mul_stages - 1).d;
 	else
-		sgl_last_Mstage_contents = m_M[num_mul_stages - 1].val.s;
+		sgl_last_Mstage_contents = m_M.stage (num_mul_stages - 1).s;
 
 	/* Similarly, retrieve the last stage of the adder pipe.  */
-	if (m_A[2].stat.arp)
-		dbl_last_Astage_contents = m_A[2].val.d;
+	if (m_A.rp (2))
+		dbl_last_Astage_contents = m_A.stage (2).d;
 	else
-		sgl_last_Astage_contents = m_A[2].val.s;
+		sgl_last_Astage_contents = m_A.stage (2).s;
 
 	/* Do the mul operation, being careful about source and result
 	   precision.  */
@@ -2825,7 +2804,7 @@ void i860_cpu_device::insn_dualop (UINT32 insn)
 	if (T_loaded)
 	{
 		/* T is loaded from the result of the last stage of the multiplier.  */
-		if (m_M[num_mul_stages - 1].stat.mrp)
+		if (m_M.rp (num_mul_stages - 1))
 			m_T.d = dbl_last_Mstage_contents;
 		else
 			m_T.s = sgl_last_Mstage_contents;
@@ -2860,7 +2839,7 @@ void i860_cpu_device::insn_dualop (UINT32 insn)
 		/* Update fdest with the result from the last stage of the
 		   adder pipeline, with precision specified by the ARP
 		   bit of the stage's result-status bits.  */
-		if (m_A[2].stat.arp)
+		if (m_A.rp (2))
 			set_fregval_d (fdest, dbl_last_Astage_contents);
 		else
 			set_fregval_s (fdest, sgl_last_Astage_contents);
@@ -2870,7 +2849,7 @@ void i860_cpu_device::insn_dualop (UINT32 insn)
 		/* Update fdest with the result from the last stage of the
 		   multiplier pipeline, with precision specified by the MRP
 		   bit of the stage's result-status bits.  */
-		if (m_M[num_mul_stages - 1].stat.mrp)
+		if (m_M.rp (num_mul_stages - 1))
 			set_fregval_d (fdest, dbl_last_Mstage_contents);
 		else
 			set_fregval_s (fdest, sgl_last_Mstage_contents);
@@ -2881,7 +2860,7 @@ void i860_cpu_device::insn_dualop (UINT32 insn)
 	/* FIXME: Mixed precision (only weird for pfmul).  */
 #if 1 /* FIXME: WIP on FSR update.  This may not be correct.  */
 	/* Copy 3rd stage MRP to FSR.  */
-	if (m_M[num_mul_stages - 2  /* 1 */].stat.mrp)
+	if (m_M.rp (num_mul_stages - 2  /* 1 */))
 		m_cregs[CR_FSR] |= 0x10000000;
 	else
 		m_cregs[CR_FSR] &= ~0x10000000;
@@ -2889,30 +2868,16 @@ void i860_cpu_device::insn_dualop (UINT32 insn)
 
 	/* Now advance multiplier pipeline and write current calculation to
 	   first stage.  */
-	if (num_mul_stages == 3)
-	{
-		m_M[2] = m_M[1];
-		m_M[1] = m_M[0];
-	}
-	else
-		m_M[1]  = m_M[0];
-
 	if (res_prec)
-	{
-		m_M[0].val.d = dbl_tmp_dest_mul;
-		m_M[0].stat.mrp = 1;
-	}
+		m_M.push_d (dbl_tmp_dest_mul, num_mul_stages);
 	else
-	{
-		m_M[0].val.s = sgl_tmp_dest_mul;
-		m_M[0].stat.mrp = 0;
-	}
+		m_M.push_s (sgl_tmp_dest_mul, num_mul_stages);
 
 	/* FIXME: Set result-status bits besides ARP. And copy to fsr from
 	          last stage.  */
 #if 1 /* FIXME: WIP on FSR update.  This may not be correct.  */
 	/* Copy 3rd stage ARP to FSR.  */
-	if (m_A[1 /* 2 */].stat.arp)
+	if (m_A.rp (1 /* 2 */))
 		m_cregs[CR_FSR] |= 0x20000000;
 	else
 		m_cregs[CR_FSR] &= ~0x20000000;
@@ -2920,18 +2885,10 @@ void i860_cpu_device::insn_dualop (UINT32 insn)
 
 	/* Now advance adder pipeline and write current calculation to
 	   first stage.  */
-	m_A[2] = m_A[1];
-	m_A[1] = m_A[0];
 	if (res_prec)
-	{
-		m_A[0].val.d = dbl_tmp_dest_add;
-		m_A[0].stat.arp = 1;
-	}
+		m_A.push_d (dbl_tmp_dest_add);
 	else
-	{
-		m_A[0].val.s = sgl_tmp_dest_add;
-		m_A[0].stat.arp = 0;
-	}
+		m_A.push_s (sgl_tmp_dest_add);
 }
 
 
@@ -3205,30 +3162,22 @@ void i860_cpu_device::insn_famov (UINT32 insn)
 		   bit of the stage's result-status bits.  */
 #if 1 /* FIXME: WIP on FSR update.  This may not be correct.  */
 		/* Copy 3rd stage ARP to FSR.  */
-		if (m_A[1 /* 2 */].stat.arp)
+		if (m_A.rp (1 /* 2 */))
 			m_cregs[CR_FSR] |= 0x20000000;
 		else
 			m_cregs[CR_FSR] &= ~0x20000000;
 #endif
-		if (m_A[2].stat.arp)  /* 3rd (last) stage.  */
-			set_fregval_d (fdest, m_A[2].val.d);
+		if (m_A.rp (2))  /* 3rd (last) stage.  */
+			set_fregval_d (fdest, m_A.stage (2).d);
 		else
-			set_fregval_s (fdest, m_A[2].val.s);
+			set_fregval_s (fdest, m_A.stage (2).s);
 
 		/* Now advance pipeline and write current calculation to
 		   first stage.  */
-		m_A[2] = m_A[1];
-		m_A[1] = m_A[0];
 		if (res_prec)
-		{
-			m_A[0].val.d = dbl_tmp_dest;
-			m_A[0].stat.arp = 1;
-		}
+			m_A.push_d (dbl_tmp_dest);
 		else
-		{
-			m_A[0].val.s = sgl_tmp_dest;
-			m_A[0].stat.arp = 0;
-		}
+			m_A.push_s (sgl_tmp_dest);
 	}
 }
 
@@ -3384,30 +3333,134 @@ void i860_cpu_device::insn_fcmp (UINT32 insn)
 	   bit of the stage's result-status bits.  */
 #if 1 /* FIXME: WIP on FSR update.  This may not be correct.  */
 	/* Copy 3rd stage ARP to FSR.  */
-	if (m_A[1 /* 2 */].stat.arp)
+	if (m_A.rp (1 /* 2 */))
 		m_cregs[CR_FSR] |= 0x20000000;
 	else
 		m_cregs[CR_FSR] &= ~0x20000000;
 #endif
-	if (m_A[2].stat.arp)  /* 3rd (last) stage.  */
-		set_fregval_d (fdest, m_A[2].val.d);
+	if (m_A.rp (2))  /* 3rd (last) stage.  */
+		set_fregval_d (fdest, m_A.stage (2).d);
 	else
-		set_fregval_s (fdest, m_A[2].val.s);
+		set_fregval_s (fdest, m_A.stage (2).s);
 
 	/* Now advance pipeline and write current calculation to
 	   first stage.  */
-	m_A[2] = m_A[1];
-	m_A[1] = m_A[0];
 	if (src_prec)
+		m_A.push_d (dbl_tmp_dest);
+	else
+		m_A.push_s (sgl_tmp_dest);
+}
+
+
+/* Z-buffer check of the fzchk instructions: unsigned minimum of the
+   four 16-bit (is16) or two 32-bit pixels of two registers.  Returns
+   the mask of the pixels where fsrc2 was selected (fsrc2 <= fsrc1),
+   pixel 0 (least significant) in bit 0.  */
+static int fzchk_scalar (UINT64 iv1, UINT64 iv2, int is16, UINT64 *r)
+{
+	int bits = is16 ? 16 : 32;
+	UINT64 lmask = is16 ? 0xffffULL : 0xffffffffULL;
+	int mask = 0;
+	int i;
+
+	*r = 0;
+	for (i = 0; i < 64 / bits; i++)
+	{
+		UINT64 ps1 = (iv1 >> (i * bits)) & lmask;
+		UINT64 ps2 = (iv2 >> (i * bits)) & lmask;
+		if (ps2 <= ps1)
+		{
+			*r |= ps2 << (i * bits);
+			mask |= 1 << i;
+		}
+		else
+			*r |= ps1 << (i * bits);
+	}
+	return mask;
+}
+
+#if defined(__SSE2__)
+/* SSE2 has no unsigned compares, so the pixels are biased to signed.  */
+static inline int fzchk_simd (UINT64 iv1, UINT64 iv2, int is16, UINT64 *r)
+{
+	__m128i a = _mm_loadl_epi64 ((const __m128i *)&iv1);
+	__m128i b = _mm_loadl_epi64 ((const __m128i *)&iv2);
+	__m128i gt, bias;
+
+	if (is16)
+	{
+		bias = _mm_set1_epi16 ((short)0x8000);
+		gt   = _mm_cmpgt_epi16 (_mm_xor_si128 (b, bias), _mm_xor_si128 (a, bias));
+	}
+	else
 	{
-		m_A[0].val.d = dbl_tmp_dest;
-		m_A[0].stat.arp = 1;
+		bias = _mm_set1_epi32 ((int)0x80000000);
+		gt   = _mm_cmpgt_epi32 (_mm_xor_si128 (b, bias), _mm_xor_si128 (a, bias));
+	}
+	_mm_storel_epi64 ((__m128i *)r, _mm_or_si128 (_mm_and_si128 (gt, a), _mm_andnot_si128 (gt, b)));
+
+	if (is16)
+		return ~_mm_movemask_epi8 (_mm_packs_epi16 (gt, gt)) & 0x0f;
+	return ~_mm_movemask_ps (_mm_castsi128_ps (gt)) & 0x03;
+}
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+static inline int fzchk_simd (UINT64 iv1, UINT64 iv2, int is16, UINT64 *r)
+{
+	if (is16)
+	{
+		static const uint16_t lane_bits[4] = { 1, 2, 4, 8 };
+		uint16x4_t a = vcreate_u16 (iv1);
+		uint16x4_t b = vcreate_u16 (iv2);
+		*r = vget_lane_u64 (vreinterpret_u64_u16 (vmin_u16 (a, b)), 0);
+		return vaddv_u16 (vand_u16 (vcle_u16 (b, a), vld1_u16 (lane_bits)));
 	}
 	else
 	{
-		m_A[0].val.s = sgl_tmp_dest;
-		m_A[0].stat.arp = 0;
+		static const uint32_t lane_bits[2] = { 1, 2 };
+		uint32x2_t a = vcreate_u32 (iv1);
+		uint32x2_t b = vcreate_u32 (iv2);
+		*r = vget_lane_u64 (vreinterpret_u64_u32 (vmin_u32 (a, b)), 0);
+		return vaddv_u32 (vand_u32 (vcle_u32 (b, a), vld1_u32 (lane_bits)));
+	}
+}
+#else
+#define fzchk_simd fzchk_scalar
+#endif
+
+/* Check the vectorized Z-buffer check against the scalar version.  */
+int i860_cpu_device::fzchktest ()
+{
+	static const UINT64 patterns[] = {
+		0x0000000000000000ULL, 0xffffffffffffffffULL,
+		0x0001000200030004ULL, 0x0004000300020001ULL,
+		0x80007fffffff0000ULL, 0x7fff80000000ffffULL,
+		0x7fffffff80000000ULL, 0x800000007fffffffULL,
+	};
+	const int npat = sizeof (patterns) / sizeof (patterns[0]);
+	UINT64 seed = 0x0123456789abcdefULL;
+
+	for (int i = 0; i < npat + 256; i++)
+	{
+		UINT64 iv1, iv2, r1, r2;
+		if (i < npat)
+		{
+			iv1 = patterns[i];
+			iv2 = patterns[(i + 1) % npat];
+		}
+		else
+		{
+			seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+			iv1 = seed;
+			/* Make some pixels equal.  */
+			iv2 = (i & 1) ? (seed ^ (seed >> 29)) : (seed & 0xffff0000ffff0000ULL);
+		}
+		for (int is16 = 0; is16 <= 1; is16++)
+		{
+			if (fzchk_simd (iv1, iv2, is16, &r1) != fzchk_scalar (iv1, iv2, is16, &r2) || r1 != r2)
+				return 30000 + i * 2 + is16;
+		}
 	}
+	return 0;
 }
 
 
@@ -3421,13 +3474,12 @@ void i860_cpu_device::insn_fzchk (UINT32 insn)
 	int piped = insn & 0x400;        /* 1 = pipelined, 0 = scalar.  */
 	int is_fzchks = insn & 8;        /* 1 = fzchks, 0 = fzchkl.  */
 	double dbl_tmp_dest = 0.0;
-	int i;
 	double v1 = get_fregval_d (fsrc1);
 	double v2 = get_fregval_d (fsrc2);
 	UINT64 iv1 = *(UINT64 *)&v1;
 	UINT64 iv2 = *(UINT64 *)&v2;
 	UINT64 r = 0;
-	char pm = GET_PSR_PM ();
+	int pm = GET_PSR_PM ();
 
 	/* Check for S and R bits set.  */
 	if ((insn & 0x180) != 0x180)
@@ -3438,45 +3490,13 @@ void i860_cpu_device::insn_fzchk (UINT32 insn)
 
 	/* Do the operation.  The fzchks version operates in parallel on
 	   four 16-bit pixels, while the fzchkl operates on two 32-bit
-	   pixels (pixels are unsigned ordinals in this context).  */
+	   pixels (pixels are unsigned ordinals in this context).
+	   PM is shifted right by the number of pixels, and the pixel
+	   mask fills the freed high bits.  */
 	if (is_fzchks)
-	{
-		pm = (pm >> 4) & 0x0f;
-		for (i = 3; i >= 0; i--)
-		{
-			UINT16 ps1 = (iv1 >> (i * 16)) & 0xffff;
-			UINT16 ps2 = (iv2 >> (i * 16)) & 0xffff;
-			if (ps2 <= ps1)
-			{
-				r |= ((UINT64)ps2 << (i * 16));
-				pm |= (1 << (7 - (3 - i)));
-			}
-			else
-			{
-				r |= ((UINT64)ps1 << (i * 16));
-				pm &= ~(1 << (7 - (3 - i)));
-			}
-		}
-	}
+		pm = ((pm >> 4) & 0x0f) | (fzchk_simd (iv1, iv2, 1, &r) << 4);
 	else
-	{
-		pm = (pm >> 2) & 0x3f;
-		for (i = 1; i >= 0; i--)
-		{
-			UINT32 ps1 = (iv1 >> (i * 32)) & 0xffffffff;
-			UINT32 ps2 = (iv2 >> (i * 32)) & 0xffffffff;
-			if (ps2 <= ps1)
-			{
-				r |= ((UINT64)ps2 << (i * 32));
-				pm |= (1 << (7 - (1 - i)));
-			}
-			else
-			{
-				r |= ((UINT64)ps1 << (i * 32));
-				pm &= ~(1 << (7 - (1 - i)));
-			}
-		}
-	}
+		pm = ((pm >> 2) & 0x3f) | (fzchk_simd (iv1, iv2, 0, &r) << 6);
 
 	dbl_tmp_dest = *(double *)&r;
 	SET_PSR_PM (pm);
@@ -3573,21 +3593,19 @@ void i860_cpu_device::insn_faddp (UINT32 insn)
 	dbl_tmp_dest = *(double *)&r;
 
 	/* Update the merge register depending on the pixel size.
-	   PS: 0 = 8 bits, 1 = 16 bits, 2 = 32-bits.  */
-	if (ps == 0)
-	{
-		m_merge = ((m_merge >> 8) & ~0xff00ff00ff00ff00ULL);
-		m_merge |= (r & 0xff00ff00ff00ff00ULL);
-	}
-	else if (ps == 1)
-	{
-		m_merge = ((m_merge >> 6) & ~0xfc00fc00fc00fc00ULL);
-		m_merge |= (r & 0xfc00fc00fc00fc00ULL);
-	}
-	else if (ps == 2)
-	{
-		m_merge = ((m_merge >> 8) & ~0xff000000ff000000ULL);
-		m_merge |= (r & 0xff000000ff000000ULL);
+	   PS: 0 = 8 bits, 1 = 16 bits, 2 = 32-bits.  All pixels are
+	   handled at once, each pixel's color field being aligned on
+	   the same bits of the 64-bit word.  */
+	static const struct { int shift; UINT64 mask; } merge_fields[4] = {
+		{ 8, 0xff00ff00ff00ff00ULL },
+		{ 6, 0xfc00fc00fc00fc00ULL },
+		{ 8, 0xff000000ff000000ULL },
+		{ 0, 0 },
+	};
+	if (ps < 3)
+	{
+		m_merge = ((m_merge >> merge_fields[ps].shift) & ~merge_fields[ps].mask);
+		m_merge |= (r & merge_fields[ps].mask);
 	}
 #if TRACE_UNDEFINED_I860
 	else
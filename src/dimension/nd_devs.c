@@ -99,10 +99,25 @@ const int VIDEO_HBL_CYC       = I860_CYC / (60 * VIDEO_HEIGHT);
 const int VIDEO_V_FRONT       = 5 * VIDEO_HBL_CYC;
 const int VIDEO_V_BACK        = VIDEO_VBL_CYC - VIDEO_V_FRONT - (VIDEO_VIS_HEIGHT * VIDEO_HBL_CYC);
 
-/* Cycle count for VBL interrupts */
-static int nd_vbl_cyc_count;
-/* Cycle count for video interrupts */
-static int nd_video_cyc_count;
+/* i860 cycle time of the last interrupt evaluation */
+static Uint64 nd_cyc_time;
+/* Countdown programmed at the last interrupt evaluation */
+static int nd_cyc_slice;
+/* Cycles left before the next interrupt evaluation (decremented by the i860) */
+int nd_irq_countdown;
+/* State of the i860 external interrupt line */
+int nd_irq_line;
+/* Set for one instruction when a VBL interrupt fires */
+static int nd_irq_pulse;
+
+/* Deadline for VBL interrupts */
+static Uint64 nd_vbl_deadline;
+/* Deadline for video interrupts */
+static Uint64 nd_video_deadline;
+
+static inline Uint64 nd_cyc_now(void) {
+    return nd_cyc_time + (nd_cyc_slice - nd_irq_countdown);
+}
 
 #define DP_IIC_MORE 0x20000000
 #define DP_IIC_BUSY 0x80000000
@@ -146,8 +161,12 @@ void nd_devs_init() {
     nd_mc.vram          = 0;
     nd_mc.dram          = 0;
     
-    nd_vbl_cyc_count    = VBL_CYC;
-    nd_video_cyc_count  = VIDEO_VBL_CYC;
+    nd_cyc_time         = 0;
+    nd_vbl_deadline     = VBL_CYC;
+    nd_video_deadline   = VIDEO_VBL_CYC;
+    nd_irq_pulse        = 0;
+    nd_irq_line         = 0;
+    nd_cyc_slice        = nd_irq_countdown = VBL_CYC < VIDEO_VBL_CYC ? VBL_CYC : VIDEO_VBL_CYC;
 	nd_set_speed_hack(0);
     
     nd_dp.iic_msgsz     = 0;
@@ -251,12 +270,54 @@ static const char* decodeBits(const char** bits, uae_u32 val) {
     return buffer;
 }
 
+/* Blanking bits of csr0 are computed from the VBL deadlines when read */
+static uae_u32 nd_mc_csr0(void) {
+    Uint64 now = nd_cyc_now();
+    Sint64 vbl = (Sint64)(nd_vbl_deadline - now);
+    Sint64 video = (Sint64)(nd_video_deadline - now);
+    
+    if(vbl >= V_FRONT && vbl < V_BACK)
+        nd_mc.csr0 &= ~CSR0_VBLANK;
+    else
+        nd_mc.csr0 |= CSR0_VBLANK;
+    
+    if(video >= VIDEO_V_FRONT && video < VIDEO_V_BACK)
+        nd_mc.csr0 &= ~CSR0_VIOBLANK;
+    else
+        nd_mc.csr0 |= CSR0_VIOBLANK;
+    
+    return nd_mc.csr0;
+}
+
+/* Recompute the interrupt line and the countdown to the next deadline */
+static void nd_update_interrupts(void) {
+    Uint64 next;
+    
+    nd_cyc_time = nd_cyc_now();
+    
+    nd_irq_line = nd_irq_pulse;
+    if ((nd_mc.csr0 & CSR0_i860_INT) && (nd_mc.csr0 & CSR0_i860_IMASK))
+        nd_irq_line = 1;
+    if ((nd_mc.csr0 & CSR0_BE_INT) && (nd_mc.csr0 & CSR0_BE_IMASK))
+        nd_irq_line = 1;
+    
+    /* A pulse lasts one instruction */
+    if (nd_irq_pulse) {
+        nd_cyc_slice = nd_irq_countdown = 1;
+        return;
+    }
+    
+    next = nd_vbl_deadline < nd_video_deadline ? nd_vbl_deadline : nd_video_deadline;
+    nd_cyc_slice = nd_irq_countdown = next > nd_cyc_time ? (int)(next - nd_cyc_time) : 0;
+}
+
 static const char* MC_RD_FORMAT   = "[ND] Memory controller %s read %08X at %08X";
 static const char* MC_RD_FORMAT_S = "[ND] Memory controller %s read (%s) at %08X";
 
 uae_u32 nd_mc_read_register(uaecptr addr) {
 	switch (addr&0x3FFF) {
 		case 0x0000:
+            nd_mc_csr0();
             Log_Printf(ND_LOG_IO_RD, MC_RD_FORMAT_S,"csr0", decodeBits(ND_CSR0_BITS, nd_mc.csr0),addr);
 			return nd_mc.csr0;
 		case 0x0010:
@@ -342,6 +403,7 @@ void nd_mc_write_register(uaecptr addr, uae_u32 val) {
             }
 			nd_set_speed_hack((val & 0x00008000) ? 0 : 1);		
             nd_mc.csr0 = val;
+            nd_update_interrupts();
             break;
         case 0x0010:
             Log_Printf(ND_LOG_IO_WR, MC_WR_FORMAT_S,"csr1", decodeBits(ND_CSR1_BITS, val),addr);
@@ -438,58 +500,27 @@ void nd_mc_write_register(uaecptr addr, uae_u32 val) {
 	}
 }
 
-/* interrupt processing */
-int nd_process_interrupts(int nHostCycles) {
-    //static Uint32 oldcsr0;
+/* interrupt processing, called by the i860 when nd_irq_countdown expires */
+void nd_process_interrupts(void) {
+    Uint64 now = nd_cyc_now();
     
-    nd_vbl_cyc_count   -= nHostCycles;
-    nd_video_cyc_count -= nHostCycles;
+    nd_irq_pulse = 0;
     
-    int result = 0;
-
-    if(nd_vbl_cyc_count >= V_FRONT && nd_vbl_cyc_count < V_BACK)
-        nd_mc.csr0 &= ~CSR0_VBLANK;
-    else
-        nd_mc.csr0 |= CSR0_VBLANK;
-
-    if(nd_vbl_cyc_count <= 0) {
+    if(now >= nd_vbl_deadline) {
         nd_mc.csr0 |= CSR0_VBL_INT;
         if(nd_mc.csr0 & CSR0_VBL_IMASK)
-            result = 1;
-        nd_vbl_cyc_count = VBL_CYC;
+            nd_irq_pulse = 1;
+        nd_vbl_deadline = now + VBL_CYC;
     }
-
-    if(nd_video_cyc_count >= VIDEO_V_FRONT && nd_video_cyc_count < VIDEO_V_BACK)
-        nd_mc.csr0 &= ~CSR0_VIOBLANK;
-    else
-        nd_mc.csr0 |= CSR0_VIOBLANK;
-
     
-    if(nd_video_cyc_count <= 0) {
+    if(now >= nd_video_deadline) {
         nd_mc.csr0 |= CSR0_VIOVBL_INT;
         if(nd_mc.csr0 & CSR0_VIOVBL_IMASK)
-            result = 1;
-        nd_video_cyc_count = VIDEO_VBL_CYC;
-    }
-    
-    if (nd_mc.csr0 & CSR0_i860_INT) {
-        if(nd_mc.csr0 & CSR0_i860_IMASK)
-            result = 1;
+            nd_irq_pulse = 1;
+        nd_video_deadline = now + VIDEO_VBL_CYC;
     }
     
-    if (nd_mc.csr0 & CSR0_BE_INT) {
-        if(nd_mc.csr0 & CSR0_BE_IMASK)
-            result = 1;
-    }
- 
-    /*
-    if(result && (oldcsr0 ^ nd_mc.csr0)) {
-        oldcsr0 = nd_mc.csr0;
-        Log_Printf(LOG_WARN, "[ND] external interrupt csr0=%s", decodeBits(ND_CSR0_BITS, nd_mc.csr0));
-    }
-    */
-    
-    return result;
+    nd_update_interrupts();
 }
 
 /* NeXTdimension device space */
@@ -683,7 +714,7 @@ bool nd_dbg_cmd(const char* buf) {
             return true;
         }
         case 'n': {
-            fprintf(stderr, "csr0        (%s)\n", decodeBits(ND_CSR0_BITS,    nd_mc.csr0));
+            fprintf(stderr, "csr0        (%s)\n", decodeBits(ND_CSR0_BITS,    nd_mc_csr0()));
             fprintf(stderr, "csr1        (%s)\n", decodeBits(ND_CSR1_BITS,    nd_mc.csr1));
             fprintf(stderr, "csr2        (%s)\n", decodeBits(ND_CSR2_BITS,    nd_mc.csr2));
             fprintf(stderr, "sid         (%s)\n", decodeBits(0,               nd_mc.sid));
@@ -6,6 +6,7 @@
 #include "nd_mem.h"
 #include "nd_devs.h"
 #include "nd_rom.h"
+#include "nextMemory.h"
 
 #if ENABLE_DIMENSION
 
@@ -34,8 +35,10 @@ uae_u32 ND_RAM_bankmask1;
 uae_u32 ND_RAM_bankmask2;
 uae_u32 ND_RAM_bankmask3;
 
-Uint8 ND_ram[64*1024*1024];
-Uint8 ND_vram[4*1024*1024];
+/* Allocated for the configured memory size in nd_memory_init() */
+Uint8 *ND_ram;
+Uint8 *ND_vram;
+static Uint32 ND_ram_size;
 Uint8 ND_rom[128*1024];
 
 Uint8 ND_dmem[512];
@@ -69,15 +72,28 @@ Uint8 ND_dmem[512];
 
 nd_addrbank *nd_mem_banks[65536];
 
+/* Host pointers to plain memory banks (RAM, VRAM), NULL for other banks */
+Uint8 *nd_mem_direct[65536];
+
 void nd_map_banks (nd_addrbank *bank, int start, int size)
 {
 	int bnr;
 	
-	for (bnr = start; bnr < start + size; bnr++)
+	for (bnr = start; bnr < start + size; bnr++) {
 		nd_put_mem_bank (bnr << 16, bank);
+		nd_mem_direct[bnr] = NULL;
+	}
 	return;
 }
 
+static void nd_map_direct (Uint8 *base, uae_u32 mask, int start, int size)
+{
+	int bnr;
+	
+	for (bnr = start; bnr < start + size; bnr++)
+		nd_mem_direct[bnr] = base + ((bnr << 16) & mask);
+}
+
 /* NeXTdimension RAM */
 static uae_u32 nd_ram_bank0_lget(uaecptr addr)
 {
@@ -510,11 +526,24 @@ static nd_addrbank nd_illegal_bank =
 static void nd_init_mem_banks (void)
 {
     int i;
-    for (i = 0; i < 65536; i++)
+    for (i = 0; i < 65536; i++) {
         nd_put_mem_bank (i<<16, &nd_illegal_bank);
+        nd_mem_direct[i] = NULL;
+    }
+}
+
+void nd_memory_uninit(void) {
+    NEXTMemory_FreeRam(ND_ram, ND_ram_size);
+    NEXTMemory_FreeRam(ND_vram, ND_VRAM_SIZE);
+    ND_ram = NULL;
+    ND_vram = NULL;
+    ND_ram_size = 0;
 }
 
 void nd_memory_init(void) {
+    Uint32 bankend;
+    int i;
+    
 	
 	write_log("[ND] Memory init: Memory size: %iMB\n",
               Configuration_CheckDimensionMemory(ConfigureParams.Dimension.nMemoryBankSize));
@@ -522,10 +551,28 @@ void nd_memory_init(void) {
     /* Initialize banks with error memory */
     nd_init_mem_banks();
     
+    /* Allocate host memory up to the end of the highest bank */
+    nd_memory_uninit();
+    for (i = 0; i < 4; i++) {
+        if (ConfigureParams.Dimension.nMemoryBankSize[i]) {
+            bankend = i*ND_RAM_BANKSIZE + (ConfigureParams.Dimension.nMemoryBankSize[i]<<20);
+            if (bankend > ND_ram_size)
+                ND_ram_size = bankend;
+        }
+    }
+    ND_ram = NEXTMemory_AllocRam(ND_ram_size);
+    ND_vram = NEXTMemory_AllocRam(ND_VRAM_SIZE);
+    if (!ND_ram || !ND_vram) {
+        write_log("[ND] Cannot allocate board memory\n");
+        nd_memory_uninit();
+        return;
+    }
+    
     /* Map main memory */
     if (ConfigureParams.Dimension.nMemoryBankSize[0]) {
         ND_RAM_bankmask0 = ND_RAM_BANKMASK|((ConfigureParams.Dimension.nMemoryBankSize[0]<<20)-1);
         nd_map_banks(&nd_ram_bank0, (ND_RAM_START+(0*ND_RAM_BANKSIZE))>>16, ND_RAM_BANKSIZE >> 16);
+        nd_map_direct(ND_ram, ND_RAM_bankmask0, (ND_RAM_START+(0*ND_RAM_BANKSIZE))>>16, ND_RAM_BANKSIZE >> 16);
         write_log("[ND] Mapping main memory bank0 at $%08x: %iMB\n",
                   (ND_RAM_START+(0*ND_RAM_BANKSIZE)), ConfigureParams.Dimension.nMemoryBankSize[0]);
     } else {
@@ -536,6 +583,7 @@ void nd_memory_init(void) {
     if (ConfigureParams.Dimension.nMemoryBankSize[1]) {
         ND_RAM_bankmask1 = ND_RAM_BANKMASK|((ConfigureParams.Dimension.nMemoryBankSize[1]<<20)-1);
         nd_map_banks(&nd_ram_bank1, (ND_RAM_START+(1*ND_RAM_BANKSIZE))>>16, ND_RAM_BANKSIZE >> 16);
+        nd_map_direct(ND_ram, ND_RAM_bankmask1, (ND_RAM_START+(1*ND_RAM_BANKSIZE))>>16, ND_RAM_BANKSIZE >> 16);
         write_log("[ND] Mapping main memory bank1 at $%08x: %iMB\n",
                   (ND_RAM_START+(1*ND_RAM_BANKSIZE)), ConfigureParams.Dimension.nMemoryBankSize[1]);
     } else {
@@ -546,6 +594,7 @@ void nd_memory_init(void) {
     if (ConfigureParams.Dimension.nMemoryBankSize[2]) {
         ND_RAM_bankmask2 = ND_RAM_BANKMASK|((ConfigureParams.Dimension.nMemoryBankSize[2]<<20)-1);
         nd_map_banks(&nd_ram_bank2, (ND_RAM_START+(2*ND_RAM_BANKSIZE))>>16, ND_RAM_BANKSIZE >> 16);
+        nd_map_direct(ND_ram, ND_RAM_bankmask2, (ND_RAM_START+(2*ND_RAM_BANKSIZE))>>16, ND_RAM_BANKSIZE >> 16);
         write_log("[ND] Mapping main memory bank2 at $%08x: %iMB\n",
                   (ND_RAM_START+(2*ND_RAM_BANKSIZE)), ConfigureParams.Dimension.nMemoryBankSize[2]);
     } else {
@@ -556,6 +605,7 @@ void nd_memory_init(void) {
     if (ConfigureParams.Dimension.nMemoryBankSize[3]) {
         ND_RAM_bankmask3 = ND_RAM_BANKMASK|((ConfigureParams.Dimension.nMemoryBankSize[3]<<20)-1);
         nd_map_banks(&nd_ram_bank3, (ND_RAM_START+(3*ND_RAM_BANKSIZE))>>16, ND_RAM_BANKSIZE >> 16);
+        nd_map_direct(ND_ram, ND_RAM_bankmask3, (ND_RAM_START+(3*ND_RAM_BANKSIZE))>>16, ND_RAM_BANKSIZE >> 16);
         write_log("[ND] Mapping main memory bank3 at $%08x: %iMB\n",
                   (ND_RAM_START+(3*ND_RAM_BANKSIZE)), ConfigureParams.Dimension.nMemoryBankSize[3]);
     } else {
@@ -566,6 +616,7 @@ void nd_memory_init(void) {
     
     write_log("[ND] Mapping video memory at $%08x: %iMB\n", ND_VRAM_START, ND_VRAM_SIZE/(1024*1024));
     nd_map_banks(&nd_vram_bank, ND_VRAM_START>>16, (4*ND_VRAM_SIZE)>>16);
+    nd_map_direct(ND_vram, ND_VRAM_MASK, ND_VRAM_START>>16, (4*ND_VRAM_SIZE)>>16);
 	
 	write_log("[ND] Mapping ROM at $%08x: %ikB\n", ND_EEPROM_START, ND_EEPROM_SIZE/1024);
 	nd_map_banks(&nd_rom_bank, ND_EEPROM_START>>16, ND_EEPROM_SIZE>>16);
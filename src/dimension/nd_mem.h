@@ -15,6 +15,7 @@ typedef struct {
 #define nd_call_mem_put_func(func, addr, v) ((*func)(addr, v))
 
 extern nd_addrbank *nd_mem_banks[65536];
+extern Uint8 *nd_mem_direct[65536];
 #define nd_get_mem_bank(addr) (*nd_mem_banks[bankindex(addr)])
 #define nd_put_mem_bank(addr, b) (nd_mem_banks[bankindex(addr)] = (b))
 
@@ -27,3 +28,4 @@ extern nd_addrbank *nd_mem_banks[65536];
 #define nd_cs8get(addr) (nd_call_mem_get_func(nd_get_mem_bank(addr).cs8geti, addr))
 
 void nd_memory_init(void);
+void nd_memory_uninit(void);
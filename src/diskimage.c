@@ -0,0 +1,429 @@
+/*
+  Hatari - diskimage.c
+
+  This file is distributed under the GNU Public License, version 2 or at
+  your option any later version. Read the file gpl.txt for details.
+
+  Block access to SCSI and MO disk images.
+
+  With an overlay the image file is only read. Written blocks go to a
+  sparse temporary file at the same offset as in the image and a bitmap
+  remembers which blocks are in there. Reads use the overlay for these
+  blocks and the image for all others. When the disk is closed the overlay
+  is either discarded or its blocks are written back to the image. Resets
+  keep the disk open (see DiskImage_Change), so the overlay lasts until
+  the disk is ejected or changed or the emulator quits.
+
+  Compressed images (see CDISK_HEADER, created with mkcdisk) are split into
+  chunks which are compressed separately, so that any block can be read
+  without decompressing the whole image. The last used chunks are kept
+  decompressed in a small cache. Compressed images are never written, all
+  changes go to an overlay.
+*/
+const char DiskImage_fileid[] = "Hatari diskimage.c : " __DATE__ " " __TIME__;
+
+#include <zlib.h>
+#include <SDL_endian.h>
+
+#include "main.h"
+#include "configuration.h"
+#include "file.h"
+#include "log.h"
+#include "diskimage.h"
+
+#if defined(WIN32)
+#define fseeko fseek
+#endif
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Seek to a block.
+ */
+static bool DiskImage_Seek(FILE *fp, Uint32 block, Uint32 blocksize)
+{
+	return fseeko(fp, (off_t)block * blocksize, SEEK_SET) == 0;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Check if a file is a compressed disk image.
+ */
+static bool DiskImage_IsCompressed(const char *filename)
+{
+	char magic[8];
+	FILE *fp;
+	bool ret;
+
+	fp = File_Open(filename, "rb");
+	if (!fp)
+		return false;
+	ret = fread(magic, sizeof(magic), 1, fp) == 1
+	      && memcmp(magic, CDISK_MAGIC, sizeof(magic)) == 0;
+	File_Close(fp);
+	return ret;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Read header and chunk index of a compressed disk image.
+ */
+static bool DiskImage_OpenCompressed(DISKIMAGE *img)
+{
+	CDISK_HEADER header;
+	Uint32 i;
+
+	if (fread(&header, sizeof(header), 1, img->base) != 1
+	    || SDL_SwapLE32(header.version) != CDISK_VERSION)
+		return false;
+
+	img->size = SDL_SwapLE64(header.size);
+	img->chunksize = SDL_SwapLE32(header.chunksize);
+	img->chunks = SDL_SwapLE32(header.chunks);
+	if (img->chunksize == 0 || img->chunksize > 16*1024*1024
+	    || img->chunks != (img->size + img->chunksize - 1) / img->chunksize)
+		return false;
+
+	img->chunkoffs = malloc((img->chunks + 1) * sizeof(Uint64));
+	img->packed = malloc(img->chunksize);
+	if (!img->chunkoffs || !img->packed
+	    || fread(img->chunkoffs, sizeof(Uint64), img->chunks + 1, img->base) != img->chunks + 1)
+		return false;
+
+	for (i = 0; i <= img->chunks; i++)
+	{
+		img->chunkoffs[i] = SDL_SwapLE64(img->chunkoffs[i]);
+		if (i > 0 && (img->chunkoffs[i] < img->chunkoffs[i-1]
+		              || img->chunkoffs[i] - img->chunkoffs[i-1] > img->chunksize))
+			return false;
+	}
+	return true;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Return a decompressed chunk of a compressed image from the cache,
+ * replacing the least recently used chunk on a miss.
+ */
+static Uint8 *DiskImage_GetChunk(DISKIMAGE *img, Uint32 chunk)
+{
+	DISKIMAGE_CACHE *entry = &img->cache[0];
+	Uint32 packedlen, rawlen;
+	uLongf destlen;
+	int i;
+
+	for (i = 0; i < DISKIMAGE_CACHE_CHUNKS; i++)
+	{
+		if (img->cache[i].lastuse && img->cache[i].chunk == chunk)
+		{
+			img->cache[i].lastuse = ++img->usecount;
+			return img->cache[i].data;
+		}
+		if (img->cache[i].lastuse < entry->lastuse)
+			entry = &img->cache[i];
+	}
+
+	if (!entry->data)
+	{
+		entry->data = malloc(img->chunksize);
+		if (!entry->data)
+			return NULL;
+	}
+	entry->lastuse = 0;
+
+	packedlen = img->chunkoffs[chunk + 1] - img->chunkoffs[chunk];
+	rawlen = img->size - (off_t)chunk * img->chunksize;
+	if (rawlen > img->chunksize)
+		rawlen = img->chunksize;
+
+	if (fseeko(img->base, img->chunkoffs[chunk], SEEK_SET) != 0)
+		return NULL;
+	if (packedlen == rawlen)
+	{
+		/* Stored uncompressed */
+		if (fread(entry->data, rawlen, 1, img->base) != 1)
+			return NULL;
+	}
+	else
+	{
+		destlen = rawlen;
+		if (fread(img->packed, packedlen, 1, img->base) != 1
+		    || uncompress(entry->data, &destlen, img->packed, packedlen) != Z_OK
+		    || destlen != rawlen)
+		{
+			Log_Printf(LOG_ERROR, "Disk image: chunk %u is corrupt.", chunk);
+			return NULL;
+		}
+	}
+
+	entry->chunk = chunk;
+	entry->lastuse = ++img->usecount;
+	return entry->data;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Read one block from a compressed image. Blocks can span two chunks.
+ */
+static bool DiskImage_ReadCompressed(DISKIMAGE *img, Uint32 block, Uint8 *buf)
+{
+	off_t pos = (off_t)block * img->blocksize;
+	Uint32 len = img->blocksize, offset, n;
+	Uint8 *data;
+
+	if (pos + len > img->size)
+		return false;
+
+	while (len > 0)
+	{
+		offset = pos % img->chunksize;
+		n = img->chunksize - offset;
+		if (n > len)
+			n = len;
+		data = DiskImage_GetChunk(img, pos / img->chunksize);
+		if (!data)
+			return false;
+		memcpy(buf, data + offset, n);
+		buf += n;
+		pos += n;
+		len -= n;
+	}
+	return true;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Free an image and its buffers.
+ */
+static void DiskImage_Free(DISKIMAGE *img)
+{
+	int i;
+
+	for (i = 0; i < DISKIMAGE_CACHE_CHUNKS; i++)
+		free(img->cache[i].data);
+	free(img->chunkoffs);
+	free(img->packed);
+	free(img->bitmap);
+	free(img->filename);
+	free(img);
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Open a disk image. Returns NULL if the file can not be opened.
+ */
+DISKIMAGE *DiskImage_Open(const char *filename, bool readonly, Uint32 blocksize, OVERLAY_MODE overlay)
+{
+	DISKIMAGE *img;
+	OVERLAY_MODE mode = overlay;
+	bool compressed;
+
+	/* No need for an overlay if the disk is not written */
+	if (readonly)
+		overlay = OVERLAY_OFF;
+
+	compressed = DiskImage_IsCompressed(filename);
+	if (compressed && !readonly && overlay != OVERLAY_DISCARD)
+	{
+		Log_Printf(LOG_WARN, "Disk image %s is compressed, changes will be discarded.", filename);
+		overlay = OVERLAY_DISCARD;
+	}
+
+	img = calloc(1, sizeof(DISKIMAGE));
+	if (!img)
+		return NULL;
+
+	img->filename = strdup(filename);
+	img->readonly = readonly;
+	img->mode = mode;
+	img->blocksize = blocksize;
+	img->overlay = overlay;
+
+	if (readonly || overlay == OVERLAY_DISCARD)
+		img->base = File_Open(filename, "rb");
+	else
+		img->base = File_Open(filename, "rb+");
+	if (!img->filename || !img->base)
+	{
+		if (img->base)
+			File_Close(img->base);
+		free(img->filename);
+		free(img);
+		return NULL;
+	}
+
+	if (compressed)
+	{
+		if (!DiskImage_OpenCompressed(img))
+		{
+			Log_Printf(LOG_ERROR, "Disk image %s: invalid compressed image.", filename);
+			File_Close(img->base);
+			DiskImage_Free(img);
+			return NULL;
+		}
+	}
+	else
+	{
+		img->size = File_Length(filename);
+		if (img->size < 0)
+			img->size = 0;
+	}
+	img->blocks = img->size / blocksize;
+
+	if (overlay != OVERLAY_OFF)
+	{
+		img->bitmap = calloc((img->blocks + 7) / 8, 1);
+		img->delta = tmpfile();
+		if (!img->bitmap || !img->delta)
+		{
+			Log_Printf(LOG_WARN, "Disk image %s: could not create overlay, writing to image.", filename);
+			if (img->delta)
+				fclose(img->delta);
+			free(img->bitmap);
+			img->delta = NULL;
+			img->bitmap = NULL;
+			img->overlay = OVERLAY_OFF;
+			if (overlay == OVERLAY_DISCARD && !compressed)
+			{
+				File_Close(img->base);
+				img->base = File_Open(filename, "rb+");
+				if (!img->base)
+				{
+					DiskImage_Free(img);
+					return NULL;
+				}
+			}
+		}
+	}
+
+	return img;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Write the blocks of the overlay back to the image.
+ */
+static void DiskImage_Commit(DISKIMAGE *img)
+{
+	Uint8 *buf;
+	Uint32 block, count = 0;
+
+	buf = malloc(img->blocksize);
+	if (!buf)
+		return;
+
+	for (block = 0; block < img->blocks; block++)
+	{
+		if (!(img->bitmap[block / 8] & (1 << (block % 8))))
+			continue;
+		if (!DiskImage_Seek(img->delta, block, img->blocksize)
+		    || fread(buf, img->blocksize, 1, img->delta) != 1
+		    || !DiskImage_Seek(img->base, block, img->blocksize)
+		    || fwrite(buf, img->blocksize, 1, img->base) != 1)
+		{
+			Log_Printf(LOG_ERROR, "Disk image: failed to commit block %u of overlay.", block);
+			break;
+		}
+		count++;
+	}
+	free(buf);
+
+	Log_Printf(LOG_INFO, "Disk image: committed %u of %u blocks from overlay.", count, img->written);
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Close a disk image, committing or discarding the overlay.
+ */
+void DiskImage_Close(DISKIMAGE *img)
+{
+	if (!img)
+		return;
+
+	if (img->delta)
+	{
+		if (img->overlay == OVERLAY_COMMIT)
+			DiskImage_Commit(img);
+		else if (img->written)
+			Log_Printf(LOG_INFO, "Disk image: discarded %u blocks of overlay.", img->written);
+		fclose(img->delta);
+	}
+	File_Close(img->base);
+	DiskImage_Free(img);
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Open a disk image in place of img. If img already is this image with
+ * the same settings it is kept, with its overlay. Otherwise img is closed.
+ */
+DISKIMAGE *DiskImage_Change(DISKIMAGE *img, const char *filename, bool readonly, Uint32 blocksize, OVERLAY_MODE overlay)
+{
+	if (img && strcmp(img->filename, filename) == 0 && img->readonly == readonly
+	    && img->blocksize == blocksize && img->mode == overlay)
+		return img;
+
+	DiskImage_Close(img);
+	return DiskImage_Open(filename, readonly, blocksize, overlay);
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Read one block. Returns false on error.
+ */
+bool DiskImage_Read(DISKIMAGE *img, Uint32 block, Uint8 *buf)
+{
+	FILE *fp = img->base;
+
+	if (img->delta && block < img->blocks && (img->bitmap[block / 8] & (1 << (block % 8))))
+		fp = img->delta;
+	else if (img->chunkoffs)
+		return DiskImage_ReadCompressed(img, block, buf);
+
+	if (!DiskImage_Seek(fp, block, img->blocksize))
+		return false;
+	return fread(buf, img->blocksize, 1, fp) == 1;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Write one block. Returns false on error. With an overlay, blocks
+ * behind the end of the image can not be written.
+ */
+bool DiskImage_Write(DISKIMAGE *img, Uint32 block, const Uint8 *buf)
+{
+	FILE *fp = img->base;
+
+	if (img->delta)
+	{
+		if (block >= img->blocks)
+			return false;
+		fp = img->delta;
+	}
+	else if (img->chunkoffs)
+	{
+		return false;
+	}
+
+	if (!DiskImage_Seek(fp, block, img->blocksize)
+	    || fwrite(buf, img->blocksize, 1, fp) != 1)
+		return false;
+
+	if (img->delta && !(img->bitmap[block / 8] & (1 << (block % 8))))
+	{
+		img->bitmap[block / 8] |= 1 << (block % 8);
+		img->written++;
+	}
+	return true;
+}
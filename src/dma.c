@@ -175,20 +175,21 @@ int get_interrupt_type(int channel) {
     }
 }
 
-void DMA_CSR_Read(void) { // 0x02000010, length of register is byte on 68030 based NeXT Computer
-    int channel = get_channel(IoAccessCurrentAddress);
+Uint32 DMA_CSR_Read(Uint32 addr, int size) { // 0x02000010, length of register is byte on 68030 based NeXT Computer
+    M68000_SyncCoprocessors();
+    int channel = get_channel(addr&~3);
     
-    IoMem[IoAccessCurrentAddress & IO_SEG_MASK] = dma[channel].csr;
-    IoMem[(IoAccessCurrentAddress+1) & IO_SEG_MASK] = IoMem[(IoAccessCurrentAddress+2) & IO_SEG_MASK] = IoMem[(IoAccessCurrentAddress+3) & IO_SEG_MASK] = 0x00; // just to be sure
-    Log_Printf(LOG_DMA_LEVEL,"DMA CSR read at $%08x val=$%02x PC=$%08x\n", IoAccessCurrentAddress, dma[channel].csr, m68k_getpc());
+    Log_Printf(LOG_DMA_LEVEL,"DMA CSR read at $%08x val=$%02x PC=$%08x\n", addr, dma[channel].csr, m68k_getpc());
+    return IoMem_RegisterRead(dma[channel].csr<<24, addr, size);
 }
 
-void DMA_CSR_Write(void) {
-    int channel = get_channel(IoAccessCurrentAddress);
+void DMA_CSR_Write(Uint32 addr, int size, Uint32 val) {
+    M68000_SyncCoprocessors();
+    int channel = get_channel(addr&~3);
     int interrupt = get_interrupt_type(channel);
-    Uint8 writecsr = IoMem[IoAccessCurrentAddress & IO_SEG_MASK]|IoMem[(IoAccessCurrentAddress+1) & IO_SEG_MASK]|IoMem[(IoAccessCurrentAddress+2) & IO_SEG_MASK]|IoMem[(IoAccessCurrentAddress+3) & IO_SEG_MASK];
+    Uint8 writecsr = val|(val>>8)|(val>>16)|(val>>24);
 
-    Log_Printf(LOG_DMA_LEVEL,"DMA CSR write at $%08x val=$%02x PC=$%08x\n", IoAccessCurrentAddress, writecsr, m68k_getpc());
+    Log_Printf(LOG_DMA_LEVEL,"DMA CSR write at $%08x val=$%02x PC=$%08x\n", addr, writecsr, m68k_getpc());
     
     /* For debugging */
     if(writecsr&DMA_DEV2M)
@@ -255,113 +256,113 @@ void DMA_CSR_Write(void) {
     set_interrupt(interrupt, RELEASE_INT); // experimental
 }
 
-void DMA_Saved_Next_Read(void) { // 0x02004000
-    int channel = get_channel(IoAccessCurrentAddress-0x3FF0);
-    IoMem_WriteLong(IoAccessCurrentAddress & IO_SEG_MASK, dma[channel].saved_next);
- 	Log_Printf(LOG_DMA_LEVEL,"DMA SNext read at $%08x val=$%08x PC=$%08x\n", IoAccessCurrentAddress, dma[channel].saved_next, m68k_getpc());
+Uint32 DMA_Saved_Next_Read(Uint32 addr, int size) { // 0x02004000
+    int channel = get_channel((addr&~3)-0x3FF0);
+ 	Log_Printf(LOG_DMA_LEVEL,"DMA SNext read at $%08x val=$%08x PC=$%08x\n", addr, dma[channel].saved_next, m68k_getpc());
+    return IoMem_RegisterRead(dma[channel].saved_next, addr, size);
 }
 
-void DMA_Saved_Next_Write(void) {
-    int channel = get_channel(IoAccessCurrentAddress-0x3FF0);
-    dma[channel].saved_next = IoMem_ReadLong(IoAccessCurrentAddress & IO_SEG_MASK);
-    Log_Printf(LOG_DMA_LEVEL,"DMA SNext write at $%08x val=$%08x PC=$%08x\n", IoAccessCurrentAddress, dma[channel].saved_next, m68k_getpc());
+void DMA_Saved_Next_Write(Uint32 addr, int size, Uint32 val) {
+    int channel = get_channel((addr&~3)-0x3FF0);
+    dma[channel].saved_next = IoMem_RegisterWrite(dma[channel].saved_next, addr, size, val);
+    Log_Printf(LOG_DMA_LEVEL,"DMA SNext write at $%08x val=$%08x PC=$%08x\n", addr, dma[channel].saved_next, m68k_getpc());
 }
 
-void DMA_Saved_Limit_Read(void) { // 0x02004004
-    int channel = get_channel(IoAccessCurrentAddress-0x3FF4);
-    IoMem_WriteLong(IoAccessCurrentAddress & IO_SEG_MASK, dma[channel].saved_limit);
- 	Log_Printf(LOG_DMA_LEVEL,"DMA SLimit read at $%08x val=$%08x PC=$%08x\n", IoAccessCurrentAddress, dma[channel].saved_limit, m68k_getpc());
+Uint32 DMA_Saved_Limit_Read(Uint32 addr, int size) { // 0x02004004
+    int channel = get_channel((addr&~3)-0x3FF4);
+ 	Log_Printf(LOG_DMA_LEVEL,"DMA SLimit read at $%08x val=$%08x PC=$%08x\n", addr, dma[channel].saved_limit, m68k_getpc());
+    return IoMem_RegisterRead(dma[channel].saved_limit, addr, size);
 }
 
-void DMA_Saved_Limit_Write(void) {
-    int channel = get_channel(IoAccessCurrentAddress-0x3FF4);
-    dma[channel].saved_limit = IoMem_ReadLong(IoAccessCurrentAddress & IO_SEG_MASK);
-    Log_Printf(LOG_DMA_LEVEL,"DMA SLimit write at $%08x val=$%08x PC=$%08x\n", IoAccessCurrentAddress, dma[channel].saved_limit, m68k_getpc());
+void DMA_Saved_Limit_Write(Uint32 addr, int size, Uint32 val) {
+    int channel = get_channel((addr&~3)-0x3FF4);
+    dma[channel].saved_limit = IoMem_RegisterWrite(dma[channel].saved_limit, addr, size, val);
+    Log_Printf(LOG_DMA_LEVEL,"DMA SLimit write at $%08x val=$%08x PC=$%08x\n", addr, dma[channel].saved_limit, m68k_getpc());
 }
 
-void DMA_Saved_Start_Read(void) { // 0x02004008
-    int channel = get_channel(IoAccessCurrentAddress-0x3FF8);
-    IoMem_WriteLong(IoAccessCurrentAddress & IO_SEG_MASK, dma[channel].saved_start);
- 	Log_Printf(LOG_DMA_LEVEL,"DMA SStart read at $%08x val=$%08x PC=$%08x\n", IoAccessCurrentAddress, dma[channel].saved_start, m68k_getpc());
+Uint32 DMA_Saved_Start_Read(Uint32 addr, int size) { // 0x02004008
+    int channel = get_channel((addr&~3)-0x3FF8);
+ 	Log_Printf(LOG_DMA_LEVEL,"DMA SStart read at $%08x val=$%08x PC=$%08x\n", addr, dma[channel].saved_start, m68k_getpc());
+    return IoMem_RegisterRead(dma[channel].saved_start, addr, size);
 }
 
-void DMA_Saved_Start_Write(void) {
-    int channel = get_channel(IoAccessCurrentAddress-0x3FF8);
-    dma[channel].saved_start = IoMem_ReadLong(IoAccessCurrentAddress & IO_SEG_MASK);
-    Log_Printf(LOG_DMA_LEVEL,"DMA SStart write at $%08x val=$%08x PC=$%08x\n", IoAccessCurrentAddress, dma[channel].saved_start, m68k_getpc());
+void DMA_Saved_Start_Write(Uint32 addr, int size, Uint32 val) {
+    int channel = get_channel((addr&~3)-0x3FF8);
+    dma[channel].saved_start = IoMem_RegisterWrite(dma[channel].saved_start, addr, size, val);
+    Log_Printf(LOG_DMA_LEVEL,"DMA SStart write at $%08x val=$%08x PC=$%08x\n", addr, dma[channel].saved_start, m68k_getpc());
 }
 
-void DMA_Saved_Stop_Read(void) { // 0x0200400c
-    int channel = get_channel(IoAccessCurrentAddress-0x3FFC);
-    IoMem_WriteLong(IoAccessCurrentAddress & IO_SEG_MASK, dma[channel].saved_stop);
- 	Log_Printf(LOG_DMA_LEVEL,"DMA SStop read at $%08x val=$%08x PC=$%08x\n", IoAccessCurrentAddress, dma[channel].saved_stop, m68k_getpc());
+Uint32 DMA_Saved_Stop_Read(Uint32 addr, int size) { // 0x0200400c
+    int channel = get_channel((addr&~3)-0x3FFC);
+ 	Log_Printf(LOG_DMA_LEVEL,"DMA SStop read at $%08x val=$%08x PC=$%08x\n", addr, dma[channel].saved_stop, m68k_getpc());
+    return IoMem_RegisterRead(dma[channel].saved_stop, addr, size);
 }
 
-void DMA_Saved_Stop_Write(void) {
-    int channel = get_channel(IoAccessCurrentAddress-0x3FFC);
-    dma[channel].saved_stop = IoMem_ReadLong(IoAccessCurrentAddress & IO_SEG_MASK);
-    Log_Printf(LOG_DMA_LEVEL,"DMA SStop write at $%08x val=$%08x PC=$%08x\n", IoAccessCurrentAddress, dma[channel].saved_stop, m68k_getpc());
+void DMA_Saved_Stop_Write(Uint32 addr, int size, Uint32 val) {
+    int channel = get_channel((addr&~3)-0x3FFC);
+    dma[channel].saved_stop = IoMem_RegisterWrite(dma[channel].saved_stop, addr, size, val);
+    Log_Printf(LOG_DMA_LEVEL,"DMA SStop write at $%08x val=$%08x PC=$%08x\n", addr, dma[channel].saved_stop, m68k_getpc());
 }
 
-void DMA_Next_Read(void) { // 0x02004010
-    int channel = get_channel(IoAccessCurrentAddress-0x4000);
-    IoMem_WriteLong(IoAccessCurrentAddress & IO_SEG_MASK, dma[channel].next);
- 	Log_Printf(LOG_DMA_LEVEL,"DMA Next read at $%08x val=$%08x PC=$%08x\n", IoAccessCurrentAddress, dma[channel].next, m68k_getpc());
+Uint32 DMA_Next_Read(Uint32 addr, int size) { // 0x02004010
+    int channel = get_channel((addr&~3)-0x4000);
+ 	Log_Printf(LOG_DMA_LEVEL,"DMA Next read at $%08x val=$%08x PC=$%08x\n", addr, dma[channel].next, m68k_getpc());
+    return IoMem_RegisterRead(dma[channel].next, addr, size);
 }
 
-void DMA_Next_Write(void) {
-    int channel = get_channel(IoAccessCurrentAddress-0x4000);
-    dma[channel].next = IoMem_ReadLong(IoAccessCurrentAddress & IO_SEG_MASK);
-    Log_Printf(LOG_DMA_LEVEL,"DMA Next write at $%08x val=$%08x PC=$%08x\n", IoAccessCurrentAddress, dma[channel].next, m68k_getpc());
+void DMA_Next_Write(Uint32 addr, int size, Uint32 val) {
+    int channel = get_channel((addr&~3)-0x4000);
+    dma[channel].next = IoMem_RegisterWrite(dma[channel].next, addr, size, val);
+    Log_Printf(LOG_DMA_LEVEL,"DMA Next write at $%08x val=$%08x PC=$%08x\n", addr, dma[channel].next, m68k_getpc());
 }
 
-void DMA_Limit_Read(void) { // 0x02004014
-    int channel = get_channel(IoAccessCurrentAddress-0x4004);
-    IoMem_WriteLong(IoAccessCurrentAddress & IO_SEG_MASK, dma[channel].limit);
- 	Log_Printf(LOG_DMA_LEVEL,"DMA Limit read at $%08x val=$%08x PC=$%08x\n", IoAccessCurrentAddress, dma[channel].limit, m68k_getpc());
+Uint32 DMA_Limit_Read(Uint32 addr, int size) { // 0x02004014
+    int channel = get_channel((addr&~3)-0x4004);
+ 	Log_Printf(LOG_DMA_LEVEL,"DMA Limit read at $%08x val=$%08x PC=$%08x\n", addr, dma[channel].limit, m68k_getpc());
+    return IoMem_RegisterRead(dma[channel].limit, addr, size);
 }
 
-void DMA_Limit_Write(void) {
-    int channel = get_channel(IoAccessCurrentAddress-0x4004);
-    dma[channel].limit = IoMem_ReadLong(IoAccessCurrentAddress & IO_SEG_MASK);
-    Log_Printf(LOG_DMA_LEVEL,"DMA Limit write at $%08x val=$%08x PC=$%08x\n", IoAccessCurrentAddress, dma[channel].limit, m68k_getpc());
+void DMA_Limit_Write(Uint32 addr, int size, Uint32 val) {
+    int channel = get_channel((addr&~3)-0x4004);
+    dma[channel].limit = IoMem_RegisterWrite(dma[channel].limit, addr, size, val);
+    Log_Printf(LOG_DMA_LEVEL,"DMA Limit write at $%08x val=$%08x PC=$%08x\n", addr, dma[channel].limit, m68k_getpc());
 }
 
-void DMA_Start_Read(void) { // 0x02004018
-    int channel = get_channel(IoAccessCurrentAddress-0x4008);
-    IoMem_WriteLong(IoAccessCurrentAddress & IO_SEG_MASK, dma[channel].start);
- 	Log_Printf(LOG_DMA_LEVEL,"DMA Start read at $%08x val=$%08x PC=$%08x\n", IoAccessCurrentAddress, dma[channel].start, m68k_getpc());
+Uint32 DMA_Start_Read(Uint32 addr, int size) { // 0x02004018
+    int channel = get_channel((addr&~3)-0x4008);
+ 	Log_Printf(LOG_DMA_LEVEL,"DMA Start read at $%08x val=$%08x PC=$%08x\n", addr, dma[channel].start, m68k_getpc());
+    return IoMem_RegisterRead(dma[channel].start, addr, size);
 }
 
-void DMA_Start_Write(void) {
-    int channel = get_channel(IoAccessCurrentAddress-0x4008);
-    dma[channel].start = IoMem_ReadLong(IoAccessCurrentAddress & IO_SEG_MASK);
-    Log_Printf(LOG_DMA_LEVEL,"DMA Start write at $%08x val=$%08x PC=$%08x\n", IoAccessCurrentAddress, dma[channel].start, m68k_getpc());
+void DMA_Start_Write(Uint32 addr, int size, Uint32 val) {
+    int channel = get_channel((addr&~3)-0x4008);
+    dma[channel].start = IoMem_RegisterWrite(dma[channel].start, addr, size, val);
+    Log_Printf(LOG_DMA_LEVEL,"DMA Start write at $%08x val=$%08x PC=$%08x\n", addr, dma[channel].start, m68k_getpc());
 }
 
-void DMA_Stop_Read(void) { // 0x0200401c
-    int channel = get_channel(IoAccessCurrentAddress-0x400C);
-    IoMem_WriteLong(IoAccessCurrentAddress & IO_SEG_MASK, dma[channel].stop);
- 	Log_Printf(LOG_DMA_LEVEL,"DMA Stop read at $%08x val=$%08x PC=$%08x\n", IoAccessCurrentAddress, dma[channel].stop, m68k_getpc());
+Uint32 DMA_Stop_Read(Uint32 addr, int size) { // 0x0200401c
+    int channel = get_channel((addr&~3)-0x400C);
+ 	Log_Printf(LOG_DMA_LEVEL,"DMA Stop read at $%08x val=$%08x PC=$%08x\n", addr, dma[channel].stop, m68k_getpc());
+    return IoMem_RegisterRead(dma[channel].stop, addr, size);
 }
 
-void DMA_Stop_Write(void) {
-    int channel = get_channel(IoAccessCurrentAddress-0x400C);
-    dma[channel].stop = IoMem_ReadLong(IoAccessCurrentAddress & IO_SEG_MASK);
-    Log_Printf(LOG_DMA_LEVEL,"DMA Stop write at $%08x val=$%08x PC=$%08x\n", IoAccessCurrentAddress, dma[channel].stop, m68k_getpc());
+void DMA_Stop_Write(Uint32 addr, int size, Uint32 val) {
+    int channel = get_channel((addr&~3)-0x400C);
+    dma[channel].stop = IoMem_RegisterWrite(dma[channel].stop, addr, size, val);
+    Log_Printf(LOG_DMA_LEVEL,"DMA Stop write at $%08x val=$%08x PC=$%08x\n", addr, dma[channel].stop, m68k_getpc());
 }
 
-void DMA_Init_Read(void) { // 0x02004210
-    int channel = get_channel(IoAccessCurrentAddress-0x4200);
-    IoMem_WriteLong(IoAccessCurrentAddress & IO_SEG_MASK, dma[channel].next);
- 	Log_Printf(LOG_DMA_LEVEL,"DMA Init read at $%08x val=$%08x PC=$%08x\n", IoAccessCurrentAddress, dma[channel].next, m68k_getpc());
+Uint32 DMA_Init_Read(Uint32 addr, int size) { // 0x02004210
+    int channel = get_channel((addr&~3)-0x4200);
+ 	Log_Printf(LOG_DMA_LEVEL,"DMA Init read at $%08x val=$%08x PC=$%08x\n", addr, dma[channel].next, m68k_getpc());
+    return IoMem_RegisterRead(dma[channel].next, addr, size);
 }
 
-void DMA_Init_Write(void) {
-    int channel = get_channel(IoAccessCurrentAddress-0x4200);
-    dma[channel].next = IoMem_ReadLong(IoAccessCurrentAddress & IO_SEG_MASK);
+void DMA_Init_Write(Uint32 addr, int size, Uint32 val) {
+    int channel = get_channel((addr&~3)-0x4200);
+    dma[channel].next = IoMem_RegisterWrite(dma[channel].next, addr, size, val);
     dma_initialize_buffer(channel, dma[channel].next&0xF);
-    Log_Printf(LOG_DMA_LEVEL,"DMA Init write at $%08x val=$%08x PC=$%08x\n", IoAccessCurrentAddress, dma[channel].next, m68k_getpc());
+    Log_Printf(LOG_DMA_LEVEL,"DMA Init write at $%08x val=$%08x PC=$%08x\n", addr, dma[channel].next, m68k_getpc());
 }
 
 /* Initialize DMA internal buffer */
@@ -936,19 +937,23 @@ void dma_m2m_write_memory(void) {
 /* Channel DSP */
 #define LOG_DMA_DSP_LEVEL	LOG_DEBUG
 
-void dma_dsp_write_memory(Uint8 val) {
+/* Write a burst of bytes from the DSP host interface to memory, returns bytes written */
+int dma_dsp_write_memory(const Uint8 *buf, int len) {
+	int i = 0;
+	
 	Log_Printf(LOG_DMA_DSP_LEVEL, "[DMA] Channel DSP: Write to memory at $%08x, %i bytes",
 			   dma[CHANNEL_DSP].next,dma[CHANNEL_DSP].limit-dma[CHANNEL_DSP].next);
 	
 	if (!(dma[CHANNEL_DSP].csr&DMA_ENABLE)) {
 		Log_Printf(LOG_WARN, "[DMA] Channel DSP: Error! DMA not enabled!");
-		return;
+		return 0;
 	}
 	
 	TRY(prb) {
-		if (dma[CHANNEL_DSP].next<dma[CHANNEL_DSP].limit) {
-			NEXTMemory_WriteByte(dma[CHANNEL_DSP].next, val);
+		while (i<len && dma[CHANNEL_DSP].next<dma[CHANNEL_DSP].limit) {
+			NEXTMemory_WriteByte(dma[CHANNEL_DSP].next, buf[i]);
 			dma[CHANNEL_DSP].next++;
+			i++;
 		}
 	} CATCH(prb) {
 		Log_Printf(LOG_WARN, "[DMA] Channel DSP: Bus error while writing to %08x",dma[CHANNEL_DSP].next);
@@ -956,39 +961,51 @@ void dma_dsp_write_memory(Uint8 val) {
 		dma[CHANNEL_DSP].csr |= (DMA_COMPLETE|DMA_BUSEXC);
 	} ENDTRY
 	
-	if (dma[CHANNEL_DSP].next==dma[CHANNEL_DSP].limit) {
+	if (i>0 && dma[CHANNEL_DSP].next==dma[CHANNEL_DSP].limit) {
 		DSP_SetIRQB();
 		dma_interrupt(CHANNEL_DSP);
 	}
+	return i;
 }
 
-Uint8 dma_dsp_read_memory(void) {
-	Uint8 val = 0;
+/* Read a burst of bytes from memory for the DSP host interface, returns bytes read */
+int dma_dsp_read_memory(Uint8 *buf, int len) {
+	int i = 0;
 	
 	Log_Printf(LOG_DMA_DSP_LEVEL, "[DMA] Channel DSP: Read from memory at $%08x, %i bytes",
 			   dma[CHANNEL_DSP].next,dma[CHANNEL_DSP].limit-dma[CHANNEL_DSP].next);
 	
 	if (!(dma[CHANNEL_DSP].csr&DMA_ENABLE)) {
 		Log_Printf(LOG_WARN, "[DMA] Channel DSP: Error! DMA not enabled!");
-		return val;
+		return 0;
 	}
 	
 	TRY(prb) {
-		if (dma[CHANNEL_DSP].next<dma[CHANNEL_DSP].limit) {
-			val = NEXTMemory_ReadByte(dma[CHANNEL_DSP].next);
+		while (i<len && dma[CHANNEL_DSP].next<dma[CHANNEL_DSP].limit) {
+			buf[i] = NEXTMemory_ReadByte(dma[CHANNEL_DSP].next);
 			dma[CHANNEL_DSP].next++;
+			i++;
 		}
 	} CATCH(prb) {
-		Log_Printf(LOG_WARN, "[DMA] Channel DSP: Bus error while writing to %08x",dma[CHANNEL_DSP].next);
+		Log_Printf(LOG_WARN, "[DMA] Channel DSP: Bus error while reading from %08x",dma[CHANNEL_DSP].next);
 		dma[CHANNEL_DSP].csr &= ~DMA_ENABLE;
 		dma[CHANNEL_DSP].csr |= (DMA_COMPLETE|DMA_BUSEXC);
 	} ENDTRY
 	
-	if (dma[CHANNEL_DSP].next==dma[CHANNEL_DSP].limit) {
+	if (i>0 && dma[CHANNEL_DSP].next==dma[CHANNEL_DSP].limit) {
 		DSP_SetIRQB();
 		dma_interrupt(CHANNEL_DSP);
 	}
-	return val;
+	return i;
+}
+
+/* Number of bytes left in the current DSP transfer */
+int dma_dsp_pending(void) {
+	if (!(dma[CHANNEL_DSP].csr&DMA_ENABLE) ||
+		!(dma[CHANNEL_DSP].next<dma[CHANNEL_DSP].limit)) {
+		return 0;
+	}
+	return dma[CHANNEL_DSP].limit-dma[CHANNEL_DSP].next;
 }
 
 bool dma_dsp_ready(void) {
@@ -1062,20 +1079,21 @@ void dma_scc_read_memory(void) {
 /* CSR masks */
 #define TDMA_CMD_MASK    0x00FB0000
 
-void TDMA_CSR_Read(void) { // 0x02000010, length of register is byte on 68030 based NeXT Computer
-	int channel = get_channel(IoAccessCurrentAddress);
+Uint32 TDMA_CSR_Read(Uint32 addr, int size) { // 0x02000010, length of register is byte on 68030 based NeXT Computer
+    M68000_SyncCoprocessors();
+	int channel = get_channel(addr&~3);
 	
-	IoMem_WriteLong(IoAccessCurrentAddress & IO_SEG_MASK, dma[channel].csr<<24);
-
-	Log_Printf(LOG_DMA_LEVEL,"DMA CSR read at $%08x val=$%08x PC=$%08x\n", IoAccessCurrentAddress, dma[channel].csr<<24, m68k_getpc());
+	Log_Printf(LOG_DMA_LEVEL,"DMA CSR read at $%08x val=$%08x PC=$%08x\n", addr, dma[channel].csr<<24, m68k_getpc());
+	return IoMem_RegisterRead(dma[channel].csr<<24, addr, size);
 }
 
-void TDMA_CSR_Write(void) {
-	int channel = get_channel(IoAccessCurrentAddress);
+void TDMA_CSR_Write(Uint32 addr, int size, Uint32 val) {
+    M68000_SyncCoprocessors();
+	int channel = get_channel(addr&~3);
 	int interrupt = get_interrupt_type(channel);
-	Uint32 writecsr = IoMem_ReadLong(IoAccessCurrentAddress & IO_SEG_MASK);
+	Uint32 writecsr = IoMem_RegisterWrite(0, addr, size, val);
 
-	Log_Printf(LOG_DMA_LEVEL,"DMA CSR write at $%08x val=$%08x PC=$%08x\n", IoAccessCurrentAddress, writecsr, m68k_getpc());
+	Log_Printf(LOG_DMA_LEVEL,"DMA CSR write at $%08x val=$%08x PC=$%08x\n", addr, writecsr, m68k_getpc());
 	
 	/* For debugging */
 	if(writecsr&TDMA_DEV2M)
@@ -1126,9 +1144,9 @@ void TDMA_CSR_Write(void) {
 	set_interrupt(interrupt, RELEASE_INT);
 }
 
-void TDMA_Saved_Next_Read(void) { // 0x02004050
-	IoMem_WriteLong(IoAccessCurrentAddress & IO_SEG_MASK, saved_next_turbo);
-	Log_Printf(LOG_DMA_LEVEL,"TDMA SNext read at $%08x val=$%08x PC=$%08x\n", IoAccessCurrentAddress, saved_next_turbo, m68k_getpc());
+Uint32 TDMA_Saved_Next_Read(Uint32 addr, int size) { // 0x02004050
+	Log_Printf(LOG_DMA_LEVEL,"TDMA SNext read at $%08x val=$%08x PC=$%08x\n", addr, saved_next_turbo, m68k_getpc());
+	return IoMem_RegisterRead(saved_next_turbo, addr, size);
 }
 
 /* Flush DMA buffer */
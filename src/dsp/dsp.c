@@ -34,6 +34,7 @@
 #include "m68000.h"
 #include "sysReg.h"
 #include "dma.h"
+#include "perfstats.h"
 
 #if ENABLE_DSP_EMU
 #include "dsp_cpu.h"
@@ -134,11 +135,19 @@ void DSP_SetIRQB(void)
 
 /**
  * Handling DMA transfers.
+ * Whole host port words are moved in one burst, for as long as the host
+ * interface keeps requesting data and the DMA channel has bytes left.
  */
 void DSP_HandleDMA(void)
 {
 #if ENABLE_DSP_EMU
-	if (dsp_core.dma_mode && dsp_core.dma_request && dma_dsp_ready()) {
+	Uint8 buf[5];
+	int i, len, unpacked;
+
+	/* Handle unpacked mode on non-Turbo systems */
+	unpacked = dsp_dma_unpacked && !ConfigureParams.System.bTurbo;
+
+	while (dsp_core.dma_mode && dsp_core.dma_request && dma_dsp_ready()) {
 		/* Set the counter according to selected DMA mode */
 		if (dsp_core.dma_address_counter==0) {
 			dsp_core.dma_address_counter = 4-dsp_core.dma_mode;
@@ -147,23 +156,39 @@ void DSP_HandleDMA(void)
 					dsp_core.dma_address_counter = 4;
 			}
 		}
-		dsp_core.dma_address_counter--;
-		
+
+		/* Bytes of the current word the DMA can still provide */
+		len = dma_dsp_pending();
+		if (len > dsp_core.dma_address_counter) {
+			len = dsp_core.dma_address_counter;
+		}
+
 		/* Read or write via DMA */
 		if (dsp_core.dma_direction==(1<<CPU_HOST_ICR_TREQ)) {
-			dsp_core_write_host(CPU_HOST_TRXL-dsp_core.dma_address_counter, dma_dsp_read_memory());
+			len = dma_dsp_read_memory(buf, len);
+			for (i = 0; i < len; i++) {
+				dsp_core.dma_address_counter--;
+				dsp_core_write_host(CPU_HOST_TRXL-dsp_core.dma_address_counter, buf[i]);
+			}
+			if (unpacked && dsp_core.dma_address_counter==0) {
+				buf[0] = 0;
+				dma_dsp_read_memory(buf, 1);
+				dsp_core_write_host(CPU_HOST_TRX0, buf[0]);
+			}
 		} else {
-			dma_dsp_write_memory(dsp_core_read_host(CPU_HOST_TRXL-dsp_core.dma_address_counter));
-		}
-		
-		/* Handle unpacked mode on non-Turbo systems */
-		if (dsp_dma_unpacked && dsp_core.dma_address_counter==0 && !ConfigureParams.System.bTurbo) {
-			if (dsp_core.dma_direction==(1<<CPU_HOST_ICR_TREQ)) {
-				dsp_core_write_host(CPU_HOST_TRX0, dma_dsp_read_memory());
-			} else {
-				dma_dsp_write_memory(dsp_core_read_host(CPU_HOST_TRX0));
+			for (i = 0; i < len; i++) {
+				dsp_core.dma_address_counter--;
+				buf[i] = dsp_core_read_host(CPU_HOST_TRXL-dsp_core.dma_address_counter);
 			}
-			return;
+			if (unpacked && dsp_core.dma_address_counter==0) {
+				buf[len++] = dsp_core_read_host(CPU_HOST_TRX0);
+			}
+			dma_dsp_write_memory(buf, len);
+		}
+
+		/* Transfer ended in the middle of a word */
+		if (dsp_core.dma_address_counter) {
+			break;
 		}
 	}
 #endif
@@ -272,6 +297,9 @@ void DSP_MemorySnapShot_Capture(bool bSave)
 	MemorySnapShot_Store(&bDspEnabled, sizeof(bDspEnabled));
 	MemorySnapShot_Store(&dsp_core, sizeof(dsp_core));
 	MemorySnapShot_Store(&save_cycles, sizeof(save_cycles));
+
+	if (!bSave)
+		dsp56k_flush_icache();
 #endif
 }
 
@@ -281,6 +309,8 @@ void DSP_MemorySnapShot_Capture(bool bSave)
 void DSP_Run(int nHostCycles)
 {
 #if ENABLE_DSP_EMU
+	nPerfDspCycles += nHostCycles * 2;
+
 	if (dsp_core.running == 0)
 		return;
 	
@@ -291,7 +321,15 @@ void DSP_Run(int nHostCycles)
 	
 	while (save_cycles > 0)
 	{
+		/* Don't interpret a poll loop until what it waits for happens */
+		if (dsp_core.idle_state) {
+			save_cycles = dsp56k_skip_idle(save_cycles);
+			if (save_cycles <= 0)
+				break;
+		}
 		dsp56k_execute_instruction();
+		nPerfDspInstr++;
+		nPerfDspBusyCycles += dsp_core.instr_cycle;
 		save_cycles -= dsp_core.instr_cycle;
 	}
 	
@@ -940,6 +978,7 @@ void DSP_HandleWriteAccess(void)
 
 
 void DSP_ICR_Read(void) { // 0x02008000
+	M68000_SyncCoprocessors();
 #if ENABLE_DSP_EMU
 	if (bDspEmulated)
 		IoMem[IoAccessCurrentAddress & IO_SEG_MASK] = dsp_core_read_host(CPU_HOST_ICR);
@@ -952,6 +991,7 @@ void DSP_ICR_Read(void) { // 0x02008000
 }
 
 void DSP_ICR_Write(void) {
+	M68000_SyncCoprocessors();
 #if ENABLE_DSP_EMU
 	if (bDspEmulated)
 		dsp_core_write_host(CPU_HOST_ICR, IoMem[IoAccessCurrentAddress & IO_SEG_MASK]);
@@ -960,6 +1000,7 @@ void DSP_ICR_Write(void) {
 }
 
 void DSP_CVR_Read(void) { // 0x02008001
+	M68000_SyncCoprocessors();
 #if ENABLE_DSP_EMU
 	if (bDspEmulated)
 		IoMem[IoAccessCurrentAddress & IO_SEG_MASK] = dsp_core_read_host(CPU_HOST_CVR);
@@ -972,6 +1013,7 @@ void DSP_CVR_Read(void) { // 0x02008001
 }
 
 void DSP_CVR_Write(void) {
+	M68000_SyncCoprocessors();
 #if ENABLE_DSP_EMU
 	if (bDspEmulated)
 		dsp_core_write_host(CPU_HOST_CVR, IoMem[IoAccessCurrentAddress & IO_SEG_MASK]);
@@ -980,6 +1022,7 @@ void DSP_CVR_Write(void) {
 }
 
 void DSP_ISR_Read(void) { // 0x02008002
+	M68000_SyncCoprocessors();
 #if ENABLE_DSP_EMU
 	if (bDspEmulated)
 		IoMem[IoAccessCurrentAddress & IO_SEG_MASK] = dsp_core_read_host(CPU_HOST_ISR);
@@ -992,6 +1035,7 @@ void DSP_ISR_Read(void) { // 0x02008002
 }
 
 void DSP_ISR_Write(void) {
+	M68000_SyncCoprocessors();
 #if ENABLE_DSP_EMU
 	if (bDspEmulated)
 		dsp_core_write_host(CPU_HOST_ISR, IoMem[IoAccessCurrentAddress & IO_SEG_MASK]);
@@ -1000,6 +1044,7 @@ void DSP_ISR_Write(void) {
 }
 
 void DSP_IVR_Read(void) { // 0x02008003
+	M68000_SyncCoprocessors();
 #if ENABLE_DSP_EMU
 	if (bDspEmulated)
 		IoMem[IoAccessCurrentAddress & IO_SEG_MASK] = dsp_core_read_host(CPU_HOST_IVR);
@@ -1012,6 +1057,7 @@ void DSP_IVR_Read(void) { // 0x02008003
 }
 
 void DSP_IVR_Write(void) {
+	M68000_SyncCoprocessors();
 #if ENABLE_DSP_EMU
 	if (bDspEmulated)
 		dsp_core_write_host(CPU_HOST_IVR, IoMem[IoAccessCurrentAddress & IO_SEG_MASK]);
@@ -1020,6 +1066,7 @@ void DSP_IVR_Write(void) {
 }
 
 void DSP_Data0_Read(void) { // 0x02008004
+	M68000_SyncCoprocessors();
 #if ENABLE_DSP_EMU
 	if (bDspEmulated)
 		IoMem[IoAccessCurrentAddress & IO_SEG_MASK] = dsp_core_read_host(CPU_HOST_TRX0);
@@ -1032,6 +1079,7 @@ void DSP_Data0_Read(void) { // 0x02008004
 }
 
 void DSP_Data0_Write(void) {
+	M68000_SyncCoprocessors();
 #if ENABLE_DSP_EMU
 	if (bDspEmulated)
 		dsp_core_write_host(CPU_HOST_TRX0, IoMem[IoAccessCurrentAddress & IO_SEG_MASK]);
@@ -1040,6 +1088,7 @@ void DSP_Data0_Write(void) {
 }
 
 void DSP_Data1_Read(void) { // 0x02008005
+	M68000_SyncCoprocessors();
 #if ENABLE_DSP_EMU
 	if (bDspEmulated)
 		IoMem[IoAccessCurrentAddress & IO_SEG_MASK] = dsp_core_read_host(CPU_HOST_TRXH);
@@ -1052,6 +1101,7 @@ void DSP_Data1_Read(void) { // 0x02008005
 }
 
 void DSP_Data1_Write(void) {
+	M68000_SyncCoprocessors();
 #if ENABLE_DSP_EMU
 	if (bDspEmulated)
 		dsp_core_write_host(CPU_HOST_TRXH, IoMem[IoAccessCurrentAddress & IO_SEG_MASK]);
@@ -1060,6 +1110,7 @@ void DSP_Data1_Write(void) {
 }
 
 void DSP_Data2_Read(void) { // 0x02008006
+	M68000_SyncCoprocessors();
 #if ENABLE_DSP_EMU
 	if (bDspEmulated)
 		IoMem[IoAccessCurrentAddress & IO_SEG_MASK] = dsp_core_read_host(CPU_HOST_TRXM);
@@ -1072,6 +1123,7 @@ void DSP_Data2_Read(void) { // 0x02008006
 }
 
 void DSP_Data2_Write(void) {
+	M68000_SyncCoprocessors();
 #if ENABLE_DSP_EMU
 	if (bDspEmulated)
 		dsp_core_write_host(CPU_HOST_TRXM, IoMem[IoAccessCurrentAddress & IO_SEG_MASK]);
@@ -1080,6 +1132,7 @@ void DSP_Data2_Write(void) {
 }
 
 void DSP_Data3_Read(void) { // 0x02008007
+	M68000_SyncCoprocessors();
 #if ENABLE_DSP_EMU
 	if (bDspEmulated)
 		IoMem[IoAccessCurrentAddress & IO_SEG_MASK] = dsp_core_read_host(CPU_HOST_TRXL);
@@ -1092,6 +1145,7 @@ void DSP_Data3_Read(void) { // 0x02008007
 }
 
 void DSP_Data3_Write(void) {
+	M68000_SyncCoprocessors();
 #if ENABLE_DSP_EMU
 	if (bDspEmulated)
 		dsp_core_write_host(CPU_HOST_TRXL, IoMem[IoAccessCurrentAddress & IO_SEG_MASK]);
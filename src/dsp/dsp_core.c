@@ -131,6 +131,7 @@ void dsp_core_init(void (*host_interrupt)(int set))
 void dsp_core_start(Uint8 mode)
 {
 	dsp_core.registers[DSP_REG_OMR] = mode;
+	dsp_core.idle_state = 0;
 	if (mode==2) {
 		dsp_core.pc = 0xe000;
 	} else {
@@ -180,6 +181,12 @@ void dsp_core_reset(void)
 	dsp_core.interrupt_enable = 0;
 	dsp_core.interrupt_edgetriggered_mask = DSP_INTER_EDGE_MASK;
 
+	/* Idle loop */
+	dsp_core.idle_state = 0;
+
+	/* Instruction cache, ram size may have changed */
+	dsp56k_flush_icache();
+
 	/* host port init, dsp side */
 	dsp_core.periph[DSP_SPACE_X][DSP_HOST_HSR]=(1<<DSP_HOST_HSR_HTDE);
 	dsp_set_interrupt(DSP_INTER_HOST_TRX_DATA, 1);
@@ -725,6 +732,7 @@ void dsp_core_write_host(int addr, Uint8 value)
 					dsp_core.registers[DSP_REG_R0] = dsp_core.bootstrap_pos;
 					dsp_core.registers[DSP_REG_OMR] = 0x02;
 					dsp_core.running = 1;
+					dsp56k_flush_icache();
 				}
 			} else {
 
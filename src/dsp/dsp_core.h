@@ -266,6 +266,16 @@ struct dsp_core_s {
 	Uint32 interrupt_mask;
 	Uint32 interrupt_mask_level[3];
 	Uint32 interrupt_edgetriggered_mask;
+
+	/* Idle loop (jclr/jset polling a peripheral bit on itself) */
+	Uint16 idle_state;		/* DSP is suspended in a poll loop ? */
+	Uint16 idle_pc;			/* address of the poll instruction */
+	Uint16 idle_space;		/* x: or y: peripheral space polled */
+	Uint16 idle_addr;		/* peripheral register index polled */
+	Uint32 idle_mask;		/* bit polled */
+	Uint32 idle_value;		/* bit value that keeps the loop running */
+	Uint32 idle_interrupts;		/* interrupt_status when the loop was entered */
+	Uint16 idle_cycles;		/* cycles of one loop iteration */
 };
 
 
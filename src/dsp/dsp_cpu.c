@@ -90,6 +90,7 @@
 #include "dsp_cpu.h"
 #include "dsp_disasm.h"
 #include "log.h"
+#include "tracebuf.h"
 #include "debugui.h"
 
 #define DSP_COUNT_IPS 0		/* Count instruction per seconds */
@@ -131,6 +132,9 @@ static Uint16 access_to_ext_memory;
 /* If yes, stack overflow, underflow and illegal instructions messages are not displayed */
 static bool isDsp_in_disasm_mode;
 
+/* Current instruction is a jclr/jset polling a peripheral bit on itself ? */
+static bool idle_poll;
+
 static char   str_disasm_memory[2][50]; 	/* Buffer for memory change text in disasm mode */
 static Uint16 disasm_memory_ptr;		/* Pointer for memory change in disasm mode */
 
@@ -140,11 +144,28 @@ static Uint16 disasm_memory_ptr;		/* Pointer for memory change in disasm mode */
 
 typedef void (*dsp_emul_t)(void);
 
+/* Instruction cache: predecoded handler of the word at each P memory location */
+/* Entries [0,0x200[ are internal P RAM, the next ones external RAM words */
+#define DSP_ICACHE_EXT		0x200
+#define DSP_ICACHE_SIZE		(DSP_ICACHE_EXT+0x10000)
+
+typedef struct {
+	Uint32 inst;		/* instruction word */
+	dsp_emul_t func;	/* handler, NULL if the entry is invalid */
+} dsp_icache_t;
+
+static dsp_icache_t dsp_icache[DSP_ICACHE_SIZE];
+
+static dsp_emul_t dsp_icache_decode(Uint32 inst);
+
 static void dsp_postexecute_update_pc(void);
 static void dsp_postexecute_interrupts(void);
 
 static void dsp_setInterruptIPL(Uint32 value);
 
+static void dsp_idle_poll(Uint32 memspace, Uint32 addr, Uint32 mask, Uint32 value);
+static void dsp_idle_enter(void);
+
 static void dsp_ccr_update_e_u_n_z(Uint32 reg0, Uint32 reg1, Uint32 reg2);
 
 static Uint32 read_memory(int space, Uint16 address);
@@ -721,8 +742,61 @@ const char *dsp_interrupt_name[32] = {
  *	Emulator kernel
  **********************************/
 
+/**
+ * Resolve the handler of an instruction word. Parallel move instructions
+ * are resolved down to the move type, or directly to the ALU operation
+ * when there is no move at all.
+ */
+static dsp_emul_t dsp_icache_decode(Uint32 inst)
+{
+	Uint32 value;
+
+	if (inst < 0x100000) {
+		value = (inst >> 11) & (BITMASK(6) << 3);
+		value += (inst >> 5) & BITMASK(3);
+		return opcodes8h[value];
+	}
+
+	switch ((inst>>20) & BITMASK(4)) {
+		case 2:
+			if ((inst & 0xffff00) == 0x200000) {
+				return opcodes_alu[inst & BITMASK(8)];
+			}
+			if ((inst & 0xffe000) == 0x204000) {
+				return dsp_pm_2;
+			}
+			if ((inst & 0xfc0000) == 0x200000) {
+				return dsp_pm_2_2;
+			}
+			return dsp_pm_3;
+		case 4:
+			if ((inst & 0xf40000) == 0x400000) {
+				return dsp_pm_4x;
+			}
+			return dsp_pm_5;
+		default:
+			return opcodes_parmove[(inst>>20) & BITMASK(4)];
+	}
+}
+
+/* Invalidate the cache entry of an external RAM word */
+static inline void dsp_icache_invalidate_ext(Uint32 address)
+{
+	dsp_icache[DSP_ICACHE_EXT + (address & (DSP_RAMSIZE-1) & 0xffff)].func = NULL;
+}
+
+/**
+ * Invalidate all predecoded instructions, to be called when P memory
+ * is modified from outside the DSP core (bootstrap, snapshot, reset).
+ */
+void dsp56k_flush_icache(void)
+{
+	memset(dsp_icache, 0, sizeof(dsp_icache));
+}
+
 void dsp56k_init_cpu(void)
 {
+	dsp56k_flush_icache();
 	dsp56k_disasm_init();
 	isDsp_in_disasm_mode = false;
 	start_time = SDL_GetTicks();
@@ -769,12 +843,15 @@ Uint16 dsp56k_execute_one_disasm_instruction(FILE *out, Uint16 pc)
 
 void dsp56k_execute_instruction(void)
 {
+	dsp_icache_t *entry;
 	Uint32 value;
 	Uint32 disasm_return = 0;
+	Uint16 trace_pc = 0;
 	disasm_memory_ptr = 0;
 
 	/* Initialise the number of access to the external memory for this instruction */
 	access_to_ext_memory = 0;
+	idle_poll = false;
 	
 	/* Trace Interrupt at end of instruction? */
 	if (dsp_core.registers[DSP_REG_SR] & (1<<DSP_SR_T)) {
@@ -782,7 +859,17 @@ void dsp56k_execute_instruction(void)
 	}
 	
 	/* Decode and execute current instruction */
-	cur_inst = read_memory_p(dsp_core.pc);
+	if (dsp_core.pc < 0x200) {
+		entry = &dsp_icache[dsp_core.pc];
+	} else {
+		access_to_ext_memory |= 1 << EXT_P_MEMORY;
+		entry = &dsp_icache[DSP_ICACHE_EXT + (dsp_core.pc & (DSP_RAMSIZE-1))];
+	}
+	if (unlikely(entry->func == NULL)) {
+		entry->inst = read_memory_p(dsp_core.pc);
+		entry->func = dsp_icache_decode(entry->inst);
+	}
+	cur_inst = entry->inst;
 	
 	/* Initialize instruction size and cycle counter */
 	cur_inst_len = 1;
@@ -791,7 +878,10 @@ void dsp56k_execute_instruction(void)
 	/* Disasm current instruction ? (trace mode only) */
 	if (LOG_TRACE_LEVEL(TRACE_DSP_DISASM)) {	
 		/* Call dsp56k_disasm only when DSP is called in trace mode */
-		if (isDsp_in_disasm_mode == false) {
+		if (isDsp_in_disasm_mode == false && bTraceBufEnabled) {
+			/* Binary trace: the instruction is recorded after its execution */
+			trace_pc = dsp_core.pc;
+		} else if (isDsp_in_disasm_mode == false) {
 			disasm_return = dsp56k_disasm(DSP_TRACE_MODE);
 			
 			if (disasm_return != 0 && LOG_TRACE_LEVEL(TRACE_DSP_DISASM_REG)) {
@@ -801,14 +891,7 @@ void dsp56k_execute_instruction(void)
 		}
 	}
 			
-	if (cur_inst < 0x100000) {
-		value = (cur_inst >> 11) & (BITMASK(6) << 3);
-		value += (cur_inst >> 5) & BITMASK(3);
-		opcodes8h[value]();
-	} else {
-		/* Do parallel move read */
-		opcodes_parmove[(cur_inst>>20) & BITMASK(4)]();
-	}
+	entry->func();
 
 	/* Add the waitstate due to external memory access */
 	/* (2 extra cycles per extra access to the external memory after the first one */
@@ -824,7 +907,9 @@ void dsp56k_execute_instruction(void)
 	/* Disasm current instruction ? (trace mode only) */
 	if (LOG_TRACE_LEVEL(TRACE_DSP_DISASM)) {
 		/* Display only when DSP is called in trace mode */
-		if (isDsp_in_disasm_mode == false) {
+		if (isDsp_in_disasm_mode == false && bTraceBufEnabled) {
+			TraceBuf_DspDisasm(trace_pc, cur_inst, read_memory_p(trace_pc + 1), dsp_core.instr_cycle);
+		} else if (isDsp_in_disasm_mode == false) {
 			if (disasm_return != 0) {
 				fprintf(stderr, "%s", dsp56k_getInstructionText());
 				
@@ -852,6 +937,11 @@ void dsp56k_execute_instruction(void)
 	/* Process Interrupts */
 	dsp_postexecute_interrupts();
 
+	/* Suspend the DSP if it is spinning on a peripheral bit */
+	if (idle_poll) {
+		dsp_idle_enter();
+	}
+
 #if DSP_COUNT_IPS
 	++num_inst;
 	if ((num_inst & 63) == 0) {
@@ -994,6 +1084,75 @@ static void dsp_setInterruptIPL(Uint32 value)
 	}
 }
 
+/**********************************
+ *	Idle loops
+**********************************/
+
+/* Note a poll loop candidate (jclr/jset on a peripheral bit, branching to itself) */
+static void dsp_idle_poll(Uint32 memspace, Uint32 addr, Uint32 mask, Uint32 value)
+{
+	/* Reading these registers has side effects, each iteration counts */
+	if ((memspace == DSP_SPACE_X) &&
+	    ((addr == 0xffc0+DSP_HOST_HRX) || (addr == 0xffc0+DSP_SSI_RX))) {
+		return;
+	}
+
+	idle_poll = true;
+	dsp_core.idle_space = memspace;
+	dsp_core.idle_addr = addr - 0xffc0;
+	dsp_core.idle_mask = mask;
+	dsp_core.idle_value = value;
+}
+
+/* Suspend the DSP after a poll loop iteration, if nothing else can happen */
+static void dsp_idle_enter(void)
+{
+	if (isDsp_in_disasm_mode || LOG_TRACE_LEVEL(TRACE_DSP_DISASM)) {
+		return;
+	}
+	/* An interrupt is being processed, or will be */
+	if (dsp_core.interrupt_state != DSP_INTERRUPT_NONE) {
+		return;
+	}
+	if (dsp_core.loop_rep || (dsp_core.registers[DSP_REG_SR] & (1<<DSP_SR_T))) {
+		return;
+	}
+
+	dsp_core.idle_state = 1;
+	dsp_core.idle_pc = dsp_core.pc;
+	dsp_core.idle_interrupts = dsp_core.interrupt_status;
+	dsp_core.idle_cycles = dsp_core.instr_cycle;
+}
+
+/**
+ * Consume host cycles while the DSP is suspended in a poll loop.
+ * The loop is left as soon as the polled bit or the pending interrupts
+ * change (host port, DMA or SSI activity). The cycles skipped are a whole
+ * number of loop iterations, exactly as if the loop had been executed.
+ * Returns the remaining cycles count.
+ */
+Sint32 dsp56k_skip_idle(Sint32 cycles)
+{
+	Uint32 value, count;
+
+	value = dsp_core.periph[dsp_core.idle_space][dsp_core.idle_addr] & dsp_core.idle_mask;
+
+	if ((value != dsp_core.idle_value) ||
+	    (dsp_core.interrupt_status != dsp_core.idle_interrupts) ||
+	    (dsp_core.pc != dsp_core.idle_pc) ||
+	    LOG_TRACE_LEVEL(TRACE_DSP_DISASM)) {
+		dsp_core.idle_state = 0;
+		return cycles;
+	}
+
+	if (cycles <= 0) {
+		return cycles;
+	}
+
+	count = (cycles + dsp_core.idle_cycles - 1) / dsp_core.idle_cycles;
+	return cycles - (Sint32)(count * dsp_core.idle_cycles);
+}
+
 static void dsp_postexecute_interrupts(void)
 {
 	int i;
@@ -1357,6 +1516,7 @@ static void write_memory_p(Uint16 address, Uint32 value)
 	/* Internal P RAM ? */
 	if (address < 0x200) {
 		dsp_core.ramint[DSP_SPACE_P][address] = value;
+		dsp_icache[address].func = NULL;
 		return;
 	}
 	
@@ -1365,6 +1525,7 @@ static void write_memory_p(Uint16 address, Uint32 value)
 	
 	/* Mask address to available ram size */
 	dsp_core.ramext[address & (DSP_RAMSIZE-1)] = value;
+	dsp_icache_invalidate_ext(address);
 }
 
 static void write_memory_x(Uint16 address, Uint32 value)
@@ -1446,11 +1607,10 @@ static void write_memory_x(Uint16 address, Uint32 value)
 		/* Map X to upper half of available ram size */
 		address &= (DSP_RAMSIZE>>1)-1;
 		address += DSP_RAMSIZE>>1;
-		dsp_core.ramext[address & (DSP_RAMSIZE-1)] = value;
-	} else {
-		/* Mask address to available ram size */
-		dsp_core.ramext[address & (DSP_RAMSIZE-1)] = value;
 	}
+	/* Mask address to available ram size */
+	dsp_core.ramext[address & (DSP_RAMSIZE-1)] = value;
+	dsp_icache_invalidate_ext(address);
 }
 
 static void write_memory_y(Uint16 address, Uint32 value)
@@ -1473,11 +1633,11 @@ static void write_memory_y(Uint16 address, Uint32 value)
 	/* Access to contiguous or separated space ? */
 	if (address&0x8000) {
 		/* Map Y to lower half of available ram size */
-		dsp_core.ramext[address & ((DSP_RAMSIZE>>1)-1)] = value;
-	} else {
-		/* Mask address to available ram size */
-		dsp_core.ramext[address & (DSP_RAMSIZE-1)] = value;
+		address &= (DSP_RAMSIZE>>1)-1;
 	}
+	/* Mask address to available ram size */
+	dsp_core.ramext[address & (DSP_RAMSIZE-1)] = value;
+	dsp_icache_invalidate_ext(address);
 }
 
 static void write_memory_raw(int space, Uint16 address, Uint32 value)
@@ -2588,6 +2748,9 @@ static void dsp_jclr_pp(void)
 	dsp_core.instr_cycle += 4;
 
 	if ((value & (1<<numbit))==0) {
+		if (newaddr == dsp_core.pc) {
+			dsp_idle_poll(memspace, addr, 1<<numbit, 0);
+		}
 		dsp_core.pc = newaddr;
 		cur_inst_len = 0;
 		return;
@@ -2823,6 +2986,9 @@ static void dsp_jset_pp(void)
 	dsp_core.instr_cycle += 4;
 	
 	if (value & (1<<numbit)) {
+		if (newaddr == dsp_core.pc) {
+			dsp_idle_poll(memspace, addr, 1<<numbit, 1<<numbit);
+		}
 		newpc = newaddr;
 		dsp_core.pc = newpc;
 		cur_inst_len=0;
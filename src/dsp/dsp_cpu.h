@@ -114,6 +114,8 @@ extern "C" {
 extern void dsp56k_init_cpu(void);		/* Set dsp_core to use */
 extern void dsp56k_execute_instruction(void);	/* Execute 1 instruction */
 extern Uint16 dsp56k_execute_one_disasm_instruction(FILE *out, Uint16 pc);	/* Execute 1 instruction in disasm mode */
+extern Sint32 dsp56k_skip_idle(Sint32 cycles);	/* Consume cycles while in an idle loop */
+extern void dsp56k_flush_icache(void);		/* Invalidate predecoded instructions */
 
 /* Interrupt relative functions */
 void dsp_set_interrupt(Uint32 intr, Uint32 set);
@@ -2,6 +2,7 @@
 #include "ethernet.h"
 #include "enet_slirp.h"
 #include "queue.h"
+#include "inputlog.h"
 
 #include <SDL.h>
 #ifndef _WIN32
@@ -100,15 +101,25 @@ static int tick_func(void *arg)
 void enet_slirp_queue_poll(void)
 {
     SDL_LockMutex(slirp_mutex);
-    if (QueuePeek(slirpq)>0)
+    if (bInputLogReplay)
+    {
+        /* Packets come from the input log, drop those from the network */
+        while (QueuePeek(slirpq)>0)
+            free(QueueDelete(slirpq));
+    }
+    else if (QueuePeek(slirpq)>0)
     {
         struct queuepacket *qp;
         qp=QueueDelete(slirpq);
         Log_Printf(LOG_WARN, "[SLIRP] Getting packet from queue");
+        InputLog_Packet(qp->data,qp->len);
         enet_receive(qp->data,qp->len);
         free(qp);
     }
     SDL_UnlockMutex(slirp_mutex);
+    
+    if (bInputLogReplay)
+        InputLog_ReplayPacket();
 }
 
 void enet_slirp_input(Uint8 *pkt, int pkt_len) {
@@ -17,6 +17,7 @@
 #include "enet_slirp.h"
 #include "cycInt.h"
 #include "statusbar.h"
+#include "perfstats.h"
 
 
 #define LOG_EN_LEVEL        LOG_DEBUG
@@ -353,6 +354,7 @@ void enet_receive(Uint8 *pkt, int len) {
 #endif
         memcpy(enet_rx_buffer.data,pkt,len);
         enet_rx_buffer.size=enet_rx_buffer.limit=len;
+        nPerfEnetRxBytes += len;
     } else {
         Log_Printf(LOG_WARN, "[EN] Packet is not for me.");
     }
@@ -468,6 +470,7 @@ void enet_io(void) {
 					   enet_tx_buffer.data[0], enet_tx_buffer.data[1], enet_tx_buffer.data[2],
 					   enet_tx_buffer.data[3], enet_tx_buffer.data[4], enet_tx_buffer.data[5]);
 			print_buf(enet_tx_buffer.data, enet_tx_buffer.size);
+			nPerfEnetTxBytes += enet_tx_buffer.size;
 			if (enet.tx_mode&TXMODE_DIS_LOOP) {
 				/* Send to real world network */
 				if (ConfigureParams.Ethernet.bEthernetConnected) {
@@ -574,6 +577,7 @@ void new_enet_io(void) {
 					   enet_tx_buffer.data[0], enet_tx_buffer.data[1], enet_tx_buffer.data[2],
 					   enet_tx_buffer.data[3], enet_tx_buffer.data[4], enet_tx_buffer.data[5]);
 			print_buf(enet_tx_buffer.data, enet_tx_buffer.size);
+			nPerfEnetTxBytes += enet_tx_buffer.size;
 			if (enet.tx_mode&TXMODE_DIS_LOOP) {
 				/* Loop back */
 				Log_Printf(LOG_WARN, "[newEN] Loopback packet.");
@@ -0,0 +1,277 @@
+/*
+  Hatari - fastboot.c
+
+  This file is distributed under the GNU Public License, version 2 or at
+  your option any later version. Read the file gpl.txt for details.
+
+  Fast boot: speed up the ROM power-on self test.
+
+  When the ROM is one of the known builds, its memory fill and verify loops
+  are located when the ROM is loaded. Whenever the CPU arrives at one of
+  these loops, all but the last iteration are done on the host through the
+  memory banks. The CPU then runs the last iteration itself, so flags,
+  registers and loop exits (also on a verify mismatch) are exactly what
+  the ROM code would have produced.
+*/
+const char FastBoot_fileid[] = "Hatari fastboot.c : " __DATE__ " " __TIME__;
+
+#include "main.h"
+#include "configuration.h"
+#include "m68000.h"
+#include "cpummu030.h"
+#include "utils.h"
+#include "fastboot.h"
+
+
+#define FASTBOOT_MAX_LOOPS  32
+
+/* Known ROM builds */
+static const struct {
+	Uint32 crc;
+	const char *name;
+} FastBoot_Roms[] = {
+	{ 0x09325493, "Rev_1.0_v41" },
+	{ 0xae91ff74, "Rev_2.5_v66" },
+	{ 0x243032c7, "Rev_3.3_v74" },
+	{ 0, NULL }
+};
+
+/* A memory fill/verify loop in ROM:
+ *   move.l Dd,(Ap)+      or    cmp.l (Ap)+,Dd / bne exit
+ *   [addq.l #1,Dd]
+ *   cmpa.l Ap,Ae / bne   or    dbf Dc
+ */
+typedef struct {
+	Uint32 offset;   /* offset of the loop in ROM */
+	bool verify;     /* compare instead of fill */
+	int ptr;         /* address register (postincrement) */
+	int data;        /* data register */
+	int inc;         /* data increment per iteration */
+	int end;         /* address register holding the end address or -1 */
+	int counter;     /* dbf counter data register or -1 */
+} FASTBOOT_LOOP;
+
+static FASTBOOT_LOOP FastBoot_Loops[FASTBOOT_MAX_LOOPS];
+static int nFastBootLoops;
+static Uint32 FastBoot_RomMask;
+static Uint32 FastBoot_Map[0x20000/64];   /* bitmap of loop offsets (in words) */
+
+bool bFastBootArmed = false;
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Read a big endian word from the ROM image.
+ */
+static Uint16 FastBoot_Word(const Uint8 *rom, int size, int offset)
+{
+	if (offset + 1 >= size)
+		return 0;
+	return (rom[offset] << 8) | rom[offset + 1];
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Check if there is a fill or verify loop at offset and record it.
+ */
+static bool FastBoot_Decode(const Uint8 *rom, int size, int offset, FASTBOOT_LOOP *loop)
+{
+	int pos = offset;
+	Uint16 w = FastBoot_Word(rom, size, pos);
+
+	if ((w & 0xF1F8) == 0x20C0) {            /* move.l Dd,(Ap)+ */
+		loop->verify = false;
+		loop->ptr = (w >> 9) & 7;
+		loop->data = w & 7;
+	} else if ((w & 0xF1F8) == 0xB098) {     /* cmp.l (Ap)+,Dd */
+		loop->verify = true;
+		loop->ptr = w & 7;
+		loop->data = (w >> 9) & 7;
+	} else {
+		return false;
+	}
+	pos += 2;
+
+	if (loop->verify) {                      /* bne exit (forward) */
+		w = FastBoot_Word(rom, size, pos);
+		if (w == 0x6600 && !(FastBoot_Word(rom, size, pos + 2) & 0x8000))
+			pos += 4;
+		else if (w == 0x66FF && !(FastBoot_Word(rom, size, pos + 2) & 0x8000))
+			pos += 6;
+		else if ((w & 0xFF80) == 0x6600 && (w & 0xFF))
+			pos += 2;
+		else
+			return false;
+	}
+
+	loop->inc = 0;
+	w = FastBoot_Word(rom, size, pos);
+	if (w == (0x5280 | loop->data)) {        /* addq.l #1,Dd */
+		loop->inc = 1;
+		pos += 2;
+	}
+
+	loop->end = loop->counter = -1;
+	w = FastBoot_Word(rom, size, pos);
+	if ((w & 0xF1F8) == 0xB1C8) {            /* cmpa.l Ae,Ap / bne.b loop */
+		int an = (w >> 9) & 7, ea = w & 7;
+		if (an == loop->ptr && ea != an)
+			loop->end = ea;
+		else if (ea == loop->ptr && an != ea)
+			loop->end = an;
+		else
+			return false;
+		w = FastBoot_Word(rom, size, pos + 2);
+		return (w & 0xFF80) == 0x6680 && pos + 4 + (Sint8)(w & 0xFF) == offset;
+	}
+	if ((w & 0xFFF8) == 0x51C8) {            /* dbf Dc,loop */
+		loop->counter = w & 7;
+		if (loop->counter == loop->data)
+			return false;
+		w = FastBoot_Word(rom, size, pos + 2);
+		return pos + 2 + (Sint16)w == offset;
+	}
+	return false;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Called when the ROM has been loaded: check if it is a known build and
+ * locate its memory test loops.
+ */
+void FastBoot_Init(const Uint8 *rom, int size)
+{
+	Uint32 crc;
+	int i, rom_idx;
+
+	nFastBootLoops = 0;
+	bFastBootArmed = false;
+	memset(FastBoot_Map, 0, sizeof(FastBoot_Map));
+
+	if (!ConfigureParams.System.bFastBoot || size <= 0)
+		return;
+
+	crc32_reset(&crc);
+	for (i = 0; i < size; i++)
+		crc32_add_byte(&crc, rom[i]);
+
+	for (rom_idx = 0; FastBoot_Roms[rom_idx].name; rom_idx++) {
+		if (FastBoot_Roms[rom_idx].crc == crc)
+			break;
+	}
+	if (!FastBoot_Roms[rom_idx].name) {
+		Log_Printf(LOG_WARN, "[FastBoot] Unknown ROM (CRC $%08x), fast boot disabled", crc);
+		return;
+	}
+
+	FastBoot_RomMask = (size > 0x10000 ? 0x20000 : 0x10000) - 1;
+
+	for (i = 0; i < size && nFastBootLoops < FASTBOOT_MAX_LOOPS; i += 2) {
+		if (FastBoot_Decode(rom, size, i, &FastBoot_Loops[nFastBootLoops])) {
+			FastBoot_Loops[nFastBootLoops].offset = i;
+			FastBoot_Map[i >> 6] |= 1 << ((i >> 1) & 31);
+			nFastBootLoops++;
+		}
+	}
+
+	Log_Printf(LOG_WARN, "[FastBoot] ROM %s: %d memory test loops", FastBoot_Roms[rom_idx].name, nFastBootLoops);
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Arm fast boot on reset (the ROM runs its self test again).
+ */
+void FastBoot_Reset(void)
+{
+	bFastBootArmed = nFastBootLoops > 0;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Run all but the last iteration of a loop on the host.
+ */
+static void FastBoot_RunLoop(const FASTBOOT_LOOP *loop)
+{
+	Uint32 ptr = m68k_areg(regs, loop->ptr);
+	Uint32 data = m68k_dreg(regs, loop->data);
+	Uint32 n, i, a;
+
+	if (loop->counter >= 0) {
+		n = (m68k_dreg(regs, loop->counter) & 0xFFFF) + 1;
+	} else {
+		Uint32 end = m68k_areg(regs, loop->end);
+		if (end <= ptr || ((end - ptr) & 3))
+			return;
+		n = (end - ptr) >> 2;
+	}
+
+	/* Leave the last iteration to the CPU */
+	if (n < 2)
+		return;
+	n--;
+	if (n > (0xFFFFFFFF - ptr) / 4)
+		return;
+
+	/* Only plain RAM, the CPU has to handle bus errors and IO */
+	for (a = ptr & 0xFFFF0000; a < ptr + n * 4; a += 0x10000) {
+		if (!(get_mem_bank(a).flags & ABFLAG_RAM))
+			return;
+		if (a == 0xFFFF0000)
+			break;
+	}
+
+	if (loop->verify) {
+		for (i = 0; i < n; i++, ptr += 4, data += loop->inc) {
+			if (longget(ptr) != data)
+				break;
+		}
+	} else {
+		for (i = 0; i < n; i++, ptr += 4, data += loop->inc)
+			longput(ptr, data);
+	}
+
+	m68k_areg(regs, loop->ptr) = ptr;
+	m68k_dreg(regs, loop->data) = data;
+	if (loop->counter >= 0) {
+		Uint32 c = m68k_dreg(regs, loop->counter);
+		m68k_dreg(regs, loop->counter) = (c & 0xFFFF0000) | ((c - i) & 0xFFFF);
+	}
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Called by the CPU before each instruction while fast boot is armed.
+ */
+void FastBoot_Skip(Uint32 pc)
+{
+	Uint32 offset;
+	int i;
+
+	/* Leaving ROM for code in RAM ends the self test */
+	if (pc >= 0x04000000) {
+		bFastBootArmed = false;
+		return;
+	}
+	if (pc >= 0x02000000)
+		return;
+
+	offset = pc & FastBoot_RomMask;
+	if (!(FastBoot_Map[offset >> 6] & (1 << ((offset >> 1) & 31))))
+		return;
+
+	/* The loops use physical addresses */
+	if ((tc_030 & 0x80000000) || regs.mmu_enabled)
+		return;
+
+	for (i = 0; i < nFastBootLoops; i++) {
+		if (FastBoot_Loops[i].offset == offset) {
+			FastBoot_RunLoop(&FastBoot_Loops[i]);
+			return;
+		}
+	}
+}
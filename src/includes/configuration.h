@@ -20,6 +20,9 @@ typedef struct
 {
   char sLogFileName[FILENAME_MAX];
   char sTraceFileName[FILENAME_MAX];
+  char sTraceBinFileName[FILENAME_MAX];
+  char sInputRecordFileName[FILENAME_MAX];  /* not saved */
+  char sInputReplayFileName[FILENAME_MAX];  /* not saved */
   int nTextLogLevel;
   int nAlertDlgLogLevel;
   bool bConfirmQuit;
@@ -168,6 +171,13 @@ typedef struct
 } CNF_BOOT;
 
 
+/* Copy-on-write overlay for disk images */
+typedef enum {
+    OVERLAY_OFF,        /* write to the image */
+    OVERLAY_DISCARD,    /* keep the image unchanged */
+    OVERLAY_COMMIT      /* write changes to the image when the disk is closed */
+} OVERLAY_MODE;
+
 /* Hard drives configuration */
 #define ESP_MAX_DEVS 7
 typedef enum {
@@ -187,6 +197,7 @@ typedef struct {
 
 typedef struct {
     SCSIDISK target[ESP_MAX_DEVS];
+    OVERLAY_MODE nOverlayMode;
 } CNF_SCSI;
 
 
@@ -201,6 +212,7 @@ typedef struct {
 
 typedef struct {
     MODISK drive[MO_MAX_DRIVES];
+    OVERLAY_MODE nOverlayMode;
 } CNF_MO;
 
 
@@ -259,6 +271,7 @@ typedef struct
   int nVdiHeight;
   bool bShowStatusbar;
   bool bShowDriveLed;
+  bool bShowPerformance;
   bool bCrop;
   int nMaxWidth;
   int nMaxHeight;
@@ -343,6 +356,9 @@ typedef struct
   bool bRealTimeClock;
   bool bPatchTimerD;
   bool bFastForward;
+  bool bFastBoot;                 /* Skip ROM memory test loops on known ROMs */
+  int nSpeedPercent;              /* Target speed in % of real time, 0 = unlimited */
+  int nCoprocQuantum;             /* CPU cycles DSP and i860 run in one go, 0 = lockstep */
   bool bAddressSpace24;
   bool bCycleExactCpu;
   FPUTYPE n_FPUType;
@@ -361,6 +377,7 @@ typedef struct
 {
   int AviRecordVcodec;
   int AviRecordFps;
+  int AviRecordPngLevel;
   char AviRecordFile[FILENAME_MAX];
 } CNF_VIDEO;
 
@@ -25,6 +25,7 @@ typedef enum
   INTERRUPT_FLP_IO,
   INTERRUPT_SND_IO,
   INTERRUPT_LP_IO,
+  INTERRUPT_INPUTLOG,
   MAX_INTERRUPTS
 } interrupt_id;
 
@@ -64,5 +65,6 @@ extern void CycInt_RemovePendingInterrupt(interrupt_id Handler);
 extern void CycInt_ResumeStoppedInterrupt(interrupt_id Handler);
 extern bool CycInt_InterruptActive(interrupt_id Handler);
 extern int CycInt_FindCyclesPassed(interrupt_id Handler, int CycleType);
+extern const char *CycInt_GetEventCount(interrupt_id Handler, Uint64 *pCount);
 
 #endif /* ifndef HATARI_CYCINT_H */
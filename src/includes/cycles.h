@@ -9,6 +9,7 @@
 #define HATARI_CYCLES_H
 
 #include <stdbool.h>
+#include <SDL_types.h>
 
 enum
 {
@@ -21,6 +22,7 @@ enum
 
 
 extern int nCyclesMainCounter;
+extern Uint64 nCyclesClock;
 
 extern int CurrentInstrCycles;
 
@@ -0,0 +1,69 @@
+/*
+  Hatari - diskimage.h
+
+  This file is distributed under the GNU Public License, version 2 or at
+  your option any later version. Read the file gpl.txt for details.
+*/
+
+#ifndef HATARI_DISKIMAGE_H
+#define HATARI_DISKIMAGE_H
+
+#include <stdio.h>
+#include <sys/types.h>
+#include "configuration.h"
+
+/* Compressed disk image: header, (chunks + 1) chunk offsets and the chunks.
+ * Every chunk holds chunksize bytes of the image (less for the last one),
+ * compressed with zlib or stored as is if it does not get smaller.
+ * All values are little endian.
+ */
+#define CDISK_MAGIC         "PRVCDISK"
+#define CDISK_VERSION       1
+#define CDISK_CHUNKSIZE     (64*1024)
+
+typedef struct {
+    char magic[8];
+    Uint32 version;
+    Uint32 chunksize;
+    Uint64 size;        /* size of the uncompressed image */
+    Uint32 chunks;
+    Uint32 reserved;
+} CDISK_HEADER;
+
+#define DISKIMAGE_CACHE_CHUNKS  16
+
+typedef struct {
+    Uint32 chunk;
+    Uint32 lastuse;     /* 0 = unused */
+    Uint8 *data;
+} DISKIMAGE_CACHE;
+
+typedef struct {
+    char *filename;     /* settings the image was opened with */
+    bool readonly;
+    OVERLAY_MODE mode;
+    FILE *base;         /* disk image file */
+    FILE *delta;        /* overlay with the written blocks or NULL */
+    Uint8 *bitmap;      /* blocks present in the overlay */
+    Uint32 blocksize;
+    Uint32 blocks;      /* size of the base image in blocks */
+    Uint32 written;     /* number of blocks in the overlay */
+    off_t size;         /* size of the (uncompressed) image in bytes */
+    OVERLAY_MODE overlay;
+
+    /* Compressed images */
+    Uint64 *chunkoffs;  /* file offsets of the chunks or NULL */
+    Uint32 chunksize;
+    Uint32 chunks;
+    Uint8 *packed;      /* buffer for a compressed chunk */
+    Uint32 usecount;
+    DISKIMAGE_CACHE cache[DISKIMAGE_CACHE_CHUNKS];
+} DISKIMAGE;
+
+extern DISKIMAGE *DiskImage_Open(const char *filename, bool readonly, Uint32 blocksize, OVERLAY_MODE overlay);
+extern void DiskImage_Close(DISKIMAGE *img);
+extern DISKIMAGE *DiskImage_Change(DISKIMAGE *img, const char *filename, bool readonly, Uint32 blocksize, OVERLAY_MODE overlay);
+extern bool DiskImage_Read(DISKIMAGE *img, Uint32 block, Uint8 *buf);
+extern bool DiskImage_Write(DISKIMAGE *img, Uint32 block, const Uint8 *buf);
+
+#endif /* HATARI_DISKIMAGE_H */
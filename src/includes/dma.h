@@ -1,32 +1,32 @@
 /* DMA Registers */
-void DMA_CSR_Read(void);
-void DMA_CSR_Write(void);
-
-void DMA_Saved_Next_Read(void);
-void DMA_Saved_Next_Write(void);
-void DMA_Saved_Limit_Read(void);
-void DMA_Saved_Limit_Write(void);
-void DMA_Saved_Start_Read(void);
-void DMA_Saved_Start_Write(void);
-void DMA_Saved_Stop_Read(void);
-void DMA_Saved_Stop_Write(void);
-
-void DMA_Next_Read(void);
-void DMA_Next_Write(void);
-void DMA_Limit_Read(void);
-void DMA_Limit_Write(void);
-void DMA_Start_Read(void);
-void DMA_Start_Write(void);
-void DMA_Stop_Read(void);
-void DMA_Stop_Write(void);
-
-void DMA_Init_Read(void);
-void DMA_Init_Write(void);
+Uint32 DMA_CSR_Read(Uint32 addr, int size);
+void DMA_CSR_Write(Uint32 addr, int size, Uint32 val);
+
+Uint32 DMA_Saved_Next_Read(Uint32 addr, int size);
+void DMA_Saved_Next_Write(Uint32 addr, int size, Uint32 val);
+Uint32 DMA_Saved_Limit_Read(Uint32 addr, int size);
+void DMA_Saved_Limit_Write(Uint32 addr, int size, Uint32 val);
+Uint32 DMA_Saved_Start_Read(Uint32 addr, int size);
+void DMA_Saved_Start_Write(Uint32 addr, int size, Uint32 val);
+Uint32 DMA_Saved_Stop_Read(Uint32 addr, int size);
+void DMA_Saved_Stop_Write(Uint32 addr, int size, Uint32 val);
+
+Uint32 DMA_Next_Read(Uint32 addr, int size);
+void DMA_Next_Write(Uint32 addr, int size, Uint32 val);
+Uint32 DMA_Limit_Read(Uint32 addr, int size);
+void DMA_Limit_Write(Uint32 addr, int size, Uint32 val);
+Uint32 DMA_Start_Read(Uint32 addr, int size);
+void DMA_Start_Write(Uint32 addr, int size, Uint32 val);
+Uint32 DMA_Stop_Read(Uint32 addr, int size);
+void DMA_Stop_Write(Uint32 addr, int size, Uint32 val);
+
+Uint32 DMA_Init_Read(Uint32 addr, int size);
+void DMA_Init_Write(Uint32 addr, int size, Uint32 val);
 
 /* Turbo DMA functions */
-void TDMA_CSR_Read(void);
-void TDMA_CSR_Write(void);
-void TDMA_Saved_Next_Read(void);
+Uint32 TDMA_CSR_Read(Uint32 addr, int size);
+void TDMA_CSR_Write(Uint32 addr, int size, Uint32 val);
+Uint32 TDMA_Saved_Next_Read(Uint32 addr, int size);
 void tdma_flush_buffer(int channel);
 
 /* Device functions */
@@ -40,8 +40,9 @@ void dma_mo_read_memory(void);
 void dma_enet_write_memory(bool eop);
 bool dma_enet_read_memory(void);
 
-void dma_dsp_write_memory(Uint8 val);
-Uint8 dma_dsp_read_memory(void);
+int dma_dsp_write_memory(const Uint8 *buf, int len);
+int dma_dsp_read_memory(Uint8 *buf, int len);
+int dma_dsp_pending(void);
 bool dma_dsp_ready(void);
 
 void dma_m2m_write_memory(void);
@@ -0,0 +1,17 @@
+/*
+  Hatari - fastboot.h
+
+  This file is distributed under the GNU Public License, version 2 or at
+  your option any later version. Read the file gpl.txt for details.
+*/
+
+#ifndef HATARI_FASTBOOT_H
+#define HATARI_FASTBOOT_H
+
+extern bool bFastBootArmed;
+
+extern void FastBoot_Init(const Uint8 *rom, int size);
+extern void FastBoot_Reset(void);
+extern void FastBoot_Skip(Uint32 pc);
+
+#endif /* HATARI_FASTBOOT_H */
@@ -0,0 +1,53 @@
+/*
+  Hatari - inputlog.h
+
+  This file is distributed under the GNU Public License, version 2 or at
+  your option any later version. Read the file gpl.txt for details.
+*/
+
+#ifndef HATARI_INPUTLOG_H
+#define HATARI_INPUTLOG_H
+
+#include <time.h>
+
+/* Input log file: header followed by records, each record is followed
+ * by len bytes of data. All values are little endian.
+ */
+#define INPUTLOG_MAGIC      "PRVINPUT"
+#define INPUTLOG_VERSION    1
+
+typedef struct {
+    char magic[8];
+    Uint32 version;
+    Uint32 reserved;
+    Uint64 starttime;   /* host time when recording started */
+} INPUTLOG_HEADER;
+
+/* Events */
+enum {
+    INPUTLOG_EV_KEYDOWN,        /* args: modifier keys, key code */
+    INPUTLOG_EV_KEYUP,          /* args: modifier keys, key code */
+    INPUTLOG_EV_MOUSEBUTTON,    /* args: left, down */
+    INPUTLOG_EV_MOUSEMOVE,      /* args: x, left, y, up */
+    INPUTLOG_EV_PACKET          /* data: received network packet */
+};
+
+typedef struct {
+    Uint64 cycles;      /* emulated CPU cycles (nCyclesClock) */
+    Uint16 event;       /* INPUTLOG_EV_* */
+    Uint16 len;         /* bytes of data following the record */
+    Uint8 args[4];
+} INPUTLOG_RECORD;
+
+extern bool bInputLogReplay;
+
+extern bool InputLog_Init(void);
+extern void InputLog_UnInit(void);
+extern void InputLog_Reset(void);
+extern void InputLog_InterruptHandler(void);
+extern bool InputLog_Event(int event, Uint8 arg0, Uint8 arg1, Uint8 arg2, Uint8 arg3);
+extern void InputLog_Packet(Uint8 *data, int len);
+extern void InputLog_ReplayPacket(void);
+extern time_t InputLog_Time(void);
+
+#endif /* HATARI_INPUTLOG_H */
@@ -83,6 +83,28 @@ static inline void IoMem_WriteByte(Uint32 Address, Uint8 Var)
 }
 
 
+/**
+ * Return the bytes of the 32-bit register value 'reg' that are covered by
+ * an access of 'size' bytes at 'addr' (for sized IO handlers).
+ */
+static inline Uint32 IoMem_RegisterRead(Uint32 reg, Uint32 addr, int size)
+{
+	return (reg >> ((4 - (addr & 3) - size) * 8)) & (0xFFFFFFFF >> ((4 - size) * 8));
+}
+
+
+/**
+ * Merge an access of 'size' bytes at 'addr' into the 32-bit register
+ * value 'reg' (for sized IO handlers).
+ */
+static inline Uint32 IoMem_RegisterWrite(Uint32 reg, Uint32 addr, int size, Uint32 val)
+{
+	int shift = (4 - (addr & 3) - size) * 8;
+	Uint32 mask = (0xFFFFFFFF >> ((4 - size) * 8)) << shift;
+	return (reg & ~mask) | ((val << shift) & mask);
+}
+
+
 extern void IoMem_Init(void);
 extern void IoMem_UnInit(void);
 extern void IoMem_Init_FalconInSTeBuscompatibilityMode(Uint8 value);
@@ -95,10 +117,6 @@ extern void IoMem_bput(uaecptr addr, uae_u32 val);
 extern void IoMem_wput(uaecptr addr, uae_u32 val);
 extern void IoMem_lput(uaecptr addr, uae_u32 val);
 
-extern void IoMem_BusErrorEvenReadAccess(void);
-extern void IoMem_BusErrorOddReadAccess(void);
-extern void IoMem_BusErrorEvenWriteAccess(void);
-extern void IoMem_BusErrorOddWriteAccess(void);
 extern void IoMem_VoidRead(void);
 extern void IoMem_VoidRead_00(void);
 extern void IoMem_VoidWrite(void);
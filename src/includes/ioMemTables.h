@@ -8,6 +8,11 @@
 #ifndef HATARI_IOMEMTABLES_H
 #define HATARI_IOMEMTABLES_H
 
+/* Sized handlers get the accessed address and width (1-4 bytes, never
+ * crossing a 32-bit boundary) and the value directly */
+typedef Uint32 (*IOMEM_READ_FUNC)(Uint32 addr, int size);
+typedef void (*IOMEM_WRITE_FUNC)(Uint32 addr, int size, Uint32 val);
+
 /* Hardware address details */
 typedef struct
 {
@@ -15,6 +20,8 @@ typedef struct
     const int SpanInBytes;    /* E.g. SIZE_BYTE, SIZE_WORD or SIZE_LONG */
     void (*ReadFunc)(void);   /* Read function */
     void (*WriteFunc)(void);  /* Write function */
+    IOMEM_READ_FUNC SizedReadFunc;    /* Sized read function, used instead of ReadFunc if set */
+    IOMEM_WRITE_FUNC SizedWriteFunc;  /* Sized write function, used instead of WriteFunc if set */
 } INTERCEPT_ACCESS_FUNC;
 
 extern const INTERCEPT_ACCESS_FUNC IoMemTable_NEXT[];
@@ -141,6 +141,11 @@ extern int nCpuFreqDivider;
 #define USE_FREQ_DIVIDER 1
 extern int nWaitStateCycles;
 extern int BusMode;
+extern int nCoprocCycles;
+extern int nCoprocSteps;
+extern int nCoprocQuantum;
+
+extern void M68000_SyncCoprocessors(void);
 
 extern int	LastOpcodeFamily;
 extern int	LastInstrCycles;
@@ -165,6 +170,22 @@ static inline void M68000_AddCycles(int cycles)
 
 	PendingInterruptCount -= INT_CONVERT_TO_INTERNAL(cycles, INT_CPU_CYCLE);
 	nCyclesMainCounter += cycles;
+	nCyclesClock += cycles;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Account the cycles of the last CPU instruction to DSP and i860. They
+ * catch up once a quantum has passed (after every instruction in lockstep
+ * mode) or when the CPU touches state shared with them.
+ */
+static inline void M68000_RunCoprocessors(int cycles)
+{
+	nCoprocCycles += cycles;
+	nCoprocSteps++;
+	if (nCoprocCycles >= nCoprocQuantum)
+		M68000_SyncCoprocessors();
 }
 
 
@@ -260,6 +281,7 @@ static inline void M68000_AddCyclesWithPairing(int cycles)
 	PendingInterruptCount -= INT_CONVERT_TO_INTERNAL ( cycles , INT_CPU_CYCLE );
 
 	nCyclesMainCounter += cycles;
+	nCyclesClock += cycles;
 	BusCyclePenalty = 0;
 }
 
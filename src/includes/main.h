@@ -60,6 +60,16 @@
 /* The 8 MHz CPU frequency */
 #define CPU_FREQ   8012800
 
+/* Speed governor statistics, updated about once per second */
+typedef struct
+{
+  int nSpeedPercent;      /* Target speed in % of real time, 0 = unlimited */
+  float fRealTime;        /* Achieved speed in % of real time */
+  Sint64 nAvgError;       /* Average deviation from the VBL deadlines in micro sec */
+  Sint64 nMaxError;       /* Worst deviation from the VBL deadlines in micro sec */
+  Uint32 nResyncs;        /* How often the governor gave up catching up */
+} SPEED_STATS;
+
 extern bool bQuitProgram;
 
 extern bool Main_PauseEmulation(bool visualize);
@@ -67,6 +77,7 @@ extern bool Main_UnPauseEmulation(void);
 extern void Main_RequestQuit(void);
 extern void Main_SetRunVBLs(Uint32 vbls);
 extern void Main_WaitOnVbl(void);
+extern void Main_GetSpeedStats(SPEED_STATS *pStats);
 extern void Main_WarpMouse(int x, int y);
 extern void Main_EventHandler(void);
 extern void Main_SetTitle(const char *title);
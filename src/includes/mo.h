@@ -1,4 +1,5 @@
 void MO_Reset(void);
+void MO_Uninit(void);
 void MO_Insert(int disk);
 void MO_Eject(int disk);
 
@@ -15,7 +15,9 @@
 
 extern Uint32 NEXTRamEnd;
 
-extern Uint8 NEXTRam[128*1024*1024];
+#define NEXT_RAM_SIZE   (128*1024*1024)
+
+extern Uint8 *NEXTRam;
 extern Uint8 NEXTRom[0x20000];
 extern Uint8 NEXTIo[0x20000];
 
@@ -97,6 +99,8 @@ static inline Uint8 NEXTMemory_ReadByte(Uint32 Address)
 }
 
 
+extern Uint8 *NEXTMemory_AllocRam(Uint32 size);
+extern void NEXTMemory_FreeRam(Uint8 *ram, Uint32 size);
 extern void NEXTMemory_Clear(Uint32 StartAddress, Uint32 EndAddress);
 extern bool NEXTMemory_SafeCopy(Uint32 addr, Uint8 *src, unsigned int len, const char *name);
 extern void NEXTMemory_MemorySnapShot_Capture(bool bSave);
@@ -0,0 +1,45 @@
+/*
+  Hatari - perfstats.h
+
+  This file is distributed under the GNU Public License, version 2 or at
+  your option any later version. Read the file gpl.txt for details.
+*/
+
+#ifndef HATARI_PERFSTATS_H
+#define HATARI_PERFSTATS_H
+
+/* Counters, incremented where the events happen and never reset */
+extern Uint64 nPerfCpuInstr;        /* 68k instructions */
+extern Uint64 nPerfDspInstr;        /* DSP instructions */
+extern Uint64 nPerfDspCycles;       /* DSP cycles, also while idle or stopped */
+extern Uint64 nPerfDspBusyCycles;   /* DSP cycles spent in executed instructions */
+extern Uint64 nPerfI860Instr;       /* i860 instructions */
+extern Uint64 nPerfI860Steps;       /* i860 steps, also while halted */
+extern Uint64 nPerfIdleTime;        /* host micro seconds slept by the speed governor */
+extern Uint64 nPerfRenderTime;      /* host performance counter ticks spent drawing */
+extern Uint64 nPerfFramesDrawn;
+extern Uint64 nPerfFramesSkipped;   /* screen could not be locked */
+extern Uint64 nPerfScsiBytes;
+extern Uint64 nPerfMoBytes;
+extern Uint64 nPerfEnetRxBytes;
+extern Uint64 nPerfEnetTxBytes;
+extern Uint32 nPerfAudioUnderruns;  /* updated from the audio thread */
+
+/* Rates, updated about once per second */
+typedef struct
+{
+  float fCpuMips;
+  float fDspMips;
+  float fI860Mips;
+  float fDspLoad;         /* Busy DSP cycles in % */
+  float fI860Load;        /* Non-halted i860 steps in % */
+  float fHostEmu;         /* Host time spent emulating in % */
+  float fHostRender;      /* Host time spent drawing the screen in % */
+  Uint32 nUpdates;        /* Incremented with every update */
+} PERF_RATES;
+
+extern void PerfStats_Update(Sint64 nInterval_micro);
+extern void PerfStats_GetRates(PERF_RATES *pRates);
+extern int PerfStats_Print(char *buffer, int size);
+
+#endif /* HATARI_PERFSTATS_H */
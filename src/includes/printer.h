@@ -16,4 +16,5 @@ struct {
 } lp_buffer;
 
 void Printer_Reset(void);
+void Printer_UnInit(void);
 void Printer_IO_Handler(void);
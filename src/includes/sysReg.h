@@ -83,6 +83,7 @@ void HardclockWrite1(void);
 void HardclockWriteCSR(void);
 void HardclockReadCSR(void);
 
+int System_Timer_CyclesPerMicro(void);
 void System_Timer_Read(void);
 
 void ColorVideo_CMD_Write(void);
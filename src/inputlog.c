@@ -0,0 +1,362 @@
+/*
+  Hatari - inputlog.c
+
+  This file is distributed under the GNU Public License, version 2 or at
+  your option any later version. Read the file gpl.txt for details.
+
+  Record and replay of external input.
+
+  When recording, every keyboard and mouse event and every network packet
+  received from slirp is written to the input log together with the
+  emulated cycle count at which it was delivered to the machine. When
+  replaying, input from the host is ignored and the logged events are
+  delivered again at the same cycle counts: keyboard and mouse events from
+  a cycle interrupt, network packets when the ethernet receiver polls for
+  them. While recording or replaying the real-time clock runs in emulated
+  time, starting at the host time stored in the log. Together this makes
+  a run repeatable, as long as the same configuration and disk images
+  are used.
+*/
+const char InputLog_fileid[] = "Hatari inputlog.c : " __DATE__ " " __TIME__;
+
+#include <inttypes.h>
+#include <SDL_endian.h>
+
+#include "main.h"
+#include "configuration.h"
+#include "cycInt.h"
+#include "cycles.h"
+#include "file.h"
+#include "log.h"
+#include "kms.h"
+#include "ethernet.h"
+#include "sysReg.h"
+#include "inputlog.h"
+
+/* Limit for the cycle interrupt, far events are reached in several steps */
+#define INPUTLOG_MAX_DELAY  0x10000000
+
+typedef struct {
+    INPUTLOG_RECORD rec;
+    Uint8 *data;
+} INPUTLOG_EVENT;
+
+bool bInputLogReplay = false;
+
+static FILE *InputLogFile = NULL;           /* recording */
+static time_t InputLogStartTime;
+static bool bInputLogActive = false;        /* recording or replaying */
+static bool bInputLogInjecting = false;     /* delivering a logged event */
+
+static INPUTLOG_EVENT *InputLogEvents = NULL;   /* replaying */
+static Uint32 nInputLogEvents;
+static Uint32 nInputLogNextInput;
+static Uint32 nInputLogNextPacket;
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Write one record with its data to the log.
+ */
+static void InputLog_Write(int event, const Uint8 *args, const Uint8 *data, int len)
+{
+	INPUTLOG_RECORD rec;
+
+	rec.cycles = SDL_SwapLE64(nCyclesClock);
+	rec.event = SDL_SwapLE16(event);
+	rec.len = SDL_SwapLE16(len);
+	memcpy(rec.args, args, sizeof(rec.args));
+
+	if (fwrite(&rec, sizeof(rec), 1, InputLogFile) != 1
+	    || (len > 0 && fwrite(data, len, 1, InputLogFile) != 1))
+	{
+		Log_Printf(LOG_ERROR, "Input log: write error, recording stopped.");
+		File_Close(InputLogFile);
+		InputLogFile = NULL;
+	}
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Read a log for replay.
+ */
+static bool InputLog_Load(const char *filename)
+{
+	INPUTLOG_HEADER header;
+	INPUTLOG_EVENT *ev;
+	Uint32 size = 0;
+	FILE *fp;
+
+	fp = File_Open(filename, "rb");
+	if (!fp)
+		return false;
+
+	if (fread(&header, sizeof(header), 1, fp) != 1
+	    || memcmp(header.magic, INPUTLOG_MAGIC, sizeof(header.magic)) != 0
+	    || SDL_SwapLE32(header.version) != INPUTLOG_VERSION)
+	{
+		Log_Printf(LOG_ERROR, "Input log: %s is not an input log.", filename);
+		File_Close(fp);
+		return false;
+	}
+	InputLogStartTime = SDL_SwapLE64(header.starttime);
+
+	nInputLogEvents = 0;
+	for (;;)
+	{
+		if (nInputLogEvents == size)
+		{
+			size += 1024;
+			ev = realloc(InputLogEvents, size * sizeof(INPUTLOG_EVENT));
+			if (!ev)
+				break;
+			InputLogEvents = ev;
+		}
+		ev = &InputLogEvents[nInputLogEvents];
+		if (fread(&ev->rec, sizeof(ev->rec), 1, fp) != 1)
+			break;
+		ev->rec.cycles = SDL_SwapLE64(ev->rec.cycles);
+		ev->rec.event = SDL_SwapLE16(ev->rec.event);
+		ev->rec.len = SDL_SwapLE16(ev->rec.len);
+		ev->data = NULL;
+		if (ev->rec.len > 0)
+		{
+			ev->data = malloc(ev->rec.len);
+			if (!ev->data || fread(ev->data, ev->rec.len, 1, fp) != 1)
+			{
+				free(ev->data);
+				break;
+			}
+		}
+		nInputLogEvents++;
+	}
+	if (!feof(fp))
+		Log_Printf(LOG_WARN, "Input log: %s is truncated, replaying %u events.",
+		           filename, nInputLogEvents);
+	File_Close(fp);
+	return true;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Open the input log for recording or replay, if one is configured.
+ * Return false if that fails.
+ */
+bool InputLog_Init(void)
+{
+	INPUTLOG_HEADER header;
+
+	if (ConfigureParams.Log.sInputReplayFileName[0])
+	{
+		if (!InputLog_Load(ConfigureParams.Log.sInputReplayFileName))
+			return false;
+		Log_Printf(LOG_WARN, "Input log: replaying %u events from %s.", nInputLogEvents,
+		           ConfigureParams.Log.sInputReplayFileName);
+		bInputLogReplay = true;
+		bInputLogActive = true;
+	}
+	else if (ConfigureParams.Log.sInputRecordFileName[0])
+	{
+		InputLogFile = File_Open(ConfigureParams.Log.sInputRecordFileName, "wb");
+		if (!InputLogFile)
+			return false;
+
+		InputLogStartTime = time(NULL);
+		memset(&header, 0, sizeof(header));
+		memcpy(header.magic, INPUTLOG_MAGIC, sizeof(header.magic));
+		header.version = SDL_SwapLE32(INPUTLOG_VERSION);
+		header.starttime = SDL_SwapLE64(InputLogStartTime);
+		if (fwrite(&header, sizeof(header), 1, InputLogFile) != 1)
+			return false;
+		bInputLogActive = true;
+	}
+	return true;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Close the input log.
+ */
+void InputLog_UnInit(void)
+{
+	Uint32 i;
+
+	File_Close(InputLogFile);
+	InputLogFile = NULL;
+
+	for (i = 0; i < nInputLogEvents; i++)
+		free(InputLogEvents[i].data);
+	free(InputLogEvents);
+	InputLogEvents = NULL;
+	nInputLogEvents = 0;
+	bInputLogReplay = false;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Stop replaying when all events have been delivered, input from the
+ * host is used again after that.
+ */
+static void InputLog_CheckEnd(void)
+{
+	if (nInputLogNextInput >= nInputLogEvents && nInputLogNextPacket >= nInputLogEvents)
+	{
+		Log_Printf(LOG_WARN, "Input log: replay finished at cycle %"PRIu64".", nCyclesClock);
+		bInputLogReplay = false;
+	}
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Set the cycle interrupt for the next keyboard or mouse event.
+ */
+static void InputLog_ScheduleNext(void)
+{
+	Sint64 delay;
+
+	while (nInputLogNextInput < nInputLogEvents
+	       && InputLogEvents[nInputLogNextInput].rec.event == INPUTLOG_EV_PACKET)
+		nInputLogNextInput++;
+
+	if (nInputLogNextInput >= nInputLogEvents)
+	{
+		InputLog_CheckEnd();
+		return;
+	}
+
+	delay = InputLogEvents[nInputLogNextInput].rec.cycles - nCyclesClock;
+	if (delay < 0)
+		delay = 0;
+	if (delay > INPUTLOG_MAX_DELAY)
+		delay = INPUTLOG_MAX_DELAY;
+	CycInt_AddRelativeInterrupt((int)delay, INT_CPU_CYCLE, INTERRUPT_INPUTLOG);
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Re-arm the replay after all cycle interrupts have been reset.
+ */
+void InputLog_Reset(void)
+{
+	if (bInputLogReplay)
+		InputLog_ScheduleNext();
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Cycle interrupt: deliver the keyboard and mouse events which are due.
+ */
+void InputLog_InterruptHandler(void)
+{
+	INPUTLOG_RECORD *rec;
+
+	CycInt_AcknowledgeInterrupt();
+
+	bInputLogInjecting = true;
+	for (; nInputLogNextInput < nInputLogEvents; nInputLogNextInput++)
+	{
+		rec = &InputLogEvents[nInputLogNextInput].rec;
+		if (rec->cycles > nCyclesClock)
+			break;
+
+		switch (rec->event)
+		{
+		 case INPUTLOG_EV_KEYDOWN:
+			kms_keydown(rec->args[0], rec->args[1]);
+			break;
+		 case INPUTLOG_EV_KEYUP:
+			kms_keyup(rec->args[0], rec->args[1]);
+			break;
+		 case INPUTLOG_EV_MOUSEBUTTON:
+			kms_mouse_button(rec->args[0], rec->args[1]);
+			break;
+		 case INPUTLOG_EV_MOUSEMOVE:
+			kms_mouse_move(rec->args[0], rec->args[1], rec->args[2], rec->args[3]);
+			break;
+		}
+	}
+	bInputLogInjecting = false;
+
+	InputLog_ScheduleNext();
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Called for keyboard and mouse events before they are delivered to the
+ * machine. Returns false if the event has to be ignored, because it is
+ * host input during replay.
+ */
+bool InputLog_Event(int event, Uint8 arg0, Uint8 arg1, Uint8 arg2, Uint8 arg3)
+{
+	Uint8 args[4] = { arg0, arg1, arg2, arg3 };
+
+	if (bInputLogReplay)
+		return bInputLogInjecting;
+
+	if (InputLogFile)
+		InputLog_Write(event, args, NULL, 0);
+	return true;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Record a network packet before it is delivered to the machine.
+ */
+void InputLog_Packet(Uint8 *data, int len)
+{
+	Uint8 args[4] = { 0, 0, 0, 0 };
+
+	if (InputLogFile)
+		InputLog_Write(INPUTLOG_EV_PACKET, args, data, len);
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Called when the ethernet receiver polls for a packet during replay.
+ * Delivers the next logged packet if it is due.
+ */
+void InputLog_ReplayPacket(void)
+{
+	INPUTLOG_EVENT *ev;
+
+	while (nInputLogNextPacket < nInputLogEvents
+	       && InputLogEvents[nInputLogNextPacket].rec.event != INPUTLOG_EV_PACKET)
+		nInputLogNextPacket++;
+
+	if (nInputLogNextPacket >= nInputLogEvents)
+	{
+		InputLog_CheckEnd();
+		return;
+	}
+
+	ev = &InputLogEvents[nInputLogNextPacket];
+	if (ev->rec.cycles <= nCyclesClock)
+	{
+		enet_receive(ev->data, ev->rec.len);
+		nInputLogNextPacket++;
+	}
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Host time for the real-time clock. While recording or replaying it
+ * advances with the emulated cycles instead of the host clock.
+ */
+time_t InputLog_Time(void)
+{
+	if (!bInputLogActive)
+		return time(NULL);
+
+	return InputLogStartTime + nCyclesClock / ((Uint64)System_Timer_CyclesPerMicro() * 1000000);
+}
@@ -20,8 +20,10 @@ const char IoMem_fileid[] = "Hatari ioMem.c : " __DATE__ " " __TIME__;
 #define IO_MASK 0x0001FFFF
 #define IO_SIZE 0x00020000
 
-static void (*pInterceptReadTable[IO_SIZE])(void);     /* Table with read access handlers */
-static void (*pInterceptWriteTable[IO_SIZE])(void);    /* Table with write access handlers */
+static IOMEM_READ_FUNC pReadTable[IO_SIZE];           /* Table with sized read access handlers */
+static IOMEM_WRITE_FUNC pWriteTable[IO_SIZE];         /* Table with sized write access handlers */
+static void (*pInterceptReadTable[IO_SIZE])(void);     /* Table with legacy read access handlers */
+static void (*pInterceptWriteTable[IO_SIZE])(void);    /* Table with legacy write access handlers */
 
 int nIoMemAccessSize;                                 /* Set to 1, 2 or 4 according to byte, word or long word access */
 Uint32 IoAccessBaseAddress;                           /* Stores the base address of the IO mem access */
@@ -29,6 +31,156 @@ Uint32 IoAccessCurrentAddress;                        /* Current byte address wh
 static int nBusErrorAccesses;                         /* Needed to count bus error accesses */
 
 
+/*-----------------------------------------------------------------------*/
+/**
+ * Read 'size' bytes from IO memory as a big endian value.
+ */
+static Uint32 IoMem_ReadBytes(Uint32 addr, int size)
+{
+	Uint32 val = 0;
+	int i;
+
+	for (i = 0; i < size; i++)
+		val = (val << 8) | IoMem[(addr + i) & IO_SEG_MASK];
+
+	return val;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Bus error handlers. We can't call M68000_BusError() directly: For example,
+ * a "move.b $ff8204,d0" triggers a bus error on a real ST, while a
+ * "move.w $ff8204,d0" works! So we count the bytes accessed in bus error
+ * regions and only trigger a bus error later if the count matches the
+ * complete access size (e.g. nBusErrorAccesses==4 for a long word access).
+ */
+static Uint32 IoMem_BusErrorRead(Uint32 addr, int size)
+{
+	nBusErrorAccesses += size;
+	Log_Printf(LOG_WARN,"Bus error $%08x PC=$%08x %s at %d", addr,regs.pc,__FILE__,__LINE__);
+	return IoMem_ReadBytes(addr, size);
+}
+
+static void IoMem_BusErrorWrite(Uint32 addr, int size, Uint32 val)
+{
+	nBusErrorAccesses += size;
+	Log_Printf(LOG_WARN,"Bus error $%08x PC=$%08x %s at %d", addr,regs.pc,__FILE__,__LINE__);
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Shims for the legacy byte handlers: these communicate through
+ * IoAccessCurrentAddress and IoMem[].
+ */
+static Uint32 IoMem_LegacyRead(Uint32 addr, int size)
+{
+	IoAccessCurrentAddress = addr;
+	pInterceptReadTable[addr & IO_SEG_MASK]();
+	return IoMem_ReadBytes(addr, size);
+}
+
+static void IoMem_LegacyWrite(Uint32 addr, int size, Uint32 val)
+{
+	/* IoMem[] has already been updated by IoMem_Write() */
+	IoAccessCurrentAddress = addr;
+	pInterceptWriteTable[addr & IO_SEG_MASK]();
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Return the number of bytes from idx on (at most len) that are handled
+ * by a single handler call. Legacy handlers are called once for consecutive
+ * bytes, sized handlers once per (up to) 32-bit register.
+ */
+static int IoMem_ReadRun(Uint32 idx, int len)
+{
+	int n;
+
+	for (n = 1; n < len; n++)
+	{
+		Uint32 next = (idx + n) & IO_SEG_MASK;
+		if (pReadTable[next] != pReadTable[idx] || pInterceptReadTable[next] != pInterceptReadTable[idx])
+			break;
+		if (!pInterceptReadTable[idx] && !(next & 3))
+			break;
+	}
+	return n;
+}
+
+static int IoMem_WriteRun(Uint32 idx, int len)
+{
+	int n;
+
+	for (n = 1; n < len; n++)
+	{
+		Uint32 next = (idx + n) & IO_SEG_MASK;
+		if (pWriteTable[next] != pWriteTable[idx] || pInterceptWriteTable[next] != pInterceptWriteTable[idx])
+			break;
+		if (!pInterceptWriteTable[idx] && !(next & 3))
+			break;
+	}
+	return n;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Dispatch a read access of 'size' bytes. An access to a single register
+ * with a sized handler results in one call.
+ */
+static Uint32 IoMem_Read(Uint32 addr, int size)
+{
+	Uint32 idx = addr & IO_SEG_MASK;
+	Uint32 val = 0;
+	int i, n;
+
+	IoAccessBaseAddress = addr;                   /* Store for exception frame */
+	nIoMemAccessSize = size;
+	nBusErrorAccesses = 0;
+
+	for (i = 0; i < size; i += n)
+	{
+		n = IoMem_ReadRun((idx + i) & IO_SEG_MASK, size - i);
+		val = (i ? val << (n * 8) : 0) | pReadTable[(idx + i) & IO_SEG_MASK](addr + i, n);
+	}
+
+	return val;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Dispatch a write access of 'size' bytes.
+ */
+static void IoMem_Write(Uint32 addr, int size, Uint32 val)
+{
+	Uint32 idx = addr & IO_SEG_MASK;
+	int i, n;
+
+	IoAccessBaseAddress = addr;                   /* Store for exception frame, just in case */
+	nIoMemAccessSize = size;
+	nBusErrorAccesses = 0;
+
+	/* Legacy handlers read the value from IoMem[] */
+	switch (size)
+	{
+		case SIZE_BYTE: IoMem_WriteByte(addr, val); break;
+		case SIZE_WORD: IoMem_WriteWord(addr, val); break;
+		default:        IoMem_WriteLong(addr, val); break;
+	}
+
+	for (i = 0; i < size; i += n)
+	{
+		n = IoMem_WriteRun((idx + i) & IO_SEG_MASK, size - i);
+		pWriteTable[(idx + i) & IO_SEG_MASK](addr + i, n,
+		    (val >> ((size - i - n) * 8)) & (0xFFFFFFFF >> ((4 - n) * 8)));
+	}
+}
+
+
 /*-----------------------------------------------------------------------*/
 /**
  * Fill a region with bus error handlers.
@@ -39,16 +191,10 @@ static void IoMem_SetBusErrorRegion(Uint32 startaddr, Uint32 endaddr)
 
 	for (a = startaddr; a <= endaddr; a++)
 	{
-		if (a & 1)
-		{
-			pInterceptReadTable[a & 0x1FFFF] = IoMem_BusErrorOddReadAccess;     /* For 'read' */
-			pInterceptWriteTable[a & 0x1FFFF] = IoMem_BusErrorOddWriteAccess;   /* and 'write' */
-		}
-		else
-		{
-			pInterceptReadTable[a & 0x1FFFF] = IoMem_BusErrorEvenReadAccess;    /* For 'read' */
-			pInterceptWriteTable[a & 0x1FFFF] = IoMem_BusErrorEvenWriteAccess;  /* and 'write' */
-		}
+		pReadTable[a & IO_SEG_MASK] = IoMem_BusErrorRead;       /* For 'read' */
+		pWriteTable[a & IO_SEG_MASK] = IoMem_BusErrorWrite;     /* and 'write' */
+		pInterceptReadTable[a & IO_SEG_MASK] = NULL;
+		pInterceptWriteTable[a & IO_SEG_MASK] = NULL;
 	}
 }
 
@@ -82,14 +228,26 @@ void IoMem_Init(void)
 			    && addr < pInterceptAccessFuncs[i].Address+pInterceptAccessFuncs[i].SpanInBytes)
 			{
 				/* Security checks... */
-				if (pInterceptReadTable[addr & 0x1FFFF] != IoMem_BusErrorEvenReadAccess && pInterceptReadTable[addr&0x1FFFF] != IoMem_BusErrorOddReadAccess)
+				if (pReadTable[addr & IO_SEG_MASK] != IoMem_BusErrorRead)
 					fprintf(stderr, "IoMem_Init: Warning: $%x (R) already defined\n", addr);
-				if (pInterceptWriteTable[addr& 0x1FFFF] != IoMem_BusErrorEvenWriteAccess && pInterceptWriteTable[addr&0x1FFFF] != IoMem_BusErrorOddWriteAccess)
+				if (pWriteTable[addr & IO_SEG_MASK] != IoMem_BusErrorWrite)
 					fprintf(stderr, "IoMem_Init: Warning: $%x (W) already defined\n", addr);
 
 				/* This location needs to be intercepted, so add entry to list */
-				pInterceptReadTable[addr& 0x1FFFF] = pInterceptAccessFuncs[i].ReadFunc;
-				pInterceptWriteTable[addr& 0x1FFFF] = pInterceptAccessFuncs[i].WriteFunc;
+				if (pInterceptAccessFuncs[i].SizedReadFunc) {
+					pReadTable[addr & IO_SEG_MASK] = pInterceptAccessFuncs[i].SizedReadFunc;
+					pInterceptReadTable[addr & IO_SEG_MASK] = NULL;
+				} else {
+					pReadTable[addr & IO_SEG_MASK] = IoMem_LegacyRead;
+					pInterceptReadTable[addr & IO_SEG_MASK] = pInterceptAccessFuncs[i].ReadFunc;
+				}
+				if (pInterceptAccessFuncs[i].SizedWriteFunc) {
+					pWriteTable[addr & IO_SEG_MASK] = pInterceptAccessFuncs[i].SizedWriteFunc;
+					pInterceptWriteTable[addr & IO_SEG_MASK] = NULL;
+				} else {
+					pWriteTable[addr & IO_SEG_MASK] = IoMem_LegacyWrite;
+					pInterceptWriteTable[addr & IO_SEG_MASK] = pInterceptAccessFuncs[i].WriteFunc;
+				}
 			}
 		}
 	}
@@ -122,12 +280,7 @@ uae_u32 IoMem_bget(uaecptr addr)
 		return -1;
 	}
 
-	IoAccessBaseAddress = addr;                   /* Store access location */
-	nIoMemAccessSize = SIZE_BYTE;
-	nBusErrorAccesses = 0;
-
-	IoAccessCurrentAddress = addr;
-	pInterceptReadTable[addr & IO_SEG_MASK]();         /* Call handler */
+	val = IoMem_Read(addr, SIZE_BYTE);
 
 	/* Check if we read from a bus-error region */
 	if (nBusErrorAccesses == 1)
@@ -136,8 +289,6 @@ uae_u32 IoMem_bget(uaecptr addr)
 		return -1;
 	}
 
-	val = IoMem[addr & IO_SEG_MASK];
-
 	LOG_TRACE(TRACE_IOMEM_RD, "IO read.b $%06x = $%02x\n", addr, val);
 
 	return val;
@@ -150,7 +301,6 @@ uae_u32 IoMem_bget(uaecptr addr)
  */
 uae_u32 IoMem_wget(uaecptr addr)
 {
-	Uint32 idx;
 	Uint16 val;
 
 
@@ -161,19 +311,7 @@ uae_u32 IoMem_wget(uaecptr addr)
 		return -1;
 	}
 
-	IoAccessBaseAddress = addr;                   /* Store for exception frame */
-	nIoMemAccessSize = SIZE_WORD;
-	nBusErrorAccesses = 0;
-	idx = addr & IO_SEG_MASK;
-
-	IoAccessCurrentAddress = addr;
-	pInterceptReadTable[idx]();                   /* Call 1st handler */
-
-	if (pInterceptReadTable[idx+1] != pInterceptReadTable[idx])
-	{
-		IoAccessCurrentAddress = addr + 1;
-		pInterceptReadTable[idx+1]();             /* Call 2nd handler */
-	}
+	val = IoMem_Read(addr, SIZE_WORD);
 
 	/* Check if we completely read from a bus-error region */
 	if (nBusErrorAccesses == 2)
@@ -182,8 +320,6 @@ uae_u32 IoMem_wget(uaecptr addr)
 		return -1;
 	}
 
-	val = IoMem_ReadWord(addr);
-
 	LOG_TRACE(TRACE_IOMEM_RD, "IO read.w $%06x = $%04x\n", addr, val);
 
 	return val;
@@ -196,7 +332,6 @@ uae_u32 IoMem_wget(uaecptr addr)
  */
 uae_u32 IoMem_lget(uaecptr addr)
 {
-	Uint32 idx;
 	Uint32 val;
 
 
@@ -207,31 +342,7 @@ uae_u32 IoMem_lget(uaecptr addr)
 		return -1;
 	}
 
-	IoAccessBaseAddress = addr;                   /* Store for exception frame */
-	nIoMemAccessSize = SIZE_LONG;
-	nBusErrorAccesses = 0;
-	idx = addr & IO_SEG_MASK;
-
-	IoAccessCurrentAddress = addr;
-	pInterceptReadTable[idx]();                   /* Call 1st handler */
-
-	if (pInterceptReadTable[idx+1] != pInterceptReadTable[idx])
-	{
-		IoAccessCurrentAddress = addr + 1;
-		pInterceptReadTable[idx+1]();             /* Call 2nd handler */
-	}
-
-	if (pInterceptReadTable[idx+2] != pInterceptReadTable[idx+1])
-	{
-		IoAccessCurrentAddress = addr + 2;
-		pInterceptReadTable[idx+2]();             /* Call 3rd handler */
-	}
-
-	if (pInterceptReadTable[idx+3] != pInterceptReadTable[idx+2])
-	{
-		IoAccessCurrentAddress = addr + 3;
-		pInterceptReadTable[idx+3]();             /* Call 4th handler */
-	}
+	val = IoMem_Read(addr, SIZE_LONG);
 
 	/* Check if we completely read from a bus-error region */
 	if (nBusErrorAccesses == 4)
@@ -240,8 +351,6 @@ uae_u32 IoMem_lget(uaecptr addr)
 		return -1;
 	}
 
-	val = IoMem_ReadLong(addr);
-
 	LOG_TRACE(TRACE_IOMEM_RD, "IO read.l $%06x = $%08x\n", addr, val);
 
 	return val;
@@ -264,14 +373,7 @@ void IoMem_bput(uaecptr addr, uae_u32 val)
 		return;
 	}
 
-	IoAccessBaseAddress = addr;                   /* Store for exception frame, just in case */
-	nIoMemAccessSize = SIZE_BYTE;
-	nBusErrorAccesses = 0;
-
-	IoMem[addr & IO_SEG_MASK] = val;
-
-	IoAccessCurrentAddress = addr;
-	pInterceptWriteTable[addr & IO_SEG_MASK]();        /* Call handler */
+	IoMem_Write(addr, SIZE_BYTE, val & 0xff);
 
 	/* Check if we wrote to a bus-error region */
 	if (nBusErrorAccesses == 1)
@@ -287,8 +389,6 @@ void IoMem_bput(uaecptr addr, uae_u32 val)
  */
 void IoMem_wput(uaecptr addr, uae_u32 val)
 {
-	Uint32 idx;
-
 
 	LOG_TRACE(TRACE_IOMEM_WR, "IO write.w $%06x = $%04x\n", addr, val&0xffff);
 
@@ -299,21 +399,7 @@ void IoMem_wput(uaecptr addr, uae_u32 val)
 		return;
 	}
 
-	IoAccessBaseAddress = addr;                   /* Store for exception frame, just in case */
-	nIoMemAccessSize = SIZE_WORD;
-	nBusErrorAccesses = 0;
-
-	IoMem_WriteWord(addr, val);
-	idx = addr & IO_SEG_MASK;
-
-	IoAccessCurrentAddress = addr;
-	pInterceptWriteTable[idx]();                  /* Call 1st handler */
-
-	if (pInterceptWriteTable[idx+1] != pInterceptWriteTable[idx])
-	{
-		IoAccessCurrentAddress = addr + 1;
-		pInterceptWriteTable[idx+1]();            /* Call 2nd handler */
-	}
+	IoMem_Write(addr, SIZE_WORD, val & 0xffff);
 
 	/* Check if we wrote to a bus-error region */
 	if (nBusErrorAccesses == 2)
@@ -329,8 +415,6 @@ void IoMem_wput(uaecptr addr, uae_u32 val)
  */
 void IoMem_lput(uaecptr addr, uae_u32 val)
 {
-	Uint32 idx;
-
 	LOG_TRACE(TRACE_IOMEM_WR, "IO write.l $%06x = $%08x\n", addr, val);
 
 	if ((addr & IO_SEG_MASK) >= IO_SIZE)
@@ -340,33 +424,7 @@ void IoMem_lput(uaecptr addr, uae_u32 val)
 		return;
 	}
 
-	IoAccessBaseAddress = addr;                   /* Store for exception frame, just in case */
-	nIoMemAccessSize = SIZE_LONG;
-	nBusErrorAccesses = 0;
-
-	IoMem_WriteLong(addr, val);
-	idx = addr & IO_SEG_MASK;
-
-	IoAccessCurrentAddress = addr;
-	pInterceptWriteTable[idx]();                  /* Call handler */
-
-	if (pInterceptWriteTable[idx+1] != pInterceptWriteTable[idx])
-	{
-		IoAccessCurrentAddress = addr + 1;
-		pInterceptWriteTable[idx+1]();            /* Call 2nd handler */
-	}
-
-	if (pInterceptWriteTable[idx+2] != pInterceptWriteTable[idx+1])
-	{
-		IoAccessCurrentAddress = addr + 2;
-		pInterceptWriteTable[idx+2]();            /* Call 3rd handler */
-	}
-
-	if (pInterceptWriteTable[idx+3] != pInterceptWriteTable[idx+2])
-	{
-		IoAccessCurrentAddress = addr + 3;
-		pInterceptWriteTable[idx+3]();            /* Call 4th handler */
-	}
+	IoMem_Write(addr, SIZE_LONG, val);
 
 	/* Check if we wrote to a bus-error region */
 	if (nBusErrorAccesses == 4)
@@ -376,54 +434,6 @@ void IoMem_lput(uaecptr addr, uae_u32 val)
 }
 
 
-/*-------------------------------------------------------------------------*/
-/**
- * This handler will be called if a program tries to read from an address
- * that causes a bus error on a real machine. However, we can't call M68000_BusError()
- * directly: For example, a "move.b $ff8204,d0" triggers a bus error on a real ST,
- * while a "move.w $ff8204,d0" works! So we have to count the accesses to bus error
- * addresses and we only trigger a bus error later if the count matches the complete
- * access size (e.g. nBusErrorAccesses==4 for a long word access).
- */
-void IoMem_BusErrorEvenReadAccess(void)
-{
-	nBusErrorAccesses += 1;
-	// IoMem[IoAccessCurrentAddress& IO_SEG_MASK] = 0xff;
-	Log_Printf(LOG_WARN,"Bus error $%08x PC=$%08x %s at %d", IoAccessCurrentAddress,regs.pc,__FILE__,__LINE__);
-}
-
-/**
- * We need two handler so that the IoMem_*get functions can distinguish
- * consecutive addresses.
- */
-void IoMem_BusErrorOddReadAccess(void)
-{
-	nBusErrorAccesses += 1;
-	// IoMem[IoAccessCurrentAddress& IO_SEG_MASK] = 0xff;
-	Log_Printf(LOG_WARN,"Bus error $%08x PC=$%08x %s at %d", IoAccessCurrentAddress,regs.pc,__FILE__,__LINE__);
-}
-
-/*-------------------------------------------------------------------------*/
-/**
- * Same as IoMem_BusErrorReadAccess() but for write access this time.
- */
-void IoMem_BusErrorEvenWriteAccess(void)
-{
-	nBusErrorAccesses += 1;
-	Log_Printf(LOG_WARN,"Bus error $%08x PC=$%08x %s at %d", IoAccessCurrentAddress,regs.pc,__FILE__,__LINE__);
-}
-
-/**
- * We need two handler so that the IoMem_*put functions can distinguish
- * consecutive addresses.
- */
-void IoMem_BusErrorOddWriteAccess(void)
-{
-	nBusErrorAccesses += 1;
-	Log_Printf(LOG_WARN,"Bus error $%08x PC=$%08x %s at %d", IoAccessCurrentAddress,regs.pc,__FILE__,__LINE__);
-}
-
-
 /*-------------------------------------------------------------------------*/
 /**
  * This is the read handler for the IO memory locations without an assigned
@@ -18,6 +18,7 @@
 #include "dma.h"
 #include "rtcnvram.h"
 #include "snd.h"
+#include "inputlog.h"
 
 #define LOG_KMS_LEVEL LOG_WARN
 #define IO_SEG_MASK	0x1FFFF
@@ -420,6 +421,9 @@ bool kms_device_enabled(int dev_addr) {
 }
 
 void kms_keydown(Uint8 modkeys, Uint8 keycode) {
+    if (!InputLog_Event(INPUTLOG_EV_KEYDOWN, modkeys, keycode, 0, 0))
+        return;
+    
     if ((keycode==0x26)&&(modkeys&0x18)) { /* backquote and one or both command keys */
         Log_Printf(LOG_WARN, "Keyboard initiated NMI!");
         set_interrupt(INT_NMI, SET_INT);
@@ -447,6 +451,9 @@ void kms_keydown(Uint8 modkeys, Uint8 keycode) {
 }
 
 void kms_keyup(Uint8 modkeys, Uint8 keycode) {
+    if (!InputLog_Event(INPUTLOG_EV_KEYUP, modkeys, keycode, 0, 0))
+        return;
+    
     if (keycode==0x58) {
         rtc_stop_pdown_request();
         return;
@@ -462,6 +469,9 @@ void kms_keyup(Uint8 modkeys, Uint8 keycode) {
 }
 
 void kms_mouse_button(bool left, bool down) {
+    if (!InputLog_Event(INPUTLOG_EV_MOUSEBUTTON, left, down, 0, 0))
+        return;
+    
     if (left) {
         m_button_left = down;
     } else {
@@ -489,6 +499,9 @@ void kms_mouse_move(int x, bool left, int y, bool up) {
     if (y>0x3F)
         y=0x3F;
     
+    if (!InputLog_Event(INPUTLOG_EV_MOUSEMOVE, x, left, y, up))
+        return;
+    
     m_move_left = left;
     m_move_up = up;
     
@@ -18,6 +18,8 @@ const char M68000_fileid[] = "Hatari m68000.c : " __DATE__ " " __TIME__;
 #include "options.h"
 #include "savestate.h"
 #include "nextMemory.h"
+#include "dsp.h"
+#include "dimension.h"
 
 #include "mmu_common.h"
 
@@ -28,6 +30,9 @@ int nCpuFreqShift;              /* Used to emulate higher CPU frequencies: 0=8MH
 int nCpuFreqDivider;            /* Used to emulate higher CPU frequencies: 1=8MHz, 2=16MHz, 4=32Mhz */
 int nWaitStateCycles;           /* Used to emulate the wait state cycles of certain IO registers */
 int BusMode = BUS_MODE_CPU;	/* Used to tell which part is owning the bus (cpu, blitter, ...) */
+int nCoprocCycles;              /* CPU cycles not yet run on DSP and i860 */
+int nCoprocSteps;               /* CPU instructions not yet run on DSP and i860 */
+int nCoprocQuantum;             /* Run DSP and i860 after this many CPU cycles, 0 = lockstep */
 
 int LastOpcodeFamily = i_NOP;	/* see the enum in readcpu.h i_XXX */
 int LastInstrCycles = 0;	/* number of cycles for previous instr. (not rounded to 4) */
@@ -274,6 +279,12 @@ void M68000_CheckCpuSettings(void)
 		default: fprintf (stderr, "Init680x0() : Error, fpu_model unknown\n");
     }
 
+	if (ConfigureParams.System.nCoprocQuantum < 0)
+		ConfigureParams.System.nCoprocQuantum = 0;
+	else if (ConfigureParams.System.nCoprocQuantum > 1024)
+		ConfigureParams.System.nCoprocQuantum = 1024;
+	nCoprocQuantum = ConfigureParams.System.nCoprocQuantum;
+
 	changed_prefs.address_space_24 = ConfigureParams.System.bAddressSpace24;
 	changed_prefs.cpu_cycle_exact = ConfigureParams.System.bCycleExactCpu;
 	changed_prefs.fpu_strict = ConfigureParams.System.bCompatibleFPU;
@@ -284,6 +295,36 @@ void M68000_CheckCpuSettings(void)
 }
 
 
+/*-----------------------------------------------------------------------*/
+/**
+ * Let DSP and i860 catch up with the CPU. Called when a quantum has
+ * passed and before the CPU accesses state shared with them (DSP host
+ * port, NBIC, DMA and interrupt registers).
+ */
+void M68000_SyncCoprocessors(void)
+{
+	int cycles = nCoprocCycles;
+#if ENABLE_DIMENSION
+	int steps = nCoprocSteps;
+#endif
+
+	/* Nothing pending, also when the i860 itself accesses board registers */
+	if (nCoprocSteps == 0)
+		return;
+
+	nCoprocCycles = 0;
+	nCoprocSteps = 0;
+
+	DSP_Run(cycles);
+#if ENABLE_DIMENSION
+	if (steps == 1)
+		i860_Run(cycles);
+	else if (steps > 1)
+		i860_RunSteps(steps, cycles);
+#endif
+}
+
+
 /*-----------------------------------------------------------------------*/
 /**
  * Save/Restore snapshot of CPU variables ('MemorySnapShot_Store' handles type)
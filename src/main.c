@@ -38,6 +38,12 @@ const char Main_fileid[] = "Hatari main.c : " __DATE__ " " __TIME__;
 #include "clocks_timings.h"
 #include "file.h"
 #include "dsp.h"
+#include "sysReg.h"
+#include "printer.h"
+#include "scsi.h"
+#include "mo.h"
+#include "inputlog.h"
+#include "perfstats.h"
 
 #include "hatari-glue.h"
 
@@ -54,9 +60,20 @@ static Uint32 nFirstMilliTick;            /* Ticks when VBL counting started */
 static Uint32 nVBLCount;                  /* Frame count */
 
 static bool bEmulationActive = true;      /* Run emulation when started */
-static bool bAccurateDelays;              /* Host system has an accurate SDL_Delay()? */
 static bool bIgnoreNextMouseMotion = false;  /* Next mouse motion will be ignored (needed after SDL_WarpMouse) */
 
+/* Speed governor */
+#define SPEED_MAX_LAG_FRAMES	4		/* Resync if we are more than this many VBLs late */
+#define SPEED_STATS_INTERVAL	1000000		/* Update statistics every second (micro sec) */
+
+static Sint64 DestTicks;                  /* Host time when the current VBL is due */
+static Sint64 nStatsStartTicks;           /* Host time when the statistics interval started */
+static Sint64 nStatsEmuTime;              /* Emulated time during the statistics interval */
+static Sint64 nStatsErrorSum;             /* Sum of pacing errors during the statistics interval */
+static Sint64 nStatsErrorMax;             /* Worst pacing error during the statistics interval */
+static Uint32 nStatsVBLs;                 /* VBLs during the statistics interval */
+static SPEED_STATS SpeedStats;
+
 
 /*-----------------------------------------------------------------------*/
 /**
@@ -96,7 +113,8 @@ static Uint32 Main_GetTicks(void)
 /*-----------------------------------------------------------------------*/
 /**
  * Return a time counter in micro seconds.
- * If gettimeofday is available, we use it directly, else we convert the
+ * If clock_nanosleep is available, we use the monotonic clock it sleeps on,
+ * else if gettimeofday is available, we use it directly, else we convert the
  * return of SDL_GetTicks in micro sec.
  */
 
@@ -104,7 +122,11 @@ static Sint64	Time_GetTicks ( void )
 {
         Sint64		ticks_micro;
 
-#if HAVE_GETTIMEOFDAY
+#if HAVE_CLOCK_NANOSLEEP
+        struct timespec	now;
+        clock_gettime ( CLOCK_MONOTONIC , &now );
+        ticks_micro = (Sint64)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+#elif HAVE_GETTIMEOFDAY
         struct timeval	now;
         gettimeofday ( &now , NULL );
         ticks_micro = (Sint64)now.tv_sec * 1000000 + now.tv_usec;
@@ -116,6 +138,7 @@ static Sint64	Time_GetTicks ( void )
 }
 
 
+#if !HAVE_CLOCK_NANOSLEEP
 /*-----------------------------------------------------------------------*/
 /**
  * Sleep for a given number of micro seconds.
@@ -140,6 +163,87 @@ static void	Time_Delay ( Sint64 ticks_micro )
 	SDL_Delay ( (Uint32)(ticks_micro / 1000) ) ;	/* micro sec -> milli sec */
 #endif
 }
+#endif
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Sleep until the time counter returned by Time_GetTicks reaches the given
+ * value. With clock_nanosleep we sleep on the absolute deadline, so we can't
+ * oversleep because of a preemption between reading the clock and sleeping.
+ */
+
+static void	Time_DelayUntil ( Sint64 ticks_micro )
+{
+#if HAVE_CLOCK_NANOSLEEP
+	struct timespec	ts;
+	ts.tv_sec = ticks_micro / 1000000;
+	ts.tv_nsec = (ticks_micro % 1000000) * 1000;	/* micro sec -> nano sec */
+	/* keep on sleeping if we were interrupted by a signal */
+	while ( clock_nanosleep ( CLOCK_MONOTONIC , TIMER_ABSTIME , &ts , NULL ) == EINTR )
+		;
+#else
+	Sint64		delay_micro = ticks_micro - Time_GetTicks();
+	if ( delay_micro > 0 )
+		Time_Delay ( delay_micro );
+#endif
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Restart speed governor and its statistics, e.g. after emulation was paused.
+ */
+static void Main_SpeedReset(void)
+{
+	DestTicks = 0;
+	nStatsStartTicks = 0;
+	nStatsEmuTime = nStatsErrorSum = nStatsErrorMax = 0;
+	nStatsVBLs = 0;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Account one VBL in the speed statistics. 'EmuTime_micro' is the emulated
+ * time of the VBL and 'nError' how late (or early) the VBL was finished
+ * compared to its deadline.
+ */
+static void Main_SpeedUpdateStats(Sint64 CurrentTicks, Sint64 EmuTime_micro, Sint64 nError)
+{
+	Sint64 nInterval;
+
+	if (nStatsStartTicks == 0)
+	{
+		nStatsStartTicks = CurrentTicks;
+		return;
+	}
+
+	if (nError < 0)
+		nError = -nError;
+	nStatsEmuTime += EmuTime_micro;
+	nStatsErrorSum += nError;
+	if (nError > nStatsErrorMax)
+		nStatsErrorMax = nError;
+	nStatsVBLs++;
+
+	nInterval = CurrentTicks - nStatsStartTicks;
+	if (nInterval < SPEED_STATS_INTERVAL)
+		return;
+
+	SpeedStats.nSpeedPercent = ConfigureParams.System.bFastForward ? 0 : ConfigureParams.System.nSpeedPercent;
+	SpeedStats.fRealTime = 100.0 * nStatsEmuTime / nInterval;
+	SpeedStats.nAvgError = nStatsErrorSum / nStatsVBLs;
+	SpeedStats.nMaxError = nStatsErrorMax;
+	PerfStats_Update(nInterval);
+	Log_Printf(LOG_DEBUG, "Speed: %.1f%% of real time (target %d%%), pacing error avg %lld us, max %lld us\n",
+	           SpeedStats.fRealTime, SpeedStats.nSpeedPercent,
+	           (long long)SpeedStats.nAvgError, (long long)SpeedStats.nMaxError);
+
+	nStatsStartTicks = CurrentTicks;
+	nStatsEmuTime = nStatsErrorSum = nStatsErrorMax = 0;
+	nStatsVBLs = 0;
+}
 
 
 /*-----------------------------------------------------------------------*/
@@ -199,6 +303,9 @@ bool Main_UnPauseEmulation(void)
 	//Audio_Output_Enable(ConfigureParams.Sound.bEnableSound);
 	bEmulationActive = true;
 
+	/* Time spent in pause must not count as lag */
+	Main_SpeedReset();
+
 	/* Cause full screen update (to clear all) */
 	Screen_SetFullUpdate();
 
@@ -252,20 +359,22 @@ void Main_SetRunVBLs(Uint32 vbls)
 
 /*-----------------------------------------------------------------------*/
 /**
- * This function waits on each emulated VBL to synchronize the real time
- * with the emulated ST.
- * Unfortunately SDL_Delay and other sleep functions like usleep or nanosleep
- * are very inaccurate on some systems like Linux 2.4 or Mac OS X (they can only
- * wait for a multiple of 10ms due to the scheduler on these systems), so we have
- * to "busy wait" there to get an accurate timing.
+ * This function is called on each emulated VBL to synchronize the real time
+ * with the emulated machine. Emulated time is derived from the cycles that
+ * passed since the previous VBL and is scaled by the configured target speed.
+ * Instead of busy waiting we sleep until an absolute deadline, so rounding
+ * and wake-up latency of one frame are corrected on the next one and the host
+ * CPU is free while the guest is ahead of real time.
  * All times are expressed as micro seconds, to avoid too much rounding error.
  */
 void Main_WaitOnVbl(void)
 {
 	Sint64 CurrentTicks;
-	static Sint64 DestTicks = 0;
+	Sint64 SleepTicks;
+	Sint64 EmuTime_micro;
 	Sint64 FrameDuration_micro;
-	Sint64 nDelay;
+	Sint64 nError;
+	int nSpeed;
 
 	nVBLCount++;
 	if (nRunVBLs &&	nVBLCount >= nRunVBLs)
@@ -275,72 +384,51 @@ void Main_WaitOnVbl(void)
 		exit(0);
 	}
 
-//	FrameDuration_micro = (Sint64) ( 1000000.0 / nScreenRefreshRate + 0.5 );	/* round to closest integer */
-	FrameDuration_micro = ClocksTimings_GetVBLDuration_micro ( ConfigureParams.System.nMachineType , 68 );
-//      FrameDuration_micro = 1000000/50;
+	nSpeed = ConfigureParams.System.bFastForward ? 0 : ConfigureParams.System.nSpeedPercent;
+	EmuTime_micro = CYCLES_PER_FRAME / System_Timer_CyclesPerMicro();
 	CurrentTicks = Time_GetTicks();
 
-	if ( DestTicks == 0 )					/* first call, init DestTicks */
-    {
-		DestTicks = CurrentTicks + FrameDuration_micro;
-    }
-
-	nDelay = DestTicks - CurrentTicks;
-
-	/* Do not wait if we are in fast forward mode or if we are totally out of sync */
-	if (ConfigureParams.System.bFastForward == true
-	        || nDelay < -4*FrameDuration_micro || nDelay > 50*FrameDuration_micro)
+	/* Do not wait if we are in fast forward or unlimited speed mode */
+	if (nSpeed <= 0)
 	{
-		if (ConfigureParams.System.bFastForward == true)
-		{
-			if (!nFirstMilliTick)
-				nFirstMilliTick = Main_GetTicks();
-		}
-		if (nFrameSkips < ConfigureParams.Screen.nFrameSkips)
-		{
-			nFrameSkips += 1;
-			Log_Printf(LOG_DEBUG, "Increased frameskip to %d\n", nFrameSkips);
-		}
-		/* Only update DestTicks for next VBL */
-		DestTicks = CurrentTicks + FrameDuration_micro;
+		if (!nFirstMilliTick)
+			nFirstMilliTick = Main_GetTicks();
+		Main_SpeedUpdateStats(CurrentTicks, EmuTime_micro, 0);
+		DestTicks = 0;
 		return;
 	}
-	/* If automatic frameskip is enabled and delay's more than twice
-	 * the effect of single frameskip, decrease frameskip
-	 */
-	if (nFrameSkips > 0
-	    && ConfigureParams.Screen.nFrameSkips >= AUTO_FRAMESKIP_LIMIT
-	    && 2*nDelay > FrameDuration_micro/nFrameSkips)
-	{
-		nFrameSkips -= 1;
-		Log_Printf(LOG_DEBUG, "Decreased frameskip to %d\n", nFrameSkips);
-	}
+	FrameDuration_micro = EmuTime_micro * 100 / nSpeed;
 
-	if (bAccurateDelays)
+	if (DestTicks == 0)					/* first call, init DestTicks */
 	{
-		/* Accurate sleeping is possible -> use SDL_Delay to free the CPU */
-		if (nDelay > 1000)
-			Time_Delay(nDelay - 1000);
+		DestTicks = CurrentTicks + FrameDuration_micro;
+		return;
 	}
-	else
+
+	/* If we are totally out of sync (host was suspended, debugger was
+	 * active, ...) drop the accumulated debt instead of running flat
+	 * out until we caught up */
+	nError = CurrentTicks - DestTicks;
+	if (nError > SPEED_MAX_LAG_FRAMES*FrameDuration_micro)
 	{
-		/* No accurate SDL_Delay -> only wait if more than 5ms to go... */
-		if (nDelay > 5000)
-			Time_Delay(nDelay<10000 ? nDelay-1000 : 9000);
+		Log_Printf(LOG_DEBUG, "Speed governor lost %lld us, resyncing\n", (long long)nError);
+		SpeedStats.nResyncs++;
+		Main_SpeedUpdateStats(CurrentTicks, EmuTime_micro, nError);
+		DestTicks = CurrentTicks + FrameDuration_micro;
+		return;
 	}
 
-	/* Now busy-wait for the right tick: */
-	while (nDelay > 0)
+	if (nError < 0)
 	{
+		SleepTicks = CurrentTicks;
+		Time_DelayUntil(DestTicks);
+		/* Measure how precisely we woke up */
 		CurrentTicks = Time_GetTicks();
-		nDelay = DestTicks - CurrentTicks;
-        /* If the delay is still bigger than one frame, somebody
-         * played tricks with the system clock and we have to abort */
-        if (nDelay > FrameDuration_micro)
-            break;
+		nError = CurrentTicks - DestTicks;
+		nPerfIdleTime += CurrentTicks - SleepTicks;
 	}
+	Main_SpeedUpdateStats(CurrentTicks, EmuTime_micro, nError);
 
-//printf ( "tick %lld\n" , CurrentTicks );
 	/* Update DestTicks for next VBL */
 	DestTicks += FrameDuration_micro;
 }
@@ -348,27 +436,12 @@ void Main_WaitOnVbl(void)
 
 /*-----------------------------------------------------------------------*/
 /**
- * Since SDL_Delay and friends are very inaccurate on some systems, we have
- * to check if we can rely on this delay function.
+ * Get statistics about how well the speed governor keeps up with the
+ * target speed.
  */
-static void Main_CheckForAccurateDelays(void)
+void Main_GetSpeedStats(SPEED_STATS *pStats)
 {
-	int nStartTicks, nEndTicks;
-
-	/* Force a task switch now, so we have a longer timeslice afterwards */
-	SDL_Delay(10);
-
-	nStartTicks = SDL_GetTicks();
-	SDL_Delay(1);
-	nEndTicks = SDL_GetTicks();
-
-	/* If the delay took longer than 10ms, we are on an inaccurate system! */
-	bAccurateDelays = ((nEndTicks - nStartTicks) < 9);
-
-	if (bAccurateDelays)
-		Log_Printf(LOG_WARN, "Host system has accurate delays. (%d)\n", nEndTicks - nStartTicks);
-	else
-		Log_Printf(LOG_WARN, "Host system does not have accurate delays. (%d)\n", nEndTicks - nStartTicks);
+	*pStats = SpeedStats;
 }
 
 
@@ -551,6 +624,11 @@ static void Main_Init(void)
 		fprintf(stderr, "Logging/tracing initialization failed\n");
 		exit(-1);
 	}
+	if (!InputLog_Init())
+	{
+		fprintf(stderr, "Input log initialization failed\n");
+		exit(-1);
+	}
 	Log_Printf(LOG_INFO, PROG_NAME ", compiled on:  " __DATE__ ", " __TIME__ "\n");
 
 	/* Init SDL's video subsystem. Note: Audio and joystick subsystems
@@ -621,11 +699,16 @@ static void Main_UnInit(void)
 	IoMem_UnInit();
 	SDLGui_UnInit();
 	Screen_UnInit();
+	Printer_UnInit();
+	SCSI_Uninit();
+	MO_Uninit();
 	Exit680x0();
 
 	/* SDL uninit: */
 	SDL_Quit();
 
+	InputLog_UnInit();
+
 	/* Close debug log file */
 	Log_UnInit();
 }
@@ -733,10 +816,6 @@ int main(int argc, char *argv[])
 
 	/* Set initial Statusbar information */
 	Main_StatusbarSetup();
-	
-	/* Check if SDL_Delay is accurate */
-	Main_CheckForAccurateDelays();
-
 
 	/* Run emulation */
 	Main_UnPauseEmulation();
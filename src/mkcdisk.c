@@ -0,0 +1,129 @@
+/*
+ * Previous - mkcdisk.c
+ *
+ * This file is distributed under the GNU Public License, version 2 or at
+ * your option any later version. Read the file gpl.txt for details.
+ *
+ * Convert a SCSI or MO disk image to a compressed disk image, which can be
+ * used directly as disk image (see diskimage.c).
+ *
+ * Usage: mkcdisk <image> <compressed image> [chunk size in kB]
+ */
+const char MkCDisk_fileid[] = "Previous mkcdisk.c : " __DATE__ " " __TIME__;
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+#include <SDL_endian.h>
+
+#include "main.h"
+#include "diskimage.h"
+
+
+int main(int argc, char *argv[])
+{
+	CDISK_HEADER header;
+	FILE *in, *out;
+	Uint64 *offs, size, pos;
+	Uint32 chunksize = CDISK_CHUNKSIZE, chunks, i;
+	Uint8 *raw, *packed;
+	uLongf packedlen;
+	size_t rawlen;
+
+	if (argc < 3 || argc > 4)
+	{
+		fprintf(stderr, "Usage: %s <image> <compressed image> [chunk size in kB]\n", argv[0]);
+		return 1;
+	}
+	if (argc == 4)
+	{
+		chunksize = atoi(argv[3]) * 1024;
+		if (chunksize == 0 || chunksize > 16*1024*1024)
+		{
+			fprintf(stderr, "Invalid chunk size %s\n", argv[3]);
+			return 1;
+		}
+	}
+
+	in = fopen(argv[1], "rb");
+	if (!in)
+	{
+		perror(argv[1]);
+		return 1;
+	}
+	fseeko(in, 0, SEEK_END);
+	size = ftello(in);
+	fseeko(in, 0, SEEK_SET);
+	chunks = (size + chunksize - 1) / chunksize;
+
+	out = fopen(argv[2], "wb");
+	if (!out)
+	{
+		perror(argv[2]);
+		return 1;
+	}
+
+	offs = malloc((chunks + 1) * sizeof(Uint64));
+	raw = malloc(chunksize);
+	packed = malloc(compressBound(chunksize));
+	if (!offs || !raw || !packed)
+	{
+		fprintf(stderr, "Out of memory\n");
+		return 1;
+	}
+
+	/* Header and index are written again when the offsets are known */
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, CDISK_MAGIC, sizeof(header.magic));
+	header.version = SDL_SwapLE32(CDISK_VERSION);
+	header.chunksize = SDL_SwapLE32(chunksize);
+	header.size = SDL_SwapLE64(size);
+	header.chunks = SDL_SwapLE32(chunks);
+	pos = sizeof(header) + (chunks + 1) * sizeof(Uint64);
+	if (fwrite(&header, sizeof(header), 1, out) != 1
+	    || fseeko(out, pos, SEEK_SET) != 0)
+		goto write_error;
+
+	for (i = 0; i < chunks; i++)
+	{
+		rawlen = fread(raw, 1, chunksize, in);
+		if (rawlen != chunksize && (rawlen == 0 || i != chunks - 1))
+		{
+			perror(argv[1]);
+			return 1;
+		}
+
+		offs[i] = SDL_SwapLE64(pos);
+		packedlen = compressBound(chunksize);
+		if (compress2(packed, &packedlen, raw, rawlen, Z_BEST_COMPRESSION) == Z_OK
+		    && packedlen < rawlen)
+		{
+			if (fwrite(packed, packedlen, 1, out) != 1)
+				goto write_error;
+			pos += packedlen;
+		}
+		else
+		{
+			/* Store chunks which do not get smaller uncompressed */
+			if (fwrite(raw, rawlen, 1, out) != 1)
+				goto write_error;
+			pos += rawlen;
+		}
+	}
+	offs[chunks] = SDL_SwapLE64(pos);
+
+	if (fseeko(out, sizeof(header), SEEK_SET) != 0
+	    || fwrite(offs, sizeof(Uint64), chunks + 1, out) != chunks + 1
+	    || fclose(out) != 0)
+		goto write_error;
+	fclose(in);
+
+	printf("%s: %llu bytes in %u chunks, compressed to %llu bytes\n", argv[2],
+	       (unsigned long long)size, chunks, (unsigned long long)pos);
+	return 0;
+
+write_error:
+	perror(argv[2]);
+	return 1;
+}
@@ -26,8 +26,10 @@
 #include "dma.h"
 #include "floppy.h"
 #include "file.h"
+#include "diskimage.h"
 #include "rs.h"
 #include "statusbar.h"
+#include "perfstats.h"
 
 
 #define LOG_MO_REG_LEVEL    LOG_DEBUG
@@ -72,7 +74,7 @@ struct {
     Uint32 ho_head_pos;
     Uint32 sec_offset;
     
-    FILE* dsk;
+    DISKIMAGE* dsk;
     
     bool spinning;
     bool spiraling;
@@ -195,7 +197,6 @@ void mo_reset(void);
 void osp_select(int drive);
 
 void MO_Init(void);
-void MO_Uninit(void);
 
 /* Experimental */
 #define SECTOR_IO_DELAY 2500
@@ -1012,9 +1013,8 @@ void mo_read_sector(Uint32 sector_id) {
     Log_Printf(LOG_MO_IO_LEVEL, "MO disk %i: Read sector at offset %i (%i sectors remaining)",
                dnum, sector_num, sector_counter-1);
     
-    /* seek to the position */
-	fseek(modrv[dnum].dsk, sector_num*MO_SECTORSIZE_DISK, SEEK_SET);
-    fread(ecc_buffer[eccin].data, MO_SECTORSIZE_DISK, 1, modrv[dnum].dsk);
+    DiskImage_Read(modrv[dnum].dsk, sector_num, ecc_buffer[eccin].data);
+    nPerfMoBytes += MO_SECTORSIZE_DISK;
     
     ecc_buffer[eccin].limit = ecc_buffer[eccin].size = MO_SECTORSIZE_DISK;
 }
@@ -1026,9 +1026,8 @@ void mo_write_sector(Uint32 sector_id) {
                dnum, sector_num, sector_counter-1);
     
     if (ecc_buffer[eccout].limit==MO_SECTORSIZE_DISK) {
-        /* seek to the position */
-        fseek(modrv[dnum].dsk, sector_num*MO_SECTORSIZE_DISK, SEEK_SET);
-        fwrite(ecc_buffer[eccout].data, MO_SECTORSIZE_DISK, 1, modrv[dnum].dsk);
+        DiskImage_Write(modrv[dnum].dsk, sector_num, ecc_buffer[eccout].data);
+        nPerfMoBytes += MO_SECTORSIZE_DISK;
 
         ecc_buffer[eccout].size = 0;
         ecc_buffer[eccout].limit = MO_SECTORSIZE_DATA;
@@ -1048,9 +1047,7 @@ void mo_erase_sector(Uint32 sector_id) {
     Uint8 erase_buf[MO_SECTORSIZE_DISK];
     memset(erase_buf, 0xFF, MO_SECTORSIZE_DISK);
     
-    /* seek to the position */
-    fseek(modrv[dnum].dsk, sector_num*MO_SECTORSIZE_DISK, SEEK_SET);
-    fwrite(erase_buf, MO_SECTORSIZE_DISK, 1, modrv[dnum].dsk);
+    DiskImage_Write(modrv[dnum].dsk, sector_num, erase_buf);
 }
 
 void mo_verify_sector(Uint32 sector_id) {
@@ -1059,9 +1056,7 @@ void mo_verify_sector(Uint32 sector_id) {
     Log_Printf(LOG_MO_IO_LEVEL, "MO disk %i: Verify sector at offset %i (%i sectors remaining)",
                dnum, sector_num, sector_counter-1);
     
-    /* seek to the position */
-	fseek(modrv[dnum].dsk, sector_num*MO_SECTORSIZE_DISK, SEEK_SET);
-    fread(ecc_buffer[eccin].data, MO_SECTORSIZE_DISK, 1, modrv[dnum].dsk);
+    DiskImage_Read(modrv[dnum].dsk, sector_num, ecc_buffer[eccin].data);
     
     ecc_buffer[eccin].limit = ecc_buffer[eccin].size = MO_SECTORSIZE_DISK;
 }
@@ -1480,7 +1475,7 @@ void mo_eject_disk(int drv) {
 
     Log_Printf(LOG_WARN, "MO disk %i: Eject",drv);
     
-    File_Close(modrv[drv].dsk);
+    DiskImage_Close(modrv[drv].dsk);
     modrv[drv].dsk=NULL;
     modrv[drv].inserted=false;
     modrv[drv].spinning=false;
@@ -1493,13 +1488,10 @@ void mo_eject_disk(int drv) {
 void mo_insert_disk(int drv) {
     Log_Printf(LOG_WARN, "MO disk %i: Insert",drv);
     
-    if (ConfigureParams.MO.drive[drv].bWriteProtected) {
-        modrv[drv].dsk = File_Open(ConfigureParams.MO.drive[drv].szImageName, "rb");
-        modrv[drv].protected=true;
-    } else {
-        modrv[drv].dsk = File_Open(ConfigureParams.MO.drive[drv].szImageName, "rb+");
-        modrv[drv].protected=false;
-    }
+    modrv[drv].dsk = DiskImage_Open(ConfigureParams.MO.drive[drv].szImageName,
+                                    ConfigureParams.MO.drive[drv].bWriteProtected,
+                                    MO_SECTORSIZE_DISK, ConfigureParams.MO.nOverlayMode);
+    modrv[drv].protected = ConfigureParams.MO.drive[drv].bWriteProtected;
     
     Statusbar_AddMessage("Inserting magneto-optical disk.", 0);
     modrv[drv].inserted=true;
@@ -1688,18 +1680,20 @@ void MO_Init(void) {
             if (ConfigureParams.MO.drive[i].bDiskInserted &&
                 File_Exists(ConfigureParams.MO.drive[i].szImageName)) {
                 modrv[i].inserted=true;
-                if (ConfigureParams.MO.drive[i].bWriteProtected) {
-                    modrv[i].dsk = File_Open(ConfigureParams.MO.drive[i].szImageName, "rb");
-                    modrv[i].protected=true;
-                } else {
-                    modrv[i].dsk = File_Open(ConfigureParams.MO.drive[i].szImageName, "rb+");
-                    modrv[i].protected=false;
-                }
+                /* Disks which did not change stay open, keeping their overlay */
+                modrv[i].dsk = DiskImage_Change(modrv[i].dsk, ConfigureParams.MO.drive[i].szImageName,
+                                                ConfigureParams.MO.drive[i].bWriteProtected,
+                                                MO_SECTORSIZE_DISK, ConfigureParams.MO.nOverlayMode);
+                modrv[i].protected = ConfigureParams.MO.drive[i].bWriteProtected;
             } else {
+                DiskImage_Close(modrv[i].dsk);
                 modrv[i].dsk = NULL;
                 modrv[i].inserted=false;
             }
         } else {
+            DiskImage_Close(modrv[i].dsk);
+            modrv[i].dsk = NULL;
+            modrv[i].inserted=false;
             modrv[i].connected=false;
             modrv[i].complete=false;
             modrv[i].attn=false;
@@ -1713,11 +1707,8 @@ void MO_Init(void) {
 }
 
 void MO_Uninit(void) {
-    if (modrv[0].dsk)
-        File_Close(modrv[0].dsk);
-    if (modrv[1].dsk) {
-        File_Close(modrv[1].dsk);
-    }
+    DiskImage_Close(modrv[0].dsk);
+    DiskImage_Close(modrv[1].dsk);
     modrv[0].dsk = modrv[1].dsk = NULL;
     modrv[0].inserted = modrv[1].inserted = false;
 }
@@ -1736,6 +1727,5 @@ void MO_Eject(int drive) {
 }
 
 void MO_Reset(void) {
-    MO_Uninit();
     MO_Init();
 }
@@ -163,6 +163,8 @@ static void (*nbic_write_reg[8])(Uint32, Uint8) = {
 
 
 Uint32 nbic_reg_lget(Uint32 addr) {
+	M68000_SyncCoprocessors();
+
 	Uint32 val = 0;
 	
 	if (addr&3) {
@@ -183,6 +185,8 @@ Uint32 nbic_reg_lget(Uint32 addr) {
 }
 
 Uint32 nbic_reg_wget(uaecptr addr) {
+	M68000_SyncCoprocessors();
+
 	Uint32 val = 0;
 	
 	if (addr&1) {
@@ -201,6 +205,8 @@ Uint32 nbic_reg_wget(uaecptr addr) {
 }
 
 Uint32 nbic_reg_bget(uaecptr addr) {
+	M68000_SyncCoprocessors();
+
 	if ((addr&0x0000FFFF)>7) {
 		return nbic_bus_error_read(addr);
 	} else {
@@ -209,6 +215,8 @@ Uint32 nbic_reg_bget(uaecptr addr) {
 }
 
 void nbic_reg_lput(uaecptr addr, Uint32 l) {
+	M68000_SyncCoprocessors();
+
 	if (addr&3) {
 		Log_Printf(LOG_WARN, "[NBIC] Unaligned access at %08X.",addr);
 		abort();
@@ -225,6 +233,8 @@ void nbic_reg_lput(uaecptr addr, Uint32 l) {
 }
 
 void nbic_reg_wput(uaecptr addr, Uint32 w) {
+	M68000_SyncCoprocessors();
+
 	if (addr&1) {
 		Log_Printf(LOG_WARN, "[NBIC] Unaligned access at %08X.",addr);
 		abort();
@@ -239,6 +249,8 @@ void nbic_reg_wput(uaecptr addr, Uint32 w) {
 }
 
 void nbic_reg_bput(uaecptr addr, Uint32 b) {
+	M68000_SyncCoprocessors();
+
 	if ((addr&0x0000FFFF)>7) {
 		nbic_bus_error_write(addr,0);
 	} else {
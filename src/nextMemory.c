@@ -15,12 +15,26 @@ const char STMemory_fileid[] = "Hatari stMemory.c : " __DATE__ " " __TIME__;
 #include "memory.h"
 #include "memorySnapShot.h"
 
+#if HAVE_MMAP
+#include <sys/mman.h>
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE 0
+#endif
+#endif
+
+/* Alignment of guest RAM, so that it can be backed by huge pages */
+#define RAM_ALIGN   (2*1024*1024)
+
 /*
- * Main RAM buffer (128 MB for turbo systems)
+ * Main RAM buffer (up to NEXT_RAM_SIZE, 128 MB for turbo systems),
+ * allocated for the configured memory size in memory_init()
  */
-Uint8 NEXTRam[128*1024*1024];
+Uint8 *NEXTRam;
 
-Uint32 NEXTRamEnd;            /* End of ST Ram, above this address is no-mans-land and ROM/IO memory */
+Uint32 NEXTRamEnd;    /* Size of NEXTRam */
 
 
 Uint8 NEXTRom[0x20000];
@@ -35,6 +49,53 @@ void NEXTMemory_Clear(Uint32 StartAddress, Uint32 EndAddress)
 	memset(&NEXTRam[StartAddress], 0, EndAddress-StartAddress);
 }
 
+/**
+ * Allocate zeroed host memory for guest RAM. It is mapped anonymously,
+ * so pages only use host memory once the guest touches them, and the
+ * kernel is asked to back it with transparent huge pages.
+ * Return NULL if that fails.
+ */
+Uint8 *NEXTMemory_AllocRam(Uint32 size)
+{
+#if HAVE_MMAP
+	Uint8 *map, *ram;
+	size_t len = size + RAM_ALIGN;
+
+	map = mmap(NULL, len, PROT_READ | PROT_WRITE,
+	           MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if (map == MAP_FAILED)
+		return NULL;
+
+	/* Trim the mapping to a huge page aligned block */
+	ram = (Uint8 *)(((uintptr_t)map + RAM_ALIGN - 1) & ~(uintptr_t)(RAM_ALIGN - 1));
+	if (ram > map)
+		munmap(map, ram - map);
+	if (map + len > ram + size)
+		munmap(ram + size, map + len - (ram + size));
+
+#if HAVE_MADVISE && defined(MADV_HUGEPAGE)
+	madvise(ram, size, MADV_HUGEPAGE);
+#endif
+	return ram;
+#else
+	return calloc(1, size);
+#endif
+}
+
+/**
+ * Free guest RAM allocated with NEXTMemory_AllocRam().
+ */
+void NEXTMemory_FreeRam(Uint8 *ram, Uint32 size)
+{
+	if (!ram)
+		return;
+#if HAVE_MMAP
+	munmap(ram, size);
+#else
+	free(ram);
+#endif
+}
+
 /** --useful for next?
  * Copy given memory area safely to Atari RAM.
  * If the memory area isn't fully within RAM, only the valid parts are written.
@@ -51,6 +51,9 @@ enum {
 	OPT_CONFIGFILE,
 	OPT_KEYMAPFILE,
 	OPT_FASTFORWARD,
+	OPT_FASTBOOT,
+	OPT_SPEED,
+	OPT_QUANTUM,
 	OPT_MONO,		/* common display options */
 	OPT_MONITOR,
 	OPT_FULLSCREEN,
@@ -59,6 +62,7 @@ enum {
 	OPT_FRAMESKIPS,
 	OPT_STATUSBAR,
 	OPT_DRIVE_LED,
+	OPT_PERFORMANCE,
 	OPT_FORCEBPP,
 	OPT_BORDERS,		/* ST/STE display options */
 	OPT_SPEC512,
@@ -75,6 +79,7 @@ enum {
 	OPT_AVIRECORD,
 	OPT_AVIRECORD_VCODEC,
 	OPT_AVIRECORD_FPS,
+	OPT_AVIRECORD_PNGLEVEL,
 	OPT_AVIRECORD_FILE,
 	OPT_JOYSTICK,		/* device options */
 	OPT_JOYSTICK0,
@@ -93,6 +98,8 @@ enum {
 	OPT_SLOWFLOPPY,
 	OPT_WRITEPROT_FLOPPY,
 	OPT_WRITEPROT_HD,
+	OPT_SCSI_OVERLAY,
+	OPT_MO_OVERLAY,
 	OPT_HARDDRIVE,
 	OPT_ACSIHDIMAGE,
 	OPT_IDEMASTERHDIMAGE,
@@ -124,6 +131,9 @@ enum {
 	OPT_BIOSINTERCEPT,
 	OPT_TRACE,
 	OPT_TRACEFILE,
+	OPT_TRACEBIN,
+	OPT_RECORDINPUT,
+	OPT_REPLAYINPUT,
 	OPT_PARSE,
 	OPT_SAVECONFIG,
 	OPT_PARACHUTE,
@@ -160,6 +170,12 @@ static const opt_t HatariOptions[] = {
 	  "<file>", "Read (additional) keyboard mappings from <file>" },
 	{ OPT_FASTFORWARD, NULL, "--fast-forward",
 	  "<bool>", "Help skipping stuff on fast machine" },
+	{ OPT_FASTBOOT, NULL, "--fast-boot",
+	  "<bool>", "Speed up the ROM memory test (known ROMs only)" },
+	{ OPT_SPEED, NULL, "--speed",
+	  "<x>", "Run at <x> percent of real time (0=unlimited)" },
+	{ OPT_QUANTUM, NULL, "--quantum",
+	  "<x>", "Run DSP and i860 in slices of <x> CPU cycles (0=lockstep)" },
 
 	{ OPT_HEADER, NULL, NULL, NULL, "Common display" },
 	{ OPT_MONO,      "-m", "--mono",
@@ -178,6 +194,8 @@ static const opt_t HatariOptions[] = {
 	  "<bool>", "Show statusbar (floppy leds etc)" },
 	{ OPT_DRIVE_LED,   NULL, "--drive-led",
 	  "<bool>", "Show overlay drive led when statusbar isn't shown" },
+	{ OPT_PERFORMANCE, NULL, "--statusbar-perf",
+	  "<bool>", "Show emulation speed in statusbar instead of machine info" },
 	{ OPT_FORCEBPP, NULL, "--bpp",
 	  "<x>", "Force internal bitdepth (x = 8/15/16/32, 0=disable)" },
 
@@ -218,6 +236,8 @@ static const opt_t HatariOptions[] = {
 	  "<x>", "Select avi video codec (x = bmp/png)" },
 	{ OPT_AVIRECORD_FPS, NULL, "--avi-fps",
 	  "<x>", "Force avi frame rate (x = 50/60/71/...)" },
+	{ OPT_AVIRECORD_PNGLEVEL, NULL, "--avi-png-level",
+	  "<x>", "Avi png compression level (x = 0-9, lower is faster)" },
 	{ OPT_AVIRECORD_FILE, NULL, "--avi-file",
 	  "<file>", "Use <file> to record avi" },
 
@@ -263,6 +283,10 @@ static const opt_t HatariOptions[] = {
 	  "<x>", "Write protect floppy image contents (on/off/auto)" },
 	{ OPT_WRITEPROT_HD, NULL, "--protect-hd",
 	  "<x>", "Write protect harddrive <dir> contents (on/off/auto)" },
+	{ OPT_SCSI_OVERLAY, NULL, "--scsi-overlay",
+	  "<x>", "Write SCSI disk changes to an overlay until exit or disk change (x = off/discard/commit)" },
+	{ OPT_MO_OVERLAY, NULL, "--mo-overlay",
+	  "<x>", "Write MO disk changes to an overlay until exit or disk change (x = off/discard/commit)" },
 	{ OPT_HARDDRIVE, "-d", "--harddrive",
 	  "<dir>", "Emulate harddrive partition(s) with <dir> contents" },
 	{ OPT_ACSIHDIMAGE,   NULL, "--acsi",
@@ -331,6 +355,12 @@ static const opt_t HatariOptions[] = {
 	  "<trace1,...>", "Activate emulation tracing, see '--trace help'" },
 	{ OPT_TRACEFILE, NULL, "--trace-file",
 	  "<file>", "Save trace output to <file> (default=stderr)" },
+	{ OPT_TRACEBIN, NULL, "--trace-bin",
+	  "<file>", "Save trace output in binary form to <file> (see tracedec)" },
+	{ OPT_RECORDINPUT, NULL, "--record-input",
+	  "<file>", "Record keyboard, mouse and network input to <file>" },
+	{ OPT_REPLAYINPUT, NULL, "--replay-input",
+	  "<file>", "Replay input recorded with --record-input from <file>" },
 	{ OPT_PARSE, NULL, "--parse",
 	  "<file>", "Parse/execute debugger commands from <file>" },
 	{ OPT_SAVECONFIG, NULL, "--saveconfig",
@@ -583,6 +613,24 @@ static bool Opt_Bool(const char *arg, int optid, bool *conf)
 }
 
 
+/**
+ * Set 'mode' to the disk overlay mode given as 'arg' (off/discard/commit).
+ * Return false for any other value, otherwise true
+ */
+static bool Opt_Overlay(const char *arg, int optid, OVERLAY_MODE *mode)
+{
+	if (strcasecmp(arg, "off") == 0)
+		*mode = OVERLAY_OFF;
+	else if (strcasecmp(arg, "discard") == 0)
+		*mode = OVERLAY_DISCARD;
+	else if (strcasecmp(arg, "commit") == 0)
+		*mode = OVERLAY_COMMIT;
+	else
+		return Opt_ShowError(optid, arg, "Unknown overlay mode");
+	return true;
+}
+
+
 /**
  * checks str argument agaist options of type "--option<digit>".
  * If match is found, returns ID for that, otherwise OPT_CONTINUE
@@ -850,6 +898,28 @@ bool Opt_ParseParameters(int argc, const char * const argv[])
 		case OPT_FASTFORWARD:
 			ok = Opt_Bool(argv[++i], OPT_FASTFORWARD, &ConfigureParams.System.bFastForward);
 			break;
+
+		case OPT_FASTBOOT:
+			ok = Opt_Bool(argv[++i], OPT_FASTBOOT, &ConfigureParams.System.bFastBoot);
+			break;
+
+		case OPT_SPEED:
+			val = atoi(argv[++i]);
+			if (val < 0)
+			{
+				return Opt_ShowError(OPT_SPEED, argv[i], "Invalid speed value");
+			}
+			ConfigureParams.System.nSpeedPercent = val;
+			break;
+
+		case OPT_QUANTUM:
+			val = atoi(argv[++i]);
+			if (val < 0 || val > 1024)
+			{
+				return Opt_ShowError(OPT_QUANTUM, argv[i], "Invalid quantum value (0-1024)");
+			}
+			ConfigureParams.System.nCoprocQuantum = val;
+			break;
 			
 		case OPT_CONFIGFILE:
 			i += 1;
@@ -928,6 +998,10 @@ bool Opt_ParseParameters(int argc, const char * const argv[])
 			ok = Opt_Bool(argv[++i], OPT_DRIVE_LED, &ConfigureParams.Screen.bShowDriveLed);
 			break;
 			
+		case OPT_PERFORMANCE:
+			ok = Opt_Bool(argv[++i], OPT_PERFORMANCE, &ConfigureParams.Screen.bShowPerformance);
+			break;
+			
 		case OPT_FORCEBPP:
 			planes = atoi(argv[++i]);
 			switch(planes)
@@ -1031,6 +1105,16 @@ bool Opt_ParseParameters(int argc, const char * const argv[])
 			ConfigureParams.Video.AviRecordFps = val;
 			break;
 
+		case OPT_AVIRECORD_PNGLEVEL:
+			val = atoi(argv[++i]);
+			if (val < 0 || val > 9)
+			{
+				return Opt_ShowError(OPT_AVIRECORD_PNGLEVEL, argv[i],
+							"Invalid png compression level for avi recording");
+			}
+			ConfigureParams.Video.AviRecordPngLevel = val;
+			break;
+
 		case OPT_AVIRECORD_FILE:
 			i += 1;
 			/* false -> file is created if it doesn't exist */
@@ -1200,6 +1284,14 @@ bool Opt_ParseParameters(int argc, const char * const argv[])
 				return Opt_ShowError(OPT_WRITEPROT_HD, argv[i], "Unknown option value");
 			break;
 
+		case OPT_SCSI_OVERLAY:
+			ok = Opt_Overlay(argv[++i], OPT_SCSI_OVERLAY, &ConfigureParams.SCSI.nOverlayMode);
+			break;
+
+		case OPT_MO_OVERLAY:
+			ok = Opt_Overlay(argv[++i], OPT_MO_OVERLAY, &ConfigureParams.MO.nOverlayMode);
+			break;
+
 		case OPT_HARDDRIVE:
 			i += 1;
 //			ok = Opt_StrCpy(OPT_HARDDRIVE, false, ConfigureParams.HardDisk.szHardDiskDirectories[0],
@@ -1555,6 +1647,27 @@ bool Opt_ParseParameters(int argc, const char * const argv[])
 					NULL);
 			break;
 
+		case OPT_TRACEBIN:
+			i += 1;
+			ok = Opt_StrCpy(OPT_TRACEBIN, false, ConfigureParams.Log.sTraceBinFileName,
+					argv[i], sizeof(ConfigureParams.Log.sTraceBinFileName),
+					NULL);
+			break;
+
+		case OPT_RECORDINPUT:
+			i += 1;
+			ok = Opt_StrCpy(OPT_RECORDINPUT, false, ConfigureParams.Log.sInputRecordFileName,
+					argv[i], sizeof(ConfigureParams.Log.sInputRecordFileName),
+					NULL);
+			break;
+
+		case OPT_REPLAYINPUT:
+			i += 1;
+			ok = Opt_StrCpy(OPT_REPLAYINPUT, true, ConfigureParams.Log.sInputReplayFileName,
+					argv[i], sizeof(ConfigureParams.Log.sInputReplayFileName),
+					NULL);
+			break;
+
 		case OPT_CONTROLSOCKET:
 			i += 1;
 			errstr = Control_SetSocket(argv[i]);
@@ -0,0 +1,163 @@
+/*
+  Hatari - perfstats.c
+
+  This file is distributed under the GNU Public License, version 2 or at
+  your option any later version. Read the file gpl.txt for details.
+
+  Performance counters. The counters are plain variables incremented in
+  the run loops and I/O paths, so they are cheap enough to be always on.
+  Once per second the speed governor calls PerfStats_Update() to turn
+  them into rates, which the statusbar can show. PerfStats_Print()
+  formats everything as "name value" lines for the control socket.
+*/
+const char PerfStats_fileid[] = "Hatari perfstats.c : " __DATE__ " " __TIME__;
+
+#include <inttypes.h>
+#include <SDL.h>
+
+#include "main.h"
+#include "cycInt.h"
+#include "perfstats.h"
+
+Uint64 nPerfCpuInstr;
+Uint64 nPerfDspInstr;
+Uint64 nPerfDspCycles;
+Uint64 nPerfDspBusyCycles;
+Uint64 nPerfI860Instr;
+Uint64 nPerfI860Steps;
+Uint64 nPerfIdleTime;
+Uint64 nPerfRenderTime;
+Uint64 nPerfFramesDrawn;
+Uint64 nPerfFramesSkipped;
+Uint64 nPerfScsiBytes;
+Uint64 nPerfMoBytes;
+Uint64 nPerfEnetRxBytes;
+Uint64 nPerfEnetTxBytes;
+Uint32 nPerfAudioUnderruns;
+
+static PERF_RATES PerfRates;
+static Uint64 nLastCpuInstr;
+static Uint64 nLastDspInstr;
+static Uint64 nLastDspCycles;
+static Uint64 nLastDspBusyCycles;
+static Uint64 nLastI860Instr;
+static Uint64 nLastI860Steps;
+static Uint64 nLastIdleTime;
+static Uint64 nLastRenderTime;
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Return 'part' in % of 'total', 0 if there is no total.
+ */
+static float PerfStats_Percent(Uint64 part, Uint64 total)
+{
+	if (total == 0)
+		return 0.0;
+	return 100.0 * part / total;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Compute the rates for the last 'nInterval_micro' micro seconds.
+ */
+void PerfStats_Update(Sint64 nInterval_micro)
+{
+	Uint64 nIdle, nRender;
+
+	if (nInterval_micro <= 0)
+		return;
+
+	/* Instructions per micro second are MIPS */
+	PerfRates.fCpuMips = (float)(nPerfCpuInstr - nLastCpuInstr) / nInterval_micro;
+	PerfRates.fDspMips = (float)(nPerfDspInstr - nLastDspInstr) / nInterval_micro;
+	PerfRates.fI860Mips = (float)(nPerfI860Instr - nLastI860Instr) / nInterval_micro;
+
+	PerfRates.fDspLoad = PerfStats_Percent(nPerfDspBusyCycles - nLastDspBusyCycles,
+	                                       nPerfDspCycles - nLastDspCycles);
+	PerfRates.fI860Load = PerfStats_Percent(nPerfI860Instr - nLastI860Instr,
+	                                        nPerfI860Steps - nLastI860Steps);
+
+	/* Everything the main thread did not sleep or draw is emulation */
+	nIdle = nPerfIdleTime - nLastIdleTime;
+	nRender = (nPerfRenderTime - nLastRenderTime) * 1000000 / SDL_GetPerformanceFrequency();
+	if (nRender > (Uint64)nInterval_micro)
+		nRender = nInterval_micro;
+	if (nIdle > nInterval_micro - nRender)
+		nIdle = nInterval_micro - nRender;
+	PerfRates.fHostRender = PerfStats_Percent(nRender, nInterval_micro);
+	PerfRates.fHostEmu = PerfStats_Percent(nInterval_micro - nIdle - nRender, nInterval_micro);
+	PerfRates.nUpdates++;
+
+	nLastCpuInstr = nPerfCpuInstr;
+	nLastDspInstr = nPerfDspInstr;
+	nLastDspCycles = nPerfDspCycles;
+	nLastDspBusyCycles = nPerfDspBusyCycles;
+	nLastI860Instr = nPerfI860Instr;
+	nLastI860Steps = nPerfI860Steps;
+	nLastIdleTime = nPerfIdleTime;
+	nLastRenderTime = nPerfRenderTime;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Get the rates from the last update.
+ */
+void PerfStats_GetRates(PERF_RATES *pRates)
+{
+	*pRates = PerfRates;
+}
+
+
+/*-----------------------------------------------------------------------*/
+/**
+ * Write all statistics as "name value" lines to 'buffer'.
+ * Return the length of the text.
+ */
+int PerfStats_Print(char *buffer, int size)
+{
+	SPEED_STATS speed;
+	const char *name;
+	Uint64 count;
+	int i, len;
+
+	Main_GetSpeedStats(&speed);
+
+	len = snprintf(buffer, size,
+	               "cpu_mips %.2f\n"
+	               "dsp_mips %.2f\n"
+	               "i860_mips %.2f\n"
+	               "dsp_load_percent %.1f\n"
+	               "i860_load_percent %.1f\n"
+	               "host_emu_percent %.1f\n"
+	               "host_render_percent %.1f\n"
+	               "realtime_percent %.1f\n"
+	               "target_percent %d\n"
+	               "frames_drawn %"PRIu64"\n"
+	               "frames_skipped %"PRIu64"\n"
+	               "scsi_bytes %"PRIu64"\n"
+	               "mo_bytes %"PRIu64"\n"
+	               "enet_rx_bytes %"PRIu64"\n"
+	               "enet_tx_bytes %"PRIu64"\n"
+	               "audio_underruns %u\n",
+	               PerfRates.fCpuMips, PerfRates.fDspMips, PerfRates.fI860Mips,
+	               PerfRates.fDspLoad, PerfRates.fI860Load,
+	               PerfRates.fHostEmu, PerfRates.fHostRender,
+	               speed.fRealTime, speed.nSpeedPercent,
+	               nPerfFramesDrawn, nPerfFramesSkipped,
+	               nPerfScsiBytes, nPerfMoBytes,
+	               nPerfEnetRxBytes, nPerfEnetTxBytes,
+	               nPerfAudioUnderruns);
+
+	for (i = INTERRUPT_NULL + 1; i < MAX_INTERRUPTS && len < size; i++)
+	{
+		name = CycInt_GetEventCount(i, &count);
+		len += snprintf(buffer + len, size - len, "cycint_%s %"PRIu64"\n", name, count);
+	}
+
+	if (len >= size)
+		len = size - 1;
+	return len;
+}
@@ -18,6 +18,7 @@
 #include "file.h"
 
 #include "png.h"
+#include <SDL.h>
 
 #define USE_PNG_PRINTING 1
 
@@ -682,49 +683,194 @@ char *lp_get_filename(void) {
 }
 
 
-/* PNG printing functions */
+/* PNG printing functions
+ *
+ * Finished pages are handed to an encoder thread, so that compressing and
+ * writing the image file does not stall the emulation. The queue holds up
+ * to LP_PNG_QUEUE_LEN pages, the emulation only waits when it is full.
+ */
 #if USE_PNG_PRINTING
+#define LP_PNG_QUEUE_LEN 4
+
 const int MAX_PAGE_LEN = 400 * 14; // 14 inches is the length of US legal paper, longest paper that fits into the NeXT printer cartridge
-png_structp png_ptr          = NULL;
-png_infop   png_info_ptr     = NULL;
-png_byte**  png_row_pointers = NULL;
-int         png_width;
-int         png_height;
+
+typedef struct {
+    png_byte*  data;      /* MAX_PAGE_LEN rows of width/8 bytes */
+    int        width;
+    int        height;
+    char*      path;
+} lp_page_t;
+
+lp_page_t*  png_page         = NULL; /* page being printed */
 int         png_count;
 int         png_page_count   = 0;
-char*       png_path;
+
+static lp_page_t*   png_queue[LP_PNG_QUEUE_LEN];
+static int          png_queue_head  = 0;
+static int          png_queue_count = 0;
+static bool         png_queue_quit  = false;
+static SDL_mutex*   png_queue_mutex = NULL;
+static SDL_cond*    png_queue_cond  = NULL;
+static SDL_Thread*  png_thread      = NULL;
+static SDL_atomic_t png_write_failed;
+
+static void lp_png_free(lp_page_t* page) {
+    free(page->data);
+    free(page->path);
+    free(page);
+}
+
+/* Encode one page and write it to its file (called from encoder thread) */
+static void lp_png_write(lp_page_t* page) {
+    png_structp png_ptr;
+    png_infop   png_info_ptr;
+    png_byte**  png_row_pointers;
+    FILE*       png_fp;
+    int         i;
+    
+    png_fp = File_Open(page->path, "wb");
+    if (!png_fp) {
+        SDL_AtomicSet(&png_write_failed, 1);
+        return;
+    }
+    
+    png_row_pointers = malloc(page->height * sizeof(png_byte *) + 1);
+    png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
+    png_info_ptr = png_ptr ? png_create_info_struct(png_ptr) : NULL;
+    if (!png_row_pointers || !png_info_ptr || setjmp(png_jmpbuf(png_ptr))) {
+        Log_Printf(LOG_WARN, "[LP] Could not encode page %s", page->path);
+        SDL_AtomicSet(&png_write_failed, 1);
+        if (png_ptr) {
+            png_destroy_write_struct(&png_ptr, &png_info_ptr);
+        }
+        free(png_row_pointers);
+        File_Close(png_fp);
+        return;
+    }
+    
+    for (i = 0; i < page->height; i++) {
+        png_row_pointers[i] = page->data + i * (page->width / 8);
+    }
+    png_set_IHDR(png_ptr,
+                 png_info_ptr,
+                 page->width,
+                 page->height,
+                 1,
+                 PNG_COLOR_TYPE_GRAY,
+                 PNG_INTERLACE_NONE,
+                 PNG_COMPRESSION_TYPE_DEFAULT,
+                 PNG_FILTER_TYPE_DEFAULT);
+    
+    png_init_io(png_ptr, png_fp);
+    png_set_rows(png_ptr, png_info_ptr, png_row_pointers);
+    png_write_png(png_ptr, png_info_ptr, PNG_TRANSFORM_IDENTITY, NULL);
+    
+    png_destroy_write_struct(&png_ptr, &png_info_ptr);
+    free(png_row_pointers);
+    File_Close(png_fp);
+}
+
+/* Encoder thread: write queued pages until asked to quit and queue is empty */
+static int lp_png_thread(void* unused) {
+    lp_page_t* page;
+    
+    SDL_LockMutex(png_queue_mutex);
+    for (;;) {
+        while (png_queue_count == 0 && !png_queue_quit) {
+            SDL_CondWait(png_queue_cond, png_queue_mutex);
+        }
+        if (png_queue_count == 0) {
+            break;
+        }
+        page = png_queue[png_queue_head];
+        SDL_UnlockMutex(png_queue_mutex);
+        
+        lp_png_write(page);
+        lp_png_free(page);
+        
+        /* Keep the slot until the page is written to limit memory use */
+        SDL_LockMutex(png_queue_mutex);
+        png_queue_head = (png_queue_head + 1) % LP_PNG_QUEUE_LEN;
+        png_queue_count--;
+        SDL_CondBroadcast(png_queue_cond);
+    }
+    SDL_UnlockMutex(png_queue_mutex);
+    
+    return 0;
+}
+
+static bool lp_png_start_thread(void) {
+    if (png_thread) {
+        return true;
+    }
+    if (!png_queue_mutex) {
+        png_queue_mutex = SDL_CreateMutex();
+    }
+    if (!png_queue_cond) {
+        png_queue_cond = SDL_CreateCond();
+    }
+    if (png_queue_mutex && png_queue_cond) {
+        png_queue_quit = false;
+        png_thread = SDL_CreateThread(lp_png_thread, "PrinterEncoder", NULL);
+    }
+    if (!png_thread) {
+        Log_Printf(LOG_WARN, "[LP] Could not start encoder thread, printing synchronously.");
+        return false;
+    }
+    return true;
+}
+
+/* Queue a finished page for encoding, waits only if the queue is full */
+static void lp_png_queue(lp_page_t* page) {
+    if (!lp_png_start_thread()) {
+        lp_png_write(page);
+        lp_png_free(page);
+        return;
+    }
+    
+    SDL_LockMutex(png_queue_mutex);
+    if (png_queue_count == LP_PNG_QUEUE_LEN) {
+        Log_Printf(LOG_LP_LEVEL, "[LP] Encoder queue full, waiting.");
+    }
+    while (png_queue_count == LP_PNG_QUEUE_LEN) {
+        SDL_CondWait(png_queue_cond, png_queue_mutex);
+    }
+    png_queue[(png_queue_head + png_queue_count) % LP_PNG_QUEUE_LEN] = page;
+    png_queue_count++;
+    SDL_CondBroadcast(png_queue_cond);
+    SDL_UnlockMutex(png_queue_mutex);
+}
+
+/* Report errors from the encoder thread on the status bar */
+static void lp_png_check_error(void) {
+    if (SDL_AtomicSet(&png_write_failed, 0)) {
+        Statusbar_AddMessage("Laser Printer Error: Could not create output file!", 10000);
+    }
+}
 #endif
 
 void lp_png_setup(Uint32 data) {
 #if USE_PNG_PRINTING
-    int i;
-    png_width = ((data >> 16) & 0x7F) * 32;
+    lp_png_check_error();
     
-    if (png_ptr) {
-        for (i = 0; i < MAX_PAGE_LEN; i++) {
-            png_free(png_ptr, png_row_pointers[i]);
-        }
-        png_free(png_ptr, png_row_pointers);
-        png_destroy_write_struct(&png_ptr, &png_info_ptr);
+    if (png_page) {
+        lp_png_free(png_page);
     }
     
-    png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
-    if (png_ptr == NULL) {
+    png_page = calloc(1, sizeof(lp_page_t));
+    if (png_page == NULL) {
         return;
     }
-    png_info_ptr = png_create_info_struct(png_ptr);
-    if (png_info_ptr == NULL) {
-        png_destroy_write_struct(&png_ptr, &png_info_ptr);
-        png_ptr = NULL;
-        return;
+    png_page->width = ((data >> 16) & 0x7F) * 32;
+    if (png_page->width) {
+        png_page->data = malloc(MAX_PAGE_LEN * (png_page->width / 8));
     }
-    
-    png_row_pointers = png_malloc(png_ptr, MAX_PAGE_LEN * sizeof (png_byte *));
-    for (i = 0; i < MAX_PAGE_LEN; i++) {
-        png_row_pointers[i] = png_malloc(png_ptr, sizeof (uint8_t) * (png_width / 8));
+    if (png_page->data == NULL) {
+        lp_png_free(png_page);
+        png_page = NULL;
+        return;
     }
-    png_count  = 0;
-    png_height = 0;
+    png_count = 0;
 #endif
 }
 
@@ -732,8 +878,11 @@ void lp_png_print(void) {
 #if USE_PNG_PRINTING
     int i;
     
-    for (i = 0; i < lp_buffer.size; i++) {
-        png_row_pointers[png_count/png_width][(png_count%png_width)/8] = ~lp_buffer.data[i];
+    if (png_page == NULL) {
+        return;
+    }
+    for (i = 0; i < lp_buffer.size && png_count / png_page->width < MAX_PAGE_LEN; i++) {
+        png_page->data[png_count/8] = ~lp_buffer.data[i];
         png_count += 8;
     }
 #endif
@@ -741,29 +890,45 @@ void lp_png_print(void) {
 
 void lp_png_finish(void) {
 #if USE_PNG_PRINTING
-    png_set_IHDR(png_ptr,
-                 png_info_ptr,
-                 png_width,
-                 png_count / png_width,
-                 1,
-                 PNG_COLOR_TYPE_GRAY,
-                 PNG_INTERLACE_NONE,
-                 PNG_COMPRESSION_TYPE_DEFAULT,
-                 PNG_FILTER_TYPE_DEFAULT);
-    
-    png_path = lp_get_filename();
-    
-    FILE* png_fp = File_Open(png_path, "wb");
+    lp_png_check_error();
     
-    if (png_fp) {
-        png_init_io(png_ptr, png_fp);
-        png_set_rows(png_ptr, png_info_ptr, png_row_pointers);
-        png_write_png(png_ptr, png_info_ptr, PNG_TRANSFORM_IDENTITY, NULL);
+    if (png_page == NULL) {
+        return;
+    }
+    png_page->height = png_count / png_page->width;
+    png_page->path   = strdup(lp_get_filename());
+    if (png_page->path == NULL) {
+        lp_png_free(png_page);
     } else {
-        Statusbar_AddMessage("Laser Printer Error: Could not create output file!", 10000);
+        lp_png_queue(png_page);
     }
-    
-    File_Close(png_fp);
+    png_page = NULL;
     png_page_count++;
 #endif
 }
+
+/* Wait for queued pages to be written and stop the encoder thread */
+void Printer_UnInit(void) {
+#if USE_PNG_PRINTING
+    if (png_thread) {
+        SDL_LockMutex(png_queue_mutex);
+        png_queue_quit = true;
+        SDL_CondBroadcast(png_queue_cond);
+        SDL_UnlockMutex(png_queue_mutex);
+        SDL_WaitThread(png_thread, NULL);
+        png_thread = NULL;
+    }
+    if (png_queue_cond) {
+        SDL_DestroyCond(png_queue_cond);
+        png_queue_cond = NULL;
+    }
+    if (png_queue_mutex) {
+        SDL_DestroyMutex(png_queue_mutex);
+        png_queue_mutex = NULL;
+    }
+    if (png_page) {
+        lp_png_free(png_page);
+        png_page = NULL;
+    }
+#endif
+}
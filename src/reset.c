@@ -28,6 +28,8 @@ const char Reset_fileid[] = "Hatari reset.c : " __DATE__ " " __TIME__;
 #include "snd.h"
 #include "printer.h"
 #include "dsp.h"
+#include "fastboot.h"
+#include "inputlog.h"
 
 
 /*-----------------------------------------------------------------------*/
@@ -59,6 +61,8 @@ static const char* Reset_ST(bool bCold)
 	Printer_Reset();              /* Reset Printer */
 	Screen_Reset();               /* Reset screen */
 	DSP_Reset();                  /* Reset DSP */
+	FastBoot_Reset();             /* Re-arm ROM self test shortcut */
+	InputLog_Reset();             /* Re-arm input replay */
 	M68000_Reset(bCold);          /* Reset CPU */
 	DebugCpu_SetDebugging();      /* Re-set debugging flag if needed */
 
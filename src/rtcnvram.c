@@ -16,6 +16,7 @@
 #include "dimension.h"
 #include "sysReg.h"
 #include "rtcnvram.h"
+#include "inputlog.h"
 
 #include <time.h>
 
@@ -338,7 +339,7 @@ time_t time_offset=0;
 RTC_TIME my_get_rtc_time(void) {
     RTC_TIME rt;
     
-    time_t tmp = time(NULL) + time_offset;
+    time_t tmp = InputLog_Time() + time_offset;
     struct tm t =*localtime(&tmp);
     
     rt.sec = (((t.tm_sec/10)%10)<<4)|(t.tm_sec%10);
@@ -355,7 +356,7 @@ RTC_TIME my_get_rtc_time(void) {
 void my_set_rtc_time(int which,int val) {
     RTC_TIME rt;
     
-    time_t tmp = time(NULL);
+    time_t tmp = InputLog_Time();
     time_t tmp2;
 
     static struct tm t;
@@ -542,7 +543,7 @@ int newrtc_interface_io(Uint8 rtdatabit) {
 Uint8 newrtc_get_clock(Uint8 addr) {
     Uint8 val = 0x00;
     
-    newrtc.timecntr = time(NULL);
+    newrtc.timecntr = InputLog_Time();
     
     switch (rtc_addr&RTC_ADDR_MASK) {
         case 0x20:
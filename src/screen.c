@@ -23,6 +23,7 @@ const char Screen_fileid[] = "Hatari screen.c : " __DATE__ " " __TIME__;
 #include "resolution.h"
 #include "statusbar.h"
 #include "video.h"
+#include "perfstats.h"
 
 
 /* extern for several purposes */
@@ -614,10 +615,12 @@ static bool Screen_DrawFrame(bool bForceFlip)
 		Statusbar_Update(sdlscrn);
 
 		Screen_Blit();
+		nPerfFramesDrawn++;
 
 		return bScreenContentsChanged;
 	}
 
+	nPerfFramesSkipped++;
 	return false;
 }
 
@@ -628,10 +631,14 @@ static bool Screen_DrawFrame(bool bForceFlip)
  */
 bool Screen_Draw(void)
 {
+	Uint64 nStart;
+
 	if (!bQuitProgram)
 	{
+		nStart = SDL_GetPerformanceCounter();
 		/* And draw (if screen contents changed) */
 		Screen_DrawFrame(false);
+		nPerfRenderTime += SDL_GetPerformanceCounter() - nStart;
 		return true;
 	}
 
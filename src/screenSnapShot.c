@@ -99,7 +99,6 @@ static int ScreenSnapShot_SavePNG(SDL_Surface *surface, const char *filename)
 /**
  * Save given SDL surface as PNG in an already opened FILE, eventually cropping some borders.
  * Return png file size > 0 for success.
- * This function is also used by avi_record.c to save individual frames as png images.
  */
 int ScreenSnapShot_SavePNG_ToFile(SDL_Surface *surface, FILE *fp, int png_compression_level, int png_filter ,
 		int CropLeft , int CropRight , int CropTop , int CropBottom )
@@ -8,6 +8,8 @@
 #include "statusbar.h"
 #include "scsi.h"
 #include "file.h"
+#include "diskimage.h"
+#include "perfstats.h"
 
 #define LOG_SCSI_LEVEL  LOG_DEBUG    /* Print debugging messages */
 
@@ -121,7 +123,7 @@ void scsi_write_sector(void);
 /* SCSI disk */
 struct {
     SCSI_DEVTYPE devtype;
-    FILE* dsk;
+    DISKIMAGE* dsk;
     Uint32 size;
     bool readonly;
     Uint8 lun;
@@ -162,11 +164,14 @@ void SCSI_Init(void) {
     int i;
     for (i = 0; i < ESP_MAX_DEVS; i++) {
         if (File_Exists(ConfigureParams.SCSI.target[i].szImageName) && ConfigureParams.SCSI.target[i].bDiskInserted) {
-            SCSIdisk[i].size = File_Length(ConfigureParams.SCSI.target[i].szImageName);
-            SCSIdisk[i].dsk = ConfigureParams.SCSI.target[i].bWriteProtected ?
-            File_Open(ConfigureParams.SCSI.target[i].szImageName, "rb") :
-            File_Open(ConfigureParams.SCSI.target[i].szImageName, "rb+");
+            /* Disks which did not change stay open, keeping their overlay */
+            SCSIdisk[i].dsk = DiskImage_Change(SCSIdisk[i].dsk,
+                                               ConfigureParams.SCSI.target[i].szImageName,
+                                               ConfigureParams.SCSI.target[i].bWriteProtected,
+                                               BLOCKSIZE, ConfigureParams.SCSI.nOverlayMode);
+            SCSIdisk[i].size = SCSIdisk[i].dsk ? SCSIdisk[i].dsk->size : 0;
         } else {
+            DiskImage_Close(SCSIdisk[i].dsk);
             SCSIdisk[i].size = 0;
             SCSIdisk[i].dsk = NULL;
         }
@@ -187,14 +192,13 @@ void SCSI_Uninit(void) {
     int i;
     for (i = 0; i < ESP_MAX_DEVS; i++) {
         if (SCSIdisk[i].dsk) {
-    		File_Close(SCSIdisk[i].dsk);
+            DiskImage_Close(SCSIdisk[i].dsk);
             SCSIdisk[i].dsk = NULL;
         }
     }
 }
 
 void SCSI_Reset(void) {
-    SCSI_Uninit();
     SCSI_Init();
 }
 
@@ -596,12 +600,12 @@ void scsi_write_sector(void) {
     Log_Printf(LOG_SCSI_LEVEL, "[SCSI] Writing block at offset %i (%i blocks remaining).",
                SCSIdisk[target].lba,SCSIdisk[target].blockcounter-1);
     
-    /* seek to the position */
-	if ((SCSIdisk[target].dsk==NULL) || (fseek(SCSIdisk[target].dsk, SCSIdisk[target].lba*BLOCKSIZE, SEEK_SET) != 0)) {
+	if (SCSIdisk[target].dsk==NULL) {
         n = 0;
 	} else {
 #if 1
-        n = fwrite(scsi_buffer.data, BLOCKSIZE, 1, SCSIdisk[target].dsk);
+        n = DiskImage_Write(SCSIdisk[target].dsk, SCSIdisk[target].lba, scsi_buffer.data) ? 1 : 0;
+        nPerfScsiBytes += n * BLOCKSIZE;
 #else
         n=1;
         Log_Printf(LOG_SCSI_LEVEL, "[SCSI] WARNING: File write disabled!");
@@ -669,11 +673,11 @@ void scsi_read_sector(void) {
     Log_Printf(LOG_SCSI_LEVEL, "[SCSI] Reading block at offset %i (%i blocks remaining).",
                SCSIdisk[target].lba,SCSIdisk[target].blockcounter-1);
     
-    /* seek to the position */
-	if ((SCSIdisk[target].dsk==NULL) || (fseek(SCSIdisk[target].dsk, SCSIdisk[target].lba*BLOCKSIZE, SEEK_SET) != 0)) {
+	if (SCSIdisk[target].dsk==NULL) {
         n = 0;
 	} else {
-        n = fread(scsi_buffer.data, BLOCKSIZE, 1, SCSIdisk[target].dsk);
+        n = DiskImage_Read(SCSIdisk[target].dsk, SCSIdisk[target].lba, scsi_buffer.data) ? 1 : 0;
+        nPerfScsiBytes += n * BLOCKSIZE;
         scsi_buffer.limit=scsi_buffer.size=BLOCKSIZE;
     }
     
@@ -7,6 +7,7 @@
 #include "dma.h"
 #include "snd.h"
 #include "queue.h"
+#include "perfstats.h"
 
 #define LOG_SND_LEVEL   LOG_DEBUG
 #define LOG_VOL_LEVEL   LOG_DEBUG
@@ -235,6 +236,7 @@ void sndout_queue_poll(Uint8 *buf, int len) {
         }
     } else {
         Log_Printf(LOG_WARN, "[Audio] Not ready. No data on queue.");
+        nPerfAudioUnderruns++;
         memset(buf, 0, len);
     }
 }
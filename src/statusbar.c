@@ -41,6 +41,7 @@ const char Statusbar_fileid[] = "Hatari statusbar.c : " __DATE__ " " __TIME__;
 #include "screen.h"
 #include "video.h"
 #include "dimension.h"
+#include "perfstats.h"
 
 #define DEBUG 0
 #if DEBUG
@@ -103,6 +104,10 @@ typedef struct msg_item {
 static msg_item_t DefaultMessage;
 static msg_item_t *MessageList = &DefaultMessage;
 static SDL_Rect MessageRect;
+
+/* whether default message shows performance and which update it shows */
+static bool bOldPerformance;
+static Uint32 nOldPerfUpdates;
 #if 0
 /* rect for both frame skip value and fast forward indicator */
 static SDL_Rect FrameSkipsRect;
@@ -427,6 +432,8 @@ void Statusbar_UpdateInfo(void)
 	char *end = DefaultMessage.msg;
 	char memsize[8];
 	
+	bOldPerformance = false;
+
 #if ENABLE_DIMENSION
 	/* Message for NeXTdimension */
 	if (ConfigureParams.Dimension.bEnabled &&
@@ -500,6 +507,37 @@ void Statusbar_UpdateInfo(void)
 	DefaultMessage.shown = false;
 }
 
+/*-----------------------------------------------------------------------*/
+/**
+ * Replace default message with the emulation speed when the performance
+ * statistics have been updated (about once per second)
+ */
+static void Statusbar_UpdatePerformance(void)
+{
+	PERF_RATES rates;
+	SPEED_STATS speed;
+	char ndload[12] = "";
+
+	PerfStats_GetRates(&rates);
+	if (bOldPerformance && rates.nUpdates == nOldPerfUpdates) {
+		return;
+	}
+	bOldPerformance = true;
+	nOldPerfUpdates = rates.nUpdates;
+	Main_GetSpeedStats(&speed);
+
+#if ENABLE_DIMENSION
+	if (ConfigureParams.Dimension.bEnabled) {
+		snprintf(ndload, sizeof(ndload), " ND:%d%%", (int)rates.fI860Load);
+	}
+#endif
+	snprintf(DefaultMessage.msg, sizeof(DefaultMessage.msg),
+	         "68k:%.1fMIPS DSP:%d%%%s Speed:%d%% Host:%d%%emu/%d%%gfx",
+	         rates.fCpuMips, (int)rates.fDspLoad, ndload, (int)speed.fRealTime,
+	         (int)rates.fHostEmu, (int)rates.fHostRender);
+	DefaultMessage.shown = false;
+}
+
 /*-----------------------------------------------------------------------*/
 /**
  * Draw 'msg' centered to the message area
@@ -702,6 +740,11 @@ void Statusbar_Update(SDL_Surface *surf)
 		DEBUGPRINT(("LED[%d] = %s\n", i, Led[i].state?"ON":"OFF"));
 	}
 
+	if (ConfigureParams.Screen.bShowPerformance) {
+		Statusbar_UpdatePerformance();
+	} else if (bOldPerformance) {
+		Statusbar_UpdateInfo();
+	}
 	Statusbar_ShowMessage(surf, currentticks);
 
 	/* Draw dsp LED */
@@ -355,10 +355,12 @@ void SCR2_Read3(void)
 /* Interrupt Status Register */
 
 void IntRegStatRead(void) {
+    M68000_SyncCoprocessors();
     IoMem_WriteLong(IoAccessCurrentAddress & IO_SEG_MASK, intStat);
 }
 
 void IntRegStatWrite(void) {
+    M68000_SyncCoprocessors();
     intStat = IoMem_ReadLong(IoAccessCurrentAddress & IO_SEG_MASK);
 }
 
@@ -410,10 +412,12 @@ int get_interrupt_level(void) {
 /* Interrupt Mask Register */
 
 void IntRegMaskRead(void) {
+    M68000_SyncCoprocessors();
 	IoMem_WriteLong(IoAccessCurrentAddress & IO_SEG_MASK,intMask);
 }
 
 void IntRegMaskWrite(void) {
+    M68000_SyncCoprocessors();
 	intMask = IoMem_ReadLong(IoAccessCurrentAddress & IO_SEG_MASK);
         Log_Printf(LOG_WARN,"Interrupt mask: %08x", intMask);
 }
@@ -489,6 +493,23 @@ Uint32 lasteventc; /* debugging code */
 
 Uint32 eventcounter;
 
+/* Number of main cycle counter units per event counter microsecond */
+int System_Timer_CyclesPerMicro(void) {
+#if USE_FREQ_DIVIDER
+    if (ConfigureParams.System.nCpuLevel == 3) {
+        return 48/nCpuFreqDivider;
+    } else { // System has 68040 CPU
+        return 72/nCpuFreqDivider;
+    }
+#else
+    if (ConfigureParams.System.nCpuLevel == 3) {
+        return (128/ConfigureParams.System.nCpuFreq)*3;
+    } else { // System has 68040 CPU
+        return (64/ConfigureParams.System.nCpuFreq)*9;
+    }
+#endif
+}
+
 #if USE_FREQ_DIVIDER
 void System_Timer_Read(void) { /* tuned for power-on test */
 #if EVENTC_DEBUG
@@ -498,10 +519,10 @@ void System_Timer_Read(void) { /* tuned for power-on test */
         if (NEXTRom[0xFFAB]==0x04) { // HACK for ROM version 0.8.31 power-on test, WARNING: this causes slowdown of emulation
             eventcounter = (nCyclesMainCounter/(240/nCpuFreqDivider))&0xFFFFF;
         } else {
-            eventcounter = (nCyclesMainCounter/(48/nCpuFreqDivider))&0xFFFFF;
+            eventcounter = (nCyclesMainCounter/System_Timer_CyclesPerMicro())&0xFFFFF;
         }
     } else { // System has 68040 CPU
-        eventcounter = (nCyclesMainCounter/(72/nCpuFreqDivider))&0xFFFFF;
+        eventcounter = (nCyclesMainCounter/System_Timer_CyclesPerMicro())&0xFFFFF;
     }
     IoMem_WriteLong(IoAccessCurrentAddress&IO_SEG_MASK, eventcounter);
     
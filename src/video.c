@@ -141,6 +141,7 @@ void Video_InterruptHandler_VBL ( void )
 	CycInt_AcknowledgeInterrupt();
 	Video_DrawScreen();
     Main_EventHandler();
+    Main_WaitOnVbl();
     Video_InterruptHandler();
     CycInt_AddRelativeInterrupt(CYCLES_PER_FRAME, INT_CPU_CYCLE, INTERRUPT_VIDEO_VBL);
 }